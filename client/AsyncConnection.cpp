@@ -0,0 +1,421 @@
+/**
+ * @file AsyncConnection.cpp
+ * @brief Реализация класса AsyncConnection
+ * @details Сопрограммы выполняют неблокирующие вызовы до EAGAIN, затем
+ * приостанавливаются до готовности сокета. Сокет зарегистрирован в epoll
+ * с EPOLLONESHOT: каждое ожидание заново включает подписку, поэтому
+ * событие будит сопрограмму ровно один раз.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+
+#include "AsyncConnection.h"
+#include "Scheduler.h"
+#include "Authenticator.h"
+#include "VectorStore.h"
+#include "WireCursor.h"
+#include "SendTimeRing.h"
+#include "ErrorHandler.h"
+#include "Logger.h"
+#include "Metrics.h"
+#include "Tracer.h"
+#include <sys/socket.h>
+#include <sys/epoll.h>
+#include <sys/uio.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <cstring>
+#include <climits>
+#include <errno.h>
+#include <algorithm>
+
+/**
+ * @brief Максимальное число описателей буферов в одном вызове sendmsg
+ */
+static const size_t MAX_IOV = IOV_MAX;
+
+/**
+ * @brief Проверяет, означает ли код ошибки отсутствие готовности сокета
+ */
+static bool wouldBlock(int error) {
+    return error == EAGAIN || error == EWOULDBLOCK;
+}
+
+/**
+ * @brief Конструктор класса AsyncConnection
+ * @param [in] owner Планировщик, в котором выполняются сопрограммы соединения
+ */
+AsyncConnection::AsyncConnection(Scheduler& owner)
+    : scheduler(owner), socketFD(-1), readyEvents(0), pipelineWindow(1), resultsReceived(0) {}
+
+/**
+ * @brief Деструктор класса AsyncConnection
+ */
+AsyncConnection::~AsyncConnection() {
+    closeConnection();
+}
+
+/**
+ * @brief Подписывает сокет на события и запоминает ожидающую сопрограмму
+ * @param [in] handle Приостановленная сопрограмма
+ * @details Если подписка не удалась, сопрограмма сразу ставится в очередь
+ * с EPOLLERR, и следующий системный вызов вернет ошибку.
+ */
+void AsyncConnection::ReadyAwaiter::await_suspend(std::coroutine_handle<> handle) {
+    connection.waiter = handle;
+    if (!connection.scheduler.eventLoop().modify(connection.socketFD, events | EPOLLONESHOT, &connection)) {
+        connection.waiter = nullptr;
+        connection.readyEvents = EPOLLERR;
+        connection.scheduler.schedule(handle);
+    }
+}
+
+/**
+ * @brief Обрабатывает готовность сокета
+ * @param [in] events Маска событий epoll
+ * @details Сопрограмма не продолжается внутри цикла событий, а ставится
+ * в очередь планировщика.
+ */
+void AsyncConnection::onEvent(uint32_t events) {
+    if (waiter) {
+        readyEvents = events;
+        scheduler.schedule(waiter);
+        waiter = nullptr;
+    }
+}
+
+/**
+ * @brief Подключается к серверу
+ * @param [in] address IP-адрес сервера
+ * @param [in] port Порт сервера
+ * @return true если соединение установлено
+ * @details Как и в ServerConnection, для сокета отключается алгоритм Нейгла
+ * (TCP_NODELAY), чтобы векторы не ждали подтверждения предыдущих.
+ */
+Task<bool> AsyncConnection::connect(const std::string& address, int port) {
+    PhaseTimer timer(Metrics::CONNECT);
+    struct sockaddr_in serverAddr;
+    memset(&serverAddr, 0, sizeof(serverAddr));
+    serverAddr.sin_family = AF_INET;
+    serverAddr.sin_port = htons(port);
+    if (inet_pton(AF_INET, address.c_str(), &serverAddr.sin_addr) <= 0) {
+        ErrorHandler::logError("Неверный адрес сервера: " + address);
+        co_return false;
+    }
+    
+    closeConnection();
+    socketFD = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (socketFD < 0 || !scheduler.eventLoop().add(socketFD, EPOLLONESHOT, this)) {
+        ErrorHandler::logError("Ошибка создания сокета");
+        closeConnection();
+        co_return false;
+    }
+    
+    bool connected = ::connect(socketFD, (struct sockaddr*)&serverAddr, sizeof(serverAddr)) == 0;
+    if (!connected && errno == EINPROGRESS) {
+        co_await ready(EPOLLOUT);
+        int error = 0;
+        socklen_t length = sizeof(error);
+        connected = getsockopt(socketFD, SOL_SOCKET, SO_ERROR, &error, &length) == 0 && error == 0;
+    }
+    
+    if (!connected) {
+        ErrorHandler::logError("Не удалось подключиться к серверу " + address + ":" + std::to_string(port));
+        closeConnection();
+        co_return false;
+    }
+    
+    int enable = 1;
+    if (setsockopt(socketFD, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable)) < 0) {
+        LOG_WARNING("Не удалось отключить алгоритм Нейгла: " << strerror(errno));
+    }
+    co_return true;
+}
+
+/**
+ * @brief Отправляет буфер целиком
+ * @param [in] data Данные
+ * @param [in] size Размер в байтах
+ * @param [in] flags Дополнительные флаги send() (MSG_MORE)
+ * @return true если отправка успешна
+ */
+Task<bool> AsyncConnection::sendAll(const void* data, size_t size, int flags) {
+    const char* dataPtr = static_cast<const char*>(data);
+    size_t totalSent = 0;
+    
+    while (totalSent < size) {
+        ssize_t sent = send(socketFD, dataPtr + totalSent, size - totalSent, MSG_NOSIGNAL | flags);
+        Metrics::add(Metrics::SYSCALLS);
+        if (sent < 0 && wouldBlock(errno)) {
+            co_await ready(EPOLLOUT);
+            continue;
+        }
+        if (sent < 0 && errno == EINTR) {
+            Metrics::add(Metrics::RETRIES);
+            continue;
+        }
+        if (sent <= 0) {
+            co_return false;
+        }
+        Metrics::add(Metrics::BYTES_SENT, static_cast<uint64_t>(sent));
+        totalSent += static_cast<size_t>(sent);
+    }
+    co_return true;
+}
+
+/**
+ * @brief Принимает текстовое сообщение сервера
+ * @param [out] message Сообщение без перевода строки
+ * @return true если сообщение принято
+ * @details Как и ServerConnection::receiveText(), сообщением считается текст
+ * до перевода строки или, если его нет, все пришедшее к моменту, когда
+ * данных больше нет.
+ */
+Task<bool> AsyncConnection::readMessage(std::string& message) {
+    for (;;) {
+        size_t newlinePos = input.find('\n');
+        if (newlinePos != std::string::npos) {
+            message = input.substr(0, newlinePos);
+            input.erase(0, newlinePos + 1);
+            co_return true;
+        }
+        
+        char buffer[1024];
+        ssize_t got = recv(socketFD, buffer, sizeof(buffer), 0);
+        Metrics::add(Metrics::SYSCALLS);
+        if (got < 0 && wouldBlock(errno)) {
+            if (!input.empty()) {
+                message.swap(input);
+                input.clear();
+                co_return true;
+            }
+            co_await ready(EPOLLIN);
+            continue;
+        }
+        if (got < 0 && errno == EINTR) {
+            Metrics::add(Metrics::RETRIES);
+            continue;
+        }
+        if (got <= 0) {
+            co_return false;
+        }
+        Metrics::add(Metrics::BYTES_RECEIVED, static_cast<uint64_t>(got));
+        input.append(buffer, static_cast<size_t>(got));
+    }
+}
+
+/**
+ * @brief Выполняет аутентификацию LOGIN/SALT/HASH
+ * @param [in] login Логин пользователя
+ * @param [in] password Пароль пользователя
+ * @return true если сервер ответил OK
+ */
+Task<bool> AsyncConnection::authenticate(const std::string& login, const std::string& password) {
+    PhaseTimer timer(Metrics::AUTHENTICATE);
+    const std::string loginLine = login + "\n";
+    if (!co_await sendAll(loginLine.data(), loginLine.size())) {
+        ErrorHandler::logError("Ошибка отправки LOGIN");
+        co_return false;
+    }
+    
+    std::string salt;
+    if (!co_await readMessage(salt)) {
+        ErrorHandler::logError("Ошибка получения SALT от сервера");
+        co_return false;
+    }
+    if (salt == "ERR") {
+        ErrorHandler::logError("Сервер отверг идентификацию");
+        co_return false;
+    }
+    if (salt.length() != 16) {
+        ErrorHandler::logError("Неверный формат SALT: " + salt);
+        co_return false;
+    }
+    
+    const std::string hashLine = Authenticator::computeHash(salt, password) + "\n";
+    if (!co_await sendAll(hashLine.data(), hashLine.size())) {
+        ErrorHandler::logError("Ошибка отправки HASH");
+        co_return false;
+    }
+    
+    std::string response;
+    if (!co_await readMessage(response)) {
+        ErrorHandler::logError("Ошибка получения ответа аутентификации");
+        co_return false;
+    }
+    if (response != "OK") {
+        ErrorHandler::logError("Ошибка аутентификации: " + response);
+        co_return false;
+    }
+    co_return true;
+}
+
+/**
+ * @brief Отправляет часть векторов заданием и принимает результаты
+ * @param [in] vectors Хранилище векторов
+ * @param [in] begin Индекс первого вектора
+ * @param [in] end Индекс, следующий за последним вектором
+ * @param [out] results Буфер для end - begin результатов
+ * @return true если получены все результаты
+ * @details За один проход сопрограмма отправляет векторы, помещающиеся
+ * в окно, до заполнения буфера сокета, затем читает все пришедшие результаты.
+ * Если ни то, ни другое не продвинулось, она ждет готовности сокета.
+ * 
+ * Временем отправки вектора для Metrics::recordLatency() считается начало
+ * отправки части окна, в которую он попал, как в ServerConnection.
+ */
+Task<bool> AsyncConnection::process(const VectorStore& vectors, size_t begin, size_t end, double* results) {
+    const size_t total = end - begin;
+    resultsReceived = 0;
+    
+    // Заголовок придерживается ядром и уходит вместе с первыми векторами
+    const uint32_t count = static_cast<uint32_t>(total);
+    if (!co_await sendAll(&count, sizeof(count), total > 0 ? MSG_MORE : 0)) {
+        ErrorHandler::logError("Ошибка отправки количества векторов");
+        co_return false;
+    }
+    
+    char* out = reinterpret_cast<char*>(results);
+    const size_t totalBytes = total * sizeof(double);
+    size_t receivedBytes = 0;
+    WireCursor cursor(vectors, begin);
+    std::vector<struct iovec> iov(MAX_IOV);
+    SendTimeRing sentAt(pipelineWindow);  // Время отправки векторов окна
+    size_t stamped = 0;                   // Векторы с отмеченным временем отправки
+    
+    while (receivedBytes < totalBytes) {
+        bool progressed = false;
+        const size_t limit = begin + std::min(total, receivedBytes / sizeof(double) + pipelineWindow);
+        
+        // Отправка, пока есть место в окне и в буфере сокета
+        bool canSend = true;
+        for (;;) {
+            const size_t iovCount = cursor.fill(iov.data(), iov.size(), limit);
+            if (iovCount == 0) {
+                canSend = false;
+                break;
+            }
+            struct msghdr msg;
+            memset(&msg, 0, sizeof(msg));
+            msg.msg_iov = iov.data();
+            msg.msg_iovlen = iovCount;
+            if (stamped < limit - begin) {
+                sentAt.stamp(stamped, limit - begin);
+                stamped = limit - begin;
+            }
+            const uint64_t start = Metrics::now();
+            ssize_t sent = sendmsg(socketFD, &msg, MSG_NOSIGNAL);
+            Metrics::add(Metrics::SYSCALLS);
+            Metrics::recordSend(Metrics::SEND, start, sent);
+            if (sent < 0 && errno == EINTR) {
+                Metrics::add(Metrics::RETRIES);
+                continue;
+            }
+            if (sent < 0 && wouldBlock(errno)) break;
+            if (sent <= 0) {
+                ErrorHandler::logError("Ошибка отправки вектора " + std::to_string(cursor.position()));
+                resultsReceived = receivedBytes / sizeof(double);
+                co_return false;
+            }
+            const size_t first = cursor.position();
+            cursor.advance(static_cast<size_t>(sent));
+            Tracer::span("send", "net", start, Metrics::now(), first, cursor.position() - first);
+            progressed = true;
+        }
+        
+        // Прием всех пришедших результатов
+        for (;;) {
+            const uint64_t start = Metrics::now();
+            ssize_t got = recv(socketFD, out + receivedBytes, totalBytes - receivedBytes, 0);
+            Metrics::add(Metrics::SYSCALLS);
+            Metrics::recordReceive(Metrics::RECEIVE, start, got);
+            if (got < 0 && errno == EINTR) {
+                Metrics::add(Metrics::RETRIES);
+                continue;
+            }
+            if (got < 0 && wouldBlock(errno)) break;
+            if (got <= 0) {
+                resultsReceived = receivedBytes / sizeof(double);
+                ErrorHandler::logError("Ошибка получения результата для вектора " +
+                                       std::to_string(begin + resultsReceived));
+                co_return false;
+            }
+            const size_t first = receivedBytes / sizeof(double);
+            receivedBytes += static_cast<size_t>(got);
+            Tracer::span("receive", "net", start, Metrics::now(), begin + first,
+                         receivedBytes / sizeof(double) - first);
+            sentAt.record(vectors, begin, first, receivedBytes / sizeof(double));
+            progressed = true;
+            if (receivedBytes == totalBytes) break;
+        }
+        
+        if (!progressed) {
+            co_await ready(EPOLLIN | (canSend ? static_cast<uint32_t>(EPOLLOUT) : 0u));
+        }
+    }
+    
+    resultsReceived = total;
+    co_return true;
+}
+
+/**
+ * @brief Отправляет все векторы заданием и принимает результаты
+ * @param [in] vectors Векторы
+ * @param [out] results Результаты; при ошибке - только полученные
+ * @return true если получены все результаты
+ */
+Task<bool> AsyncConnection::process(const VectorStore& vectors, std::vector<double>& results) {
+    results.assign(vectors.size(), 0.0);
+    const bool ok = co_await process(vectors, 0, vectors.size(), results.data());
+    results.resize(resultsReceived);
+    Metrics::add(Metrics::VECTORS, vectors.size());
+    Metrics::add(Metrics::RESULTS, resultsReceived);
+    co_return ok;
+}
+
+/**
+ * @brief Закрывает соединение
+ */
+void AsyncConnection::closeConnection() {
+    if (socketFD >= 0) {
+        scheduler.eventLoop().remove(socketFD);
+        close(socketFD);
+        socketFD = -1;
+    }
+}
+
+/**
+ * @brief Синхронная обертка над connect()
+ * @param [in] address IP-адрес сервера
+ * @param [in] port Порт сервера
+ * @return true если соединение установлено
+ */
+bool AsyncConnection::connectSync(const std::string& address, int port) {
+    bool connected = false;
+    return scheduler.runUntilComplete(connect(address, port), connected) && connected;
+}
+
+/**
+ * @brief Синхронная обертка над authenticate()
+ * @param [in] login Логин пользователя
+ * @param [in] password Пароль пользователя
+ * @return true если аутентификация успешна
+ */
+bool AsyncConnection::authenticateSync(const std::string& login, const std::string& password) {
+    bool authenticated = false;
+    return scheduler.runUntilComplete(authenticate(login, password), authenticated) && authenticated;
+}
+
+/**
+ * @brief Синхронная обертка над process()
+ * @param [in] vectors Векторы
+ * @param [out] results Результаты
+ * @return true если получены все результаты
+ */
+bool AsyncConnection::processSync(const VectorStore& vectors, std::vector<double>& results) {
+    bool processed = false;
+    return scheduler.runUntilComplete(process(vectors, results), processed) && processed;
+}
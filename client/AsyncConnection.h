@@ -0,0 +1,181 @@
+#ifndef ASYNCCONNECTION_H
+#define ASYNCCONNECTION_H
+
+#include "EventLoop.h"
+#include "Task.h"
+#include <coroutine>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+class Scheduler;
+class VectorStore;
+
+/**
+ * @brief Асинхронное соединение с сервером на сопрограммах
+ * @details Повторяет протокол ServerConnection (подключение, LOGIN/SALT/HASH,
+ * задание с векторами) на неблокирующем сокете. Методы connect(),
+ * authenticate() и process() - сопрограммы: при неготовности сокета они
+ * приостанавливаются, и поток планировщика обслуживает другие соединения.
+ * Для кода без сопрограмм есть синхронные обертки connectSync(),
+ * authenticateSync() и processSync().
+ * @code
+ * Task<void> job(Scheduler& scheduler, const VectorStore& vectors) {
+ *     AsyncConnection conn(scheduler);
+ *     std::vector<double> results;
+ *     if (co_await conn.connect("127.0.0.1", 33333) &&
+ *         co_await conn.authenticate("user", "password") &&
+ *         co_await conn.process(vectors, results)) { ... }
+ * }
+ * @endcode
+ * @warning Объекты класса не копируются и используются потоком планировщика.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+class AsyncConnection : public EventHandler {
+private:
+    Scheduler& scheduler;               ///< Планировщик, продолжающий сопрограммы
+    int socketFD;                       ///< Неблокирующий сокет
+    std::coroutine_handle<> waiter;     ///< Сопрограмма, ожидающая готовности сокета
+    uint32_t readyEvents;               ///< События, с которыми она была разбужена
+    size_t pipelineWindow;              ///< Максимум векторов без ответа
+    size_t resultsReceived;             ///< Результаты, полученные последним заданием
+    std::string input;                  ///< Принятый, еще не разобранный текст
+    
+    /**
+     * @brief Ожидающий объект готовности сокета
+     */
+    struct ReadyAwaiter {
+        AsyncConnection& connection;  ///< Соединение
+        uint32_t events;              ///< Ожидаемые события
+        
+        bool await_ready() const noexcept { return false; }
+        void await_suspend(std::coroutine_handle<> handle);
+        uint32_t await_resume() const noexcept { return connection.readyEvents; }
+    };
+    
+    /**
+     * @brief Приостанавливает сопрограмму до готовности сокета
+     * @param [in] events EPOLLIN и/или EPOLLOUT
+     * @return Ожидающий объект; co_await возвращает наступившие события
+     */
+    ReadyAwaiter ready(uint32_t events) { return ReadyAwaiter{*this, events}; }
+    
+    /**
+     * @brief Отправляет буфер целиком
+     * @param [in] data Данные
+     * @param [in] size Размер в байтах
+     * @param [in] flags Дополнительные флаги send() (MSG_MORE)
+     * @return true если отправка успешна
+     */
+    Task<bool> sendAll(const void* data, size_t size, int flags = 0);
+    
+    /**
+     * @brief Принимает текстовое сообщение сервера
+     * @param [out] message Сообщение без перевода строки
+     * @return true если сообщение принято
+     */
+    Task<bool> readMessage(std::string& message);
+    
+public:
+    /**
+     * @brief Конструктор класса AsyncConnection
+     * @param [in] owner Планировщик, в котором выполняются сопрограммы соединения
+     */
+    explicit AsyncConnection(Scheduler& owner);
+    
+    /**
+     * @brief Деструктор класса AsyncConnection
+     */
+    ~AsyncConnection();
+    
+    AsyncConnection(const AsyncConnection&) = delete;
+    AsyncConnection& operator=(const AsyncConnection&) = delete;
+    
+    /**
+     * @brief Обрабатывает готовность сокета
+     * @param [in] events Маска событий epoll
+     */
+    void onEvent(uint32_t events) override;
+    
+    /**
+     * @brief Задает размер окна конвейерной отправки
+     * @param [in] window Число векторов, которые могут ожидать ответа одновременно
+     */
+    void setPipelineWindow(size_t window) { pipelineWindow = window > 0 ? window : 1; }
+    
+    /**
+     * @brief Подключается к серверу
+     * @param [in] address IP-адрес сервера
+     * @param [in] port Порт сервера
+     * @return true если соединение установлено
+     */
+    Task<bool> connect(const std::string& address, int port);
+    
+    /**
+     * @brief Выполняет аутентификацию LOGIN/SALT/HASH
+     * @param [in] login Логин пользователя
+     * @param [in] password Пароль пользователя
+     * @return true если сервер ответил OK
+     */
+    Task<bool> authenticate(const std::string& login, const std::string& password);
+    
+    /**
+     * @brief Отправляет часть векторов заданием и принимает результаты
+     * @param [in] vectors Хранилище векторов
+     * @param [in] begin Индекс первого вектора
+     * @param [in] end Индекс, следующий за последним вектором
+     * @param [out] results Буфер для end - begin результатов
+     * @return true если получены все результаты
+     * @details Отправка со скользящим окном и прием идут одновременно;
+     * сопрограмма ждет готовности к чтению, а при свободном окне - и к записи.
+     */
+    Task<bool> process(const VectorStore& vectors, size_t begin, size_t end, double* results);
+    
+    /**
+     * @brief Отправляет все векторы заданием и принимает результаты
+     * @param [in] vectors Векторы
+     * @param [out] results Результаты; при ошибке - только полученные
+     * @return true если получены все результаты
+     */
+    Task<bool> process(const VectorStore& vectors, std::vector<double>& results);
+    
+    /**
+     * @brief Возвращает количество результатов, полученных последним заданием
+     * @return Количество результатов, записанных в начало буфера
+     */
+    size_t getResultsReceived() const { return resultsReceived; }
+    
+    /**
+     * @brief Закрывает соединение
+     */
+    void closeConnection();
+    
+    /**
+     * @brief Синхронная обертка над connect()
+     * @param [in] address IP-адрес сервера
+     * @param [in] port Порт сервера
+     * @return true если соединение установлено
+     */
+    bool connectSync(const std::string& address, int port);
+    
+    /**
+     * @brief Синхронная обертка над authenticate()
+     * @param [in] login Логин пользователя
+     * @param [in] password Пароль пользователя
+     * @return true если аутентификация успешна
+     */
+    bool authenticateSync(const std::string& login, const std::string& password);
+    
+    /**
+     * @brief Синхронная обертка над process()
+     * @param [in] vectors Векторы
+     * @param [out] results Результаты
+     * @return true если получены все результаты
+     */
+    bool processSync(const VectorStore& vectors, std::vector<double>& results);
+};
+
+#endif // ASYNCCONNECTION_H
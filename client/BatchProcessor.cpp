@@ -0,0 +1,306 @@
+/**
+ * @file BatchProcessor.cpp
+ * @brief Реализация класса BatchProcessor
+ * @details Содержит чтение манифеста и последовательное выполнение заданий
+ * пакета в одной сессии с сервером.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+
+#include "BatchProcessor.h"
+#include "ServerConnection.h"
+#include "DataProcessor.h"
+#include "StreamProcessor.h"
+#include "VbinFormat.h"
+#include "ErrorHandler.h"
+#include "Logger.h"
+#include "Client.h"
+#include "Scheduler.h"
+#include "AsyncConnection.h"
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <algorithm>
+
+/**
+ * @brief Конструктор класса BatchProcessor
+ * @param [in] serverConnection Соединение, прошедшее аутентификацию
+ * @param [in] stream Обрабатывать задания в потоковом режиме
+ * @param [in] threads Количество потоков разбора входных файлов
+ */
+BatchProcessor::BatchProcessor(ServerConnection& serverConnection, bool stream, size_t threads)
+    : connection(serverConnection), streamMode(stream), parseThreads(threads), resultFormat(ResultWriter::TEXT) {}
+
+/**
+ * @brief Задает формат файлов результатов
+ * @param [in] format Формат
+ */
+void BatchProcessor::setResultFormat(ResultWriter::Format format) {
+    resultFormat = format;
+}
+
+/**
+ * @brief Читает манифест пакета
+ * @param [in] filename Путь к файлу манифеста
+ * @param [out] jobs Задания в порядке следования в манифесте
+ * @return true если манифест прочитан, false в случае ошибки
+ */
+bool BatchProcessor::readManifest(const std::string& filename, std::vector<BatchJob>& jobs) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        ErrorHandler::logError("Не удалось открыть манифест: " + filename);
+        return false;
+    }
+    
+    jobs.clear();
+    std::string line;
+    size_t lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        std::istringstream fields(line);
+        BatchJob job;
+        job.line = lineNumber;
+        if (!(fields >> job.inputFileName) || job.inputFileName[0] == '#') {
+            continue;
+        }
+        
+        std::string extra;
+        if (!(fields >> job.outputFileName) || (fields >> extra)) {
+            ErrorHandler::logError("Манифест " + filename + ", строка " + std::to_string(lineNumber) +
+                                   ": ожидается '<входной_файл> <выходной_файл>'");
+            return false;
+        }
+        jobs.push_back(job);
+    }
+    
+    if (jobs.empty()) {
+        ErrorHandler::logError("Манифест не содержит заданий: " + filename);
+        return false;
+    }
+    
+    return true;
+}
+
+/**
+ * @brief Выполняет одно задание
+ * @param [in] job Задание
+ * @param [out] vectorsCount Количество обработанных векторов
+ * @param [out] connectionLost true если ошибка произошла при обмене с сервером
+ * @return true если задание выполнено успешно, false в случае ошибки
+ */
+bool BatchProcessor::runJob(const BatchJob& job, size_t& vectorsCount, bool& connectionLost) {
+    vectorsCount = 0;
+    connectionLost = false;
+    
+    // Файлы .vbin отображаются в память и не требуют потокового режима
+    if (streamMode && !VbinFormat::isVbinFile(job.inputFileName)) {
+        StreamProcessor stream(connection);
+        stream.setResultFormat(resultFormat);
+        if (!stream.run(job.inputFileName, job.outputFileName)) {
+            // Прерванную передачу нельзя продолжить в этой же сессии
+            connectionLost = stream.hasStartedTransfer();
+            return false;
+        }
+        return true;
+    }
+    
+    DataProcessor dataProcessor;
+    dataProcessor.setParseThreads(parseThreads);
+    dataProcessor.setResultFormat(resultFormat);
+    if (!dataProcessor.readVectorsFromFile(job.inputFileName) || !dataProcessor.validateData()) {
+        return false;
+    }
+    vectorsCount = dataProcessor.getVectorsCount();
+    
+    std::vector<double> results;
+    if (!connection.sendVectors(dataProcessor.getVectors(), results) || results.size() != vectorsCount) {
+        connectionLost = true;
+        return false;
+    }
+    
+    return dataProcessor.saveResults(job.outputFileName, results);
+}
+
+/**
+ * @brief Формирует описание задания для журнала
+ * @param [in] jobs Задания пакета
+ * @param [in] index Номер задания
+ * @return Строка "Задание i/N (строка L): вход -> выход"
+ */
+static std::string describeJob(const std::vector<BatchJob>& jobs, size_t index) {
+    std::ostringstream prefix;
+    prefix << "Задание " << (index + 1) << "/" << jobs.size() << " (строка " << jobs[index].line << "): "
+           << jobs[index].inputFileName << " -> " << jobs[index].outputFileName;
+    return prefix.str();
+}
+
+/**
+ * @brief Выводит итог выполнения задания
+ * @param [in] jobs Задания пакета
+ * @param [in] index Номер задания
+ * @param [in] ok Задание выполнено успешно
+ * @param [in] vectorsCount Количество векторов (0 - неизвестно)
+ * @param [in] elapsed Время выполнения в миллисекундах
+ */
+static void reportJob(const std::vector<BatchJob>& jobs, size_t index, bool ok, size_t vectorsCount, double elapsed) {
+    std::string status = ok ? "OK" : "ОШИБКА";
+    if (ok && vectorsCount > 0) {
+        status += ", векторов " + std::to_string(vectorsCount);
+    }
+    LOG_INFO(describeJob(jobs, index) << ": " << status << ", " << elapsed << " мс");
+}
+
+/**
+ * @brief Выводит итог пакета
+ * @param [in] succeeded Успешные задания
+ * @param [in] failed Задания с ошибками
+ * @param [in] skipped Пропущенные задания
+ * @param [in] elapsed Время выполнения пакета в миллисекундах
+ */
+static void reportBatch(size_t succeeded, size_t failed, size_t skipped, double elapsed) {
+    LOG_INFO("Пакет завершен: успешно " << succeeded << ", с ошибками " << failed
+             << ", пропущено " << skipped << ", всего " << elapsed << " мс");
+}
+
+/**
+ * @brief Выполняет все задания пакета
+ * @param [in] jobs Задания
+ * @return true если все задания выполнены успешно, false если хотя бы одно завершилось ошибкой
+ */
+bool BatchProcessor::run(const std::vector<BatchJob>& jobs) {
+    typedef std::chrono::steady_clock Clock;
+    const Clock::time_point batchStart = Clock::now();
+    size_t succeeded = 0;
+    size_t failed = 0;
+    size_t skipped = 0;
+    bool connectionLost = false;
+    
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        if (connectionLost) {
+            LOG_INFO(describeJob(jobs, i) << ": ПРОПУЩЕНО (соединение потеряно)");
+            ++skipped;
+            continue;
+        }
+        
+        const Clock::time_point jobStart = Clock::now();
+        size_t vectorsCount = 0;
+        const bool ok = runJob(jobs[i], vectorsCount, connectionLost);
+        reportJob(jobs, i, ok, vectorsCount, std::chrono::duration<double, std::milli>(Clock::now() - jobStart).count());
+        if (ok) {
+            ++succeeded;
+        } else {
+            ++failed;
+        }
+    }
+    
+    reportBatch(succeeded, failed, skipped, std::chrono::duration<double, std::milli>(Clock::now() - batchStart).count());
+    return failed == 0 && skipped == 0;
+}
+
+namespace {
+
+/**
+ * @brief Общее состояние параллельного выполнения пакета
+ */
+struct ConcurrentBatch {
+    const std::vector<BatchJob>& jobs;  ///< Задания пакета
+    const ClientConfig& config;         ///< Параметры подключения
+    size_t nextJob;                     ///< Следующее невыданное задание
+    size_t succeeded;                   ///< Успешные задания
+    size_t failed;                      ///< Задания с ошибками
+};
+
+/**
+ * @brief Сопрограмма одного соединения пакета
+ * @param [in] scheduler Планировщик
+ * @param [in,out] batch Общее состояние пакета
+ * @param [in] workerId Номер соединения для сообщений
+ * @details Подключается, проходит аутентификацию и берет задания из общей
+ * очереди, пока они есть. Чтение и сохранение файлов выполняются в потоке
+ * планировщика между ожиданиями сокетов. После ошибки обмена соединение
+ * выходит из работы, оставшиеся задания берут другие соединения.
+ */
+Task<void> batchWorker(Scheduler& scheduler, ConcurrentBatch& batch, size_t workerId) {
+    typedef std::chrono::steady_clock Clock;
+    const ClientConfig& config = batch.config;
+    
+    AsyncConnection connection(scheduler);
+    connection.setPipelineWindow(config.pipelineWindow);
+    if (!co_await connection.connect(config.serverAddress, config.serverPort)) {
+        ErrorHandler::logError("Соединение " + std::to_string(workerId) + ": ошибка подключения");
+        co_return;
+    }
+    if (!co_await connection.authenticate(config.login, config.password)) {
+        ErrorHandler::logError("Соединение " + std::to_string(workerId) + ": ошибка аутентификации");
+        co_return;
+    }
+    
+    while (batch.nextJob < batch.jobs.size()) {
+        const size_t index = batch.nextJob++;
+        const BatchJob& job = batch.jobs[index];
+        const Clock::time_point jobStart = Clock::now();
+        
+        DataProcessor dataProcessor;
+        dataProcessor.setParseThreads(config.parseThreads);
+        dataProcessor.setResultFormat(config.resultFormat);
+        bool ok = dataProcessor.readVectorsFromFile(job.inputFileName) && dataProcessor.validateData();
+        bool connectionLost = false;
+        if (ok) {
+            std::vector<double> results;
+            ok = co_await connection.process(dataProcessor.getVectors(), results);
+            connectionLost = !ok;
+            ok = ok && dataProcessor.saveResults(job.outputFileName, results);
+        }
+        
+        reportJob(batch.jobs, index, ok, ok ? dataProcessor.getVectorsCount() : 0,
+                  std::chrono::duration<double, std::milli>(Clock::now() - jobStart).count());
+        if (ok) {
+            ++batch.succeeded;
+        } else {
+            ++batch.failed;
+        }
+        if (connectionLost) {
+            ErrorHandler::logError("Соединение " + std::to_string(workerId) + ": соединение потеряно");
+            co_return;
+        }
+    }
+    connection.closeConnection();
+}
+
+}
+
+/**
+ * @brief Выполняет задания пакета одновременно в нескольких соединениях
+ * @param [in] jobs Задания
+ * @param [in] config Параметры подключения; количество соединений - config.connections
+ * @return true если все задания выполнены успешно, false в случае ошибки
+ * @details Соединения AsyncConnection работают как сопрограммы в одном потоке
+ * планировщика Scheduler: пока одно ждет ответа сервера, другие отправляют
+ * свои задания. Задания, которые не взяло ни одно соединение, считаются
+ * пропущенными.
+ */
+bool BatchProcessor::runConcurrent(const std::vector<BatchJob>& jobs, const ClientConfig& config) {
+    typedef std::chrono::steady_clock Clock;
+    const Clock::time_point batchStart = Clock::now();
+    
+    ConcurrentBatch batch = {jobs, config, 0, 0, 0};
+    Scheduler scheduler;
+    if (!scheduler.eventLoop().isValid()) {
+        return false;
+    }
+    
+    const size_t workers = std::min(config.connections, jobs.size());
+    for (size_t k = 0; k < workers; ++k) {
+        scheduler.spawn(batchWorker(scheduler, batch, k + 1));
+    }
+    const bool completed = scheduler.run();
+    
+    for (size_t i = batch.nextJob; i < jobs.size(); ++i) {
+        LOG_INFO(describeJob(jobs, i) << ": ПРОПУЩЕНО (нет соединений)");
+    }
+    const size_t skipped = jobs.size() - batch.nextJob;
+    reportBatch(batch.succeeded, batch.failed, skipped,
+                std::chrono::duration<double, std::milli>(Clock::now() - batchStart).count());
+    return completed && batch.failed == 0 && skipped == 0;
+}
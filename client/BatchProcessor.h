@@ -0,0 +1,92 @@
+#ifndef BATCHPROCESSOR_H
+#define BATCHPROCESSOR_H
+
+#include "ResultWriter.h"
+#include <string>
+#include <vector>
+
+class ServerConnection;
+struct ClientConfig;
+
+/**
+ * @brief Задание пакетного режима
+ */
+struct BatchJob {
+    std::string inputFileName;   ///< Входной файл с векторами
+    std::string outputFileName;  ///< Выходной файл для результатов
+    size_t line;                 ///< Номер строки манифеста
+};
+
+/**
+ * @brief Класс для пакетной обработки файлов через одно соединение
+ * @details Читает манифест из пар "входной_файл выходной_файл" и выполняет
+ * каждое задание в уже аутентифицированной сессии ServerConnection:
+ * подключение и обмен LOGIN/SALT/HASH выполняются один раз на весь пакет.
+ * Для каждого задания выводятся статус и время выполнения.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+class BatchProcessor {
+private:
+    ServerConnection& connection;  ///< Аутентифицированное соединение с сервером
+    bool streamMode;               ///< Обрабатывать задания конвейером StreamProcessor
+    size_t parseThreads;           ///< Количество потоков разбора входных файлов
+    ResultWriter::Format resultFormat;  ///< Формат файлов результатов
+    
+    /**
+     * @brief Выполняет одно задание
+     * @param [in] job Задание
+     * @param [out] vectorsCount Количество обработанных векторов
+     * @param [out] connectionLost true если ошибка произошла при обмене с сервером
+     * @return true если задание выполнено успешно, false в случае ошибки
+     */
+    bool runJob(const BatchJob& job, size_t& vectorsCount, bool& connectionLost);
+    
+public:
+    /**
+     * @brief Конструктор класса BatchProcessor
+     * @param [in] serverConnection Соединение, прошедшее аутентификацию
+     * @param [in] stream Обрабатывать задания в потоковом режиме
+     * @param [in] threads Количество потоков разбора входных файлов
+     */
+    BatchProcessor(ServerConnection& serverConnection, bool stream, size_t threads);
+    
+    /**
+     * @brief Задает формат файлов результатов
+     * @param [in] format Формат (по умолчанию ResultWriter::TEXT)
+     */
+    void setResultFormat(ResultWriter::Format format);
+    
+    /**
+     * @brief Читает манифест пакета
+     * @param [in] filename Путь к файлу манифеста
+     * @param [out] jobs Задания в порядке следования в манифесте
+     * @return true если манифест прочитан, false в случае ошибки
+     * @details Каждая непустая строка содержит два пути через пробел:
+     * входной и выходной файл. Строки, начинающиеся с '#', пропускаются.
+     */
+    static bool readManifest(const std::string& filename, std::vector<BatchJob>& jobs);
+    
+    /**
+     * @brief Выполняет все задания пакета
+     * @param [in] jobs Задания
+     * @return true если все задания выполнены успешно, false если хотя бы одно завершилось ошибкой
+     * @details Ошибка чтения или сохранения файла не прерывает пакет.
+     * После ошибки обмена с сервером состояние сессии не определено,
+     * поэтому оставшиеся задания помечаются как пропущенные.
+     */
+    bool run(const std::vector<BatchJob>& jobs);
+    
+    /**
+     * @brief Выполняет задания пакета одновременно в нескольких соединениях
+     * @param [in] jobs Задания
+     * @param [in] config Параметры подключения; количество соединений - config.connections
+     * @return true если все задания выполнены успешно, false в случае ошибки
+     * @details Каждое соединение - сопрограмма AsyncConnection; все соединения
+     * обслуживаются одним потоком. Потоковый режим здесь не используется.
+     */
+    static bool runConcurrent(const std::vector<BatchJob>& jobs, const ClientConfig& config);
+};
+
+#endif // BATCHPROCESSOR_H
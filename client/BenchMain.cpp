@@ -0,0 +1,275 @@
+/**
+ * @file BenchMain.cpp
+ * @brief Замер сквозной производительности клиента
+ * @details Запускает ReferenceServer в том же процессе на свободном порту
+ * loopback и для каждого сочетания количества и размера векторов выполняет
+ * путь клиента настоящими классами: чтение файла (DataProcessor), подключение
+ * и аутентификация (ServerConnection), обмен векторами и сохранение
+ * результатов. Для каждого этапа выводится время, для обмена - векторов/с
+ * и МБ/с. Результаты сверяются с суммами, вычисленными заранее.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+
+#include "ReferenceServer.h"
+#include "DataProcessor.h"
+#include "ServerConnection.h"
+#include "ErrorHandler.h"
+#include "Logger.h"
+#include <iostream>
+#include <sstream>
+#include <chrono>
+#include <random>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <unistd.h>
+
+/**
+ * @brief Параметры замера
+ */
+struct BenchConfig {
+    std::vector<size_t> counts;  ///< Количества векторов
+    std::vector<size_t> dims;    ///< Размеры векторов
+    size_t window;               ///< Окно конвейера
+    std::string io;              ///< Механизм ввода-вывода
+    int runs;                    ///< Повторов каждого сочетания (берется лучший)
+};
+
+/**
+ * @brief Время этапов одного прогона в миллисекундах
+ */
+struct BenchTimes {
+    double read;      ///< Чтение и проверка файла
+    double connect;   ///< Подключение и аутентификация
+    double transfer;  ///< Отправка векторов и прием результатов
+    double save;      ///< Сохранение результатов
+    double total;     ///< Весь прогон
+};
+
+/**
+ * @brief Разбирает список чисел через запятую
+ * @param [in] text Список
+ * @param [out] values Числа
+ * @return true если все числа положительные
+ */
+static bool parseList(const std::string& text, std::vector<size_t>& values) {
+    values.clear();
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        long long value = std::atoll(item.c_str());
+        if (value <= 0) {
+            return false;
+        }
+        values.push_back(static_cast<size_t>(value));
+    }
+    return !values.empty();
+}
+
+/**
+ * @brief Создает входной файл и ожидаемые результаты
+ * @param [in] filename Имя файла
+ * @param [in] count Количество векторов
+ * @param [in] dim Размер векторов
+ * @param [out] expected Суммы векторов
+ * @return true если файл записан
+ */
+static bool generateInput(const std::string& filename, size_t count, size_t dim, std::vector<double>& expected) {
+    FILE* file = fopen(filename.c_str(), "w");
+    if (file == nullptr) {
+        ErrorHandler::logError("Не удалось создать файл " + filename);
+        return false;
+    }
+    
+    std::mt19937_64 generator(count * 131 + dim);
+    std::uniform_real_distribution<double> distribution(-1000.0, 1000.0);
+    std::vector<double> values(dim);
+    expected.assign(count, 0.0);
+    
+    fprintf(file, "%zu\n", count);
+    for (size_t i = 0; i < count; ++i) {
+        fprintf(file, "%zu\n", dim);
+        for (size_t j = 0; j < dim; ++j) {
+            values[j] = distribution(generator);
+            fprintf(file, j == 0 ? "%.17g" : " %.17g", values[j]);
+        }
+        fputc('\n', file);
+        expected[i] = ReferenceServer::processVector(values.data(), static_cast<uint32_t>(dim));
+    }
+    
+    return fclose(file) == 0;
+}
+
+/**
+ * @brief Возвращает миллисекунды между двумя моментами
+ */
+static double elapsedMs(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration<double, std::milli>(to - from).count();
+}
+
+/**
+ * @brief Выполняет один прогон клиента
+ * @param [in] config Параметры замера
+ * @param [in] port Порт сервера
+ * @param [in] input Входной файл
+ * @param [in] output Выходной файл
+ * @param [in] expected Ожидаемые результаты
+ * @param [out] times Время этапов
+ * @param [out] wireBytes Объем переданных векторов в байтах
+ * @return true если прогон успешен и результаты совпали
+ */
+static bool runOnce(const BenchConfig& config, int port, const std::string& input, const std::string& output,
+                    const std::vector<double>& expected, BenchTimes& times, size_t& wireBytes) {
+    typedef std::chrono::steady_clock Clock;
+    
+    const Clock::time_point start = Clock::now();
+    DataProcessor dataProcessor;
+    if (!dataProcessor.readVectorsFromFile(input) || !dataProcessor.validateData()) {
+        return false;
+    }
+    const Clock::time_point loaded = Clock::now();
+    
+    ServerConnection connection;
+    connection.setPipelineWindow(config.window);
+    connection.setIoBackend(config.io);
+    if (!connection.establishConnection("127.0.0.1", port) || !connection.authenticate("bench", "bench")) {
+        return false;
+    }
+    const Clock::time_point authenticated = Clock::now();
+    
+    std::vector<double> results;
+    if (!connection.sendVectors(dataProcessor.getVectors(), results)) {
+        return false;
+    }
+    const Clock::time_point transferred = Clock::now();
+    
+    if (!dataProcessor.saveResults(output, results)) {
+        return false;
+    }
+    connection.closeConnection();
+    const Clock::time_point saved = Clock::now();
+    
+    times.read = elapsedMs(start, loaded);
+    times.connect = elapsedMs(loaded, authenticated);
+    times.transfer = elapsedMs(authenticated, transferred);
+    times.save = elapsedMs(transferred, saved);
+    times.total = elapsedMs(start, saved);
+    wireBytes = sizeof(uint32_t) + dataProcessor.getVectors().wireBytes(0, dataProcessor.getVectorsCount()) +
+                results.size() * sizeof(double);
+    
+    for (size_t i = 0; i < expected.size(); ++i) {
+        if (results[i] != expected[i]) {
+            ErrorHandler::logError("Неверный результат вектора " + std::to_string(i));
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Точка входа программы замера
+ * @param [in] argc Количество аргументов командной строки
+ * @param [in] argv Массив аргументов командной строки
+ * @return EXIT_SUCCESS если все прогоны успешны, иначе EXIT_FAILURE
+ * @details Параметры:
+ *   -n <список> - количества векторов через запятую (по умолчанию: 1000,100000)
+ *   -d <список> - размеры векторов через запятую (по умолчанию: 4,64)
+ *   -w <окно> - окно конвейера (по умолчанию: 1024)
+ *   --io <механизм> - auto, uring или blocking (по умолчанию: auto)
+ *   -r <повторы> - повторов каждого сочетания, выводится лучший (по умолчанию: 3)
+ */
+int main(int argc, char* argv[]) {
+    BenchConfig config;
+    parseList("1000,100000", config.counts);
+    parseList("4,64", config.dims);
+    config.window = 1024;
+    config.io = "auto";
+    config.runs = 3;
+    
+    for (int i = 1; i < argc; i++) {
+        bool ok = true;
+        if (strcmp(argv[i], "-n") == 0 && i + 1 < argc) {
+            ok = parseList(argv[++i], config.counts);
+        } else if (strcmp(argv[i], "-d") == 0 && i + 1 < argc) {
+            ok = parseList(argv[++i], config.dims);
+        } else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            config.window = static_cast<size_t>(std::atoll(argv[++i]));
+            ok = config.window > 0;
+        } else if (strcmp(argv[i], "--io") == 0 && i + 1 < argc) {
+            config.io = argv[++i];
+        } else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc) {
+            config.runs = std::atoi(argv[++i]);
+            ok = config.runs > 0;
+        } else {
+            ok = false;
+        }
+        if (!ok) {
+            std::cout << "Использование: ./client_bench [-n <количества>] [-d <размеры>] [-w <окно>]"
+                         " [--io <механизм>] [-r <повторы>]\n";
+            return EXIT_FAILURE;
+        }
+    }
+    
+    // Журнал клиента не смешивается с таблицей: выводятся только ошибки
+    Logger::setLevel(LOG_LEVEL_ERROR);
+    
+    ReferenceServer server("bench", "bench");
+    if (!server.start(0)) {
+        return EXIT_FAILURE;
+    }
+    
+    const std::string prefix = "/tmp/client_bench_" + std::to_string(getpid());
+    const std::string input = prefix + "_in.txt";
+    const std::string output = prefix + "_out.txt";
+    bool allOk = true;
+    
+    printf("%10s %6s %10s %10s %10s %10s %10s %12s %10s\n", "векторов", "размер", "чтение,мс", "вход,мс",
+           "обмен,мс", "запись,мс", "всего,мс", "векторов/с", "МБ/с");
+    
+    for (size_t count : config.counts) {
+        for (size_t dim : config.dims) {
+            std::vector<double> expected;
+            if (!generateInput(input, count, dim, expected)) {
+                allOk = false;
+                continue;
+            }
+            
+            BenchTimes best;
+            best.total = -1.0;
+            size_t wireBytes = 0;
+            for (int run = 0; run < config.runs; ++run) {
+                BenchTimes times;
+                const bool ok = runOnce(config, server.getPort(), input, output, expected, times, wireBytes);
+                
+                if (!ok) {
+                    allOk = false;
+                    best.total = -1.0;
+                    break;
+                }
+                if (best.total < 0 || times.transfer < best.transfer) {
+                    best = times;
+                }
+            }
+            
+            if (best.total < 0) {
+                printf("%10zu %6zu %s\n", count, dim, "ОШИБКА");
+                continue;
+            }
+            const double seconds = best.transfer / 1000.0;
+            printf("%10zu %6zu %10.2f %10.2f %10.2f %10.2f %10.2f %12.0f %10.1f\n", count, dim, best.read,
+                   best.connect, best.transfer, best.save, best.total, count / seconds,
+                   wireBytes / seconds / 1e6);
+            fflush(stdout);
+        }
+    }
+    
+    unlink(input.c_str());
+    unlink(output.c_str());
+    server.stop();
+    return allOk ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,72 @@
+/**
+ * @file BlockingIoBackend.cpp
+ * @brief Реализация класса BlockingIoBackend
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+
+#include "BlockingIoBackend.h"
+#include "Metrics.h"
+#include <errno.h>
+
+/**
+ * @brief Ставит в очередь отправку sendmsg
+ * @param [in] fd Дескриптор сокета
+ * @param [in] msg Описание отправляемых буферов
+ * @param [in] flags Флаги sendmsg
+ * @param [in] tag Метка операции
+ * @return true
+ * @details К флагам добавляется MSG_NOSIGNAL.
+ */
+bool BlockingIoBackend::queueSendmsg(int fd, const struct msghdr* msg, int flags, uint64_t tag) {
+    Operation op = {true, fd, msg, nullptr, 0, flags | MSG_NOSIGNAL, tag};
+    pending.push_back(op);
+    return true;
+}
+
+/**
+ * @brief Ставит в очередь прием recv
+ * @param [in] fd Дескриптор сокета
+ * @param [out] buffer Буфер приема
+ * @param [in] size Размер буфера
+ * @param [in] flags Флаги recv
+ * @param [in] tag Метка операции
+ * @return true
+ */
+bool BlockingIoBackend::queueRecv(int fd, void* buffer, size_t size, int flags, uint64_t tag) {
+    Operation op = {false, fd, nullptr, buffer, size, flags, tag};
+    pending.push_back(op);
+    return true;
+}
+
+/**
+ * @brief Выполняет операции очереди по порядку
+ * @param [out] completions Массив для завершенных операций
+ * @param [in] max Размер массива
+ * @return Количество выполненных операций (0, если очередь пуста)
+ * @details Выполняется не больше max операций, остальные остаются в очереди.
+ * Прерванные сигналом вызовы повторяются.
+ */
+int BlockingIoBackend::wait(IoCompletion* completions, size_t max) {
+    size_t done = 0;
+    while (done < pending.size() && done < max) {
+        const Operation& op = pending[done];
+        ssize_t result;
+        for (;;) {
+            result = op.isSend ? sendmsg(op.fd, op.msg, op.flags)
+                               : recv(op.fd, op.buffer, op.size, op.flags);
+            Metrics::add(Metrics::SYSCALLS);
+            if (result >= 0 || errno != EINTR) {
+                break;
+            }
+            Metrics::add(Metrics::RETRIES);
+        }
+        
+        completions[done].tag = op.tag;
+        completions[done].result = result < 0 ? -errno : result;
+        ++done;
+    }
+    pending.erase(pending.begin(), pending.begin() + done);
+    return static_cast<int>(done);
+}
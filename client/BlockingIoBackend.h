@@ -0,0 +1,41 @@
+#ifndef BLOCKINGIOBACKEND_H
+#define BLOCKINGIOBACKEND_H
+
+#include "IoBackend.h"
+#include <sys/socket.h>
+#include <vector>
+
+/**
+ * @brief Блокирующий механизм ввода-вывода
+ * @details Выполняет поставленные в очередь операции по порядку обычными
+ * вызовами sendmsg и recv. Используется, когда io_uring недоступен.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+class BlockingIoBackend : public IoBackend {
+private:
+    /**
+     * @brief Операция в очереди
+     */
+    struct Operation {
+        bool isSend;            ///< true - sendmsg, false - recv
+        int fd;                 ///< Дескриптор сокета
+        const struct msghdr* msg; ///< Описание буферов отправки
+        void* buffer;           ///< Буфер приема
+        size_t size;            ///< Размер буфера приема
+        int flags;              ///< Флаги sendmsg или recv
+        uint64_t tag;           ///< Метка операции
+    };
+    
+    std::vector<Operation> pending;  ///< Операции, ожидающие выполнения
+    
+public:
+    const char* name() const override { return "blocking"; }
+    bool isAsync() const override { return false; }
+    bool queueSendmsg(int fd, const struct msghdr* msg, int flags, uint64_t tag) override;
+    bool queueRecv(int fd, void* buffer, size_t size, int flags, uint64_t tag) override;
+    int wait(IoCompletion* completions, size_t max) override;
+};
+
+#endif // BLOCKINGIOBACKEND_H
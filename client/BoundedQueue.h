@@ -0,0 +1,81 @@
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <cstddef>
+
+/**
+ * @brief Потокобезопасная очередь ограниченной емкости
+ * @details Связывает стадии конвейера: push() блокируется, пока очередь
+ * заполнена, pop() - пока она пуста. После close() ожидающие вызовы
+ * просыпаются: push() отказывает, pop() возвращает оставшиеся элементы,
+ * а затем сообщает о конце данных.
+ * @tparam T Тип элементов очереди
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+template <typename T>
+class BoundedQueue {
+private:
+    std::deque<T> items;              ///< Элементы очереди
+    size_t capacity;                  ///< Максимальное число элементов
+    bool closed;                      ///< Признак закрытия очереди
+    std::mutex mutex;                 ///< Защита состояния очереди
+    std::condition_variable notFull;  ///< Появилось свободное место
+    std::condition_variable notEmpty; ///< Появился элемент
+    
+public:
+    /**
+     * @brief Конструктор класса BoundedQueue
+     * @param [in] maxItems Емкость очереди (не меньше 1)
+     */
+    explicit BoundedQueue(size_t maxItems) : capacity(maxItems > 0 ? maxItems : 1), closed(false) {}
+    
+    /**
+     * @brief Добавляет элемент, ожидая свободного места
+     * @param [in] item Элемент (перемещается в очередь)
+     * @return true если элемент добавлен, false если очередь закрыта
+     */
+    bool push(T&& item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notFull.wait(lock, [this]() { return closed || items.size() < capacity; });
+        if (closed) {
+            return false;
+        }
+        items.push_back(std::move(item));
+        notEmpty.notify_one();
+        return true;
+    }
+    
+    /**
+     * @brief Извлекает элемент, ожидая его появления
+     * @param [out] item Извлеченный элемент
+     * @return true если элемент извлечен, false если очередь закрыта и пуста
+     */
+    bool pop(T& item) {
+        std::unique_lock<std::mutex> lock(mutex);
+        notEmpty.wait(lock, [this]() { return closed || !items.empty(); });
+        if (items.empty()) {
+            return false;
+        }
+        item = std::move(items.front());
+        items.pop_front();
+        notFull.notify_one();
+        return true;
+    }
+    
+    /**
+     * @brief Закрывает очередь и будит все ожидающие потоки
+     */
+    void close() {
+        std::lock_guard<std::mutex> lock(mutex);
+        closed = true;
+        notFull.notify_all();
+        notEmpty.notify_all();
+    }
+};
+
+#endif // BOUNDEDQUEUE_H
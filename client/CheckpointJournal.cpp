@@ -0,0 +1,298 @@
+/**
+ * @file CheckpointJournal.cpp
+ * @brief Реализация класса CheckpointJournal
+ * @details Формат файла: JournalHeader, затем записи
+ * [первый вектор: uint64][количество: uint64][результаты: double * количество][контрольная сумма: uint64].
+ * Контрольная сумма записи - FNV-1a по 64-битным словам номера, количества
+ * и результатов.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+
+#include "CheckpointJournal.h"
+#include "ErrorHandler.h"
+#include "Logger.h"
+#include "Metrics.h"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+/**
+ * @brief Сигнатура файла журнала
+ */
+static const char JOURNAL_MAGIC[8] = { 'V', 'J', 'O', 'U', 'R', 'N', 'A', 'L' };
+
+/**
+ * @brief Версия формата журнала
+ */
+static const uint32_t JOURNAL_VERSION = 1;
+
+/**
+ * @brief Вычисляет контрольную сумму записи
+ * @param [in] first Номер первого вектора
+ * @param [in] count Количество векторов
+ * @param [in] results Результаты
+ * @return FNV-1a по 64-битным словам записи
+ */
+static uint64_t recordChecksum(uint64_t first, uint64_t count, const double* results) {
+    const uint64_t prime = 0x100000001b3ull;
+    uint64_t hash = 0xcbf29ce484222325ull;
+    hash = (hash ^ first) * prime;
+    hash = (hash ^ count) * prime;
+    for (uint64_t i = 0; i < count; ++i) {
+        uint64_t bits;
+        memcpy(&bits, &results[i], sizeof(bits));
+        hash = (hash ^ bits) * prime;
+    }
+    return hash;
+}
+
+/**
+ * @brief Читает данные из файла по смещению
+ * @param [in] fd Дескриптор файла
+ * @param [out] data Буфер
+ * @param [in] size Размер данных
+ * @param [in] offset Смещение от начала файла
+ * @return true если прочитано все
+ */
+static bool readAt(int fd, void* data, size_t size, uint64_t offset) {
+    char* bytes = static_cast<char*>(data);
+    while (size > 0) {
+        ssize_t got = pread(fd, bytes, size, static_cast<off_t>(offset));
+        Metrics::add(Metrics::SYSCALLS);
+        if (got < 0 && errno == EINTR) {
+            Metrics::add(Metrics::RETRIES);
+            continue;
+        }
+        if (got <= 0) {
+            return false;
+        }
+        bytes += got;
+        size -= static_cast<size_t>(got);
+        offset += static_cast<uint64_t>(got);
+    }
+    return true;
+}
+
+/**
+ * @brief Записывает данные в конец файла
+ * @param [in] fd Дескриптор файла, открытого с O_APPEND
+ * @param [in] data Данные
+ * @param [in] size Размер данных
+ * @return true если записано все
+ */
+static bool writeAll(int fd, const void* data, size_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t written = write(fd, bytes, size);
+        Metrics::add(Metrics::SYSCALLS);
+        if (written < 0 && errno == EINTR) {
+            Metrics::add(Metrics::RETRIES);
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        bytes += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+/**
+ * @brief Конструктор класса CheckpointJournal
+ */
+CheckpointJournal::CheckpointJournal() : fileFD(-1) {}
+
+/**
+ * @brief Деструктор класса CheckpointJournal
+ */
+CheckpointJournal::~CheckpointJournal() {
+    close();
+}
+
+/**
+ * @brief Возвращает имя журнала для файла результатов
+ * @param [in] outputFileName Имя файла результатов
+ * @return Имя файла журнала
+ */
+std::string CheckpointJournal::pathFor(const std::string& outputFileName) {
+    return outputFileName + ".journal";
+}
+
+/**
+ * @brief Создает новый пустой журнал, заменяя существующий
+ * @param [in] filename Имя файла журнала
+ * @param [in] inputChecksum Контрольная сумма входных векторов
+ * @param [in] vectorCount Количество входных векторов
+ * @return true если журнал создан, false в случае ошибки
+ */
+bool CheckpointJournal::create(const std::string& filename, uint64_t inputChecksum, uint64_t vectorCount) {
+    close();
+    fileName = filename;
+    fileFD = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND | O_CLOEXEC, 0666);
+    if (fileFD < 0) {
+        ErrorHandler::logError("Не удалось создать журнал: " + filename);
+        return false;
+    }
+
+    JournalHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC));
+    header.version = JOURNAL_VERSION;
+    header.inputChecksum = inputChecksum;
+    header.vectorCount = vectorCount;
+    if (!writeAll(fileFD, &header, sizeof(header)) || fdatasync(fileFD) != 0) {
+        ErrorHandler::logError("Ошибка записи в журнал: " + filename);
+        close();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Загружает существующий журнал и открывает его для дописывания
+ * @param [in] filename Имя файла журнала
+ * @param [in] inputChecksum Ожидаемая контрольная сумма входных векторов
+ * @param [in] vectorCount Ожидаемое количество векторов
+ * @param [out] results Буфер результатов
+ * @param [out] completed Диапазоны выполненных векторов
+ * @return true если журнал подходит к входным данным
+ * @details Записи читаются до первой неполной или испорченной; файл
+ * обрезается по последней целой записи, чтобы новые записи шли следом.
+ */
+bool CheckpointJournal::load(const std::string& filename, uint64_t inputChecksum, uint64_t vectorCount,
+                             double* results, std::vector<Range>& completed) {
+    close();
+    completed.clear();
+    fileName = filename;
+    fileFD = open(filename.c_str(), O_RDWR | O_APPEND | O_CLOEXEC);
+    if (fileFD < 0) {
+        LOG_WARNING("Журнал " << filename << " не найден, обработка начинается сначала");
+        return false;
+    }
+
+    JournalHeader header;
+    if (!readAt(fileFD, &header, sizeof(header), 0) ||
+        memcmp(header.magic, JOURNAL_MAGIC, sizeof(JOURNAL_MAGIC)) != 0 || header.version != JOURNAL_VERSION) {
+        LOG_WARNING("Файл " << filename << " не является журналом этой версии, обработка начинается сначала");
+        close();
+        return false;
+    }
+    if (header.inputChecksum != inputChecksum || header.vectorCount != vectorCount) {
+        LOG_WARNING("Журнал " << filename << " относится к другим входным данным, обработка начинается сначала");
+        close();
+        return false;
+    }
+
+    uint64_t offset = sizeof(header);
+    std::vector<double> buffer;
+    for (;;) {
+        uint64_t head[2];  // Первый вектор и количество
+        if (!readAt(fileFD, head, sizeof(head), offset) || head[1] == 0 || head[0] > vectorCount ||
+            head[1] > vectorCount - head[0]) {
+            break;
+        }
+        buffer.resize(static_cast<size_t>(head[1]));
+        uint64_t checksum;
+        const size_t payload = buffer.size() * sizeof(double);
+        if (!readAt(fileFD, buffer.data(), payload, offset + sizeof(head)) ||
+            !readAt(fileFD, &checksum, sizeof(checksum), offset + sizeof(head) + payload) ||
+            checksum != recordChecksum(head[0], head[1], buffer.data())) {
+            break;
+        }
+        memcpy(results + head[0], buffer.data(), payload);
+        Range range = { static_cast<size_t>(head[0]), static_cast<size_t>(head[0] + head[1]) };
+        completed.push_back(range);
+        offset += sizeof(head) + payload + sizeof(checksum);
+    }
+
+    const off_t fileSize = lseek(fileFD, 0, SEEK_END);
+    if (fileSize > static_cast<off_t>(offset)) {
+        LOG_WARNING("Отброшен неполный конец журнала " << filename << ": "
+                    << (fileSize - static_cast<off_t>(offset)) << " байт");
+        if (ftruncate(fileFD, static_cast<off_t>(offset)) != 0) {
+            ErrorHandler::logError("Не удалось обрезать журнал: " + filename);
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Дописывает результаты диапазона векторов и сбрасывает их на диск
+ * @param [in] first Номер первого вектора
+ * @param [in] count Количество векторов
+ * @param [in] results Результаты
+ * @return true если запись сохранена, false в случае ошибки
+ * @details Запись собирается в один буфер и пишется одним вызовом, чтобы
+ * при обрыве на диске оставался только ее неполный конец.
+ */
+bool CheckpointJournal::append(size_t first, size_t count, const double* results) {
+    if (fileFD < 0 || count == 0) {
+        return fileFD >= 0;
+    }
+    const uint64_t head[2] = { first, count };
+    const uint64_t checksum = recordChecksum(first, count, results);
+    const size_t payload = count * sizeof(double);
+
+    std::vector<char> record(sizeof(head) + payload + sizeof(checksum));
+    memcpy(record.data(), head, sizeof(head));
+    memcpy(record.data() + sizeof(head), results, payload);
+    memcpy(record.data() + sizeof(head) + payload, &checksum, sizeof(checksum));
+
+    if (!writeAll(fileFD, record.data(), record.size()) || fdatasync(fileFD) != 0) {
+        ErrorHandler::logError("Ошибка записи в журнал: " + fileName);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Закрывает и удаляет журнал
+ */
+void CheckpointJournal::remove() {
+    if (fileFD >= 0) {
+        close();
+        unlink(fileName.c_str());
+    }
+}
+
+/**
+ * @brief Закрывает журнал
+ */
+void CheckpointJournal::close() {
+    if (fileFD >= 0) {
+        ::close(fileFD);
+        fileFD = -1;
+    }
+}
+
+/**
+ * @brief Вычисляет диапазоны векторов, которых нет в журнале
+ * @param [in] completed Выполненные диапазоны
+ * @param [in] vectorCount Количество векторов
+ * @return Невыполненные диапазоны по возрастанию
+ */
+std::vector<CheckpointJournal::Range> CheckpointJournal::pending(std::vector<Range> completed, size_t vectorCount) {
+    std::sort(completed.begin(), completed.end(),
+              [](const Range& a, const Range& b) { return a.begin < b.begin; });
+    std::vector<Range> result;
+    size_t next = 0;  // Первый вектор, не покрытый предыдущими диапазонами
+    for (const Range& range : completed) {
+        if (range.begin > next) {
+            Range gap = { next, range.begin };
+            result.push_back(gap);
+        }
+        next = std::max(next, range.end);
+    }
+    if (next < vectorCount) {
+        Range gap = { next, vectorCount };
+        result.push_back(gap);
+    }
+    return result;
+}
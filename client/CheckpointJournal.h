@@ -0,0 +1,127 @@
+#ifndef CHECKPOINT_JOURNAL_H
+#define CHECKPOINT_JOURNAL_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Заголовок файла журнала
+ */
+struct JournalHeader {
+    char magic[8];           ///< Сигнатура "VJOURNAL"
+    uint32_t version;        ///< Версия формата
+    uint32_t reserved;       ///< Зарезервировано (0)
+    uint64_t inputChecksum;  ///< Контрольная сумма входных векторов (ResultWriter::updateChecksum)
+    uint64_t vectorCount;    ///< Количество входных векторов
+};
+
+/**
+ * @brief Журнал выполненных векторов для возобновления прерванной работы
+ * @details Файл дописывается записями, каждая из которых содержит номер
+ * первого вектора, количество векторов, их результаты и контрольную сумму
+ * записи. После каждой записи данные сбрасываются на диск fdatasync().
+ * Журнал привязан к входным данным контрольной суммой и количеством
+ * векторов из заголовка: журнал другого входного файла не принимается.
+ *
+ * Результаты хранятся в двоичном виде как есть, поэтому файл результатов
+ * возобновленной работы совпадает побайтно с файлом непрерывной работы.
+ * Недописанная последняя запись (обрыв при записи) отбрасывается при загрузке.
+ * @warning Объекты класса не копируются.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+class CheckpointJournal {
+private:
+    int fileFD;            ///< Дескриптор открытого журнала (-1 - закрыт)
+    std::string fileName;  ///< Имя файла журнала
+
+public:
+    /**
+     * @brief Диапазон векторов [begin, end)
+     */
+    struct Range {
+        size_t begin;  ///< Первый вектор
+        size_t end;    ///< Вектор, следующий за последним
+    };
+
+    /**
+     * @brief Конструктор класса CheckpointJournal
+     */
+    CheckpointJournal();
+
+    /**
+     * @brief Деструктор класса CheckpointJournal
+     * @details Закрывает журнал, не удаляя его
+     */
+    ~CheckpointJournal();
+
+    CheckpointJournal(const CheckpointJournal&) = delete;
+    CheckpointJournal& operator=(const CheckpointJournal&) = delete;
+
+    /**
+     * @brief Возвращает имя журнала для файла результатов
+     * @param [in] outputFileName Имя файла результатов
+     * @return Имя файла журнала (<результаты>.journal)
+     */
+    static std::string pathFor(const std::string& outputFileName);
+
+    /**
+     * @brief Создает новый пустой журнал, заменяя существующий
+     * @param [in] filename Имя файла журнала
+     * @param [in] inputChecksum Контрольная сумма входных векторов
+     * @param [in] vectorCount Количество входных векторов
+     * @return true если журнал создан, false в случае ошибки
+     */
+    bool create(const std::string& filename, uint64_t inputChecksum, uint64_t vectorCount);
+
+    /**
+     * @brief Загружает существующий журнал и открывает его для дописывания
+     * @param [in] filename Имя файла журнала
+     * @param [in] inputChecksum Ожидаемая контрольная сумма входных векторов
+     * @param [in] vectorCount Ожидаемое количество векторов
+     * @param [out] results Буфер на vectorCount результатов: заполняются выполненные векторы
+     * @param [out] completed Диапазоны выполненных векторов в порядке записи
+     * @return true если журнал подходит к входным данным, false если его
+     * нет, он поврежден или относится к другим данным (причина - в журнале работы)
+     */
+    bool load(const std::string& filename, uint64_t inputChecksum, uint64_t vectorCount, double* results,
+              std::vector<Range>& completed);
+
+    /**
+     * @brief Дописывает результаты диапазона векторов и сбрасывает их на диск
+     * @param [in] first Номер первого вектора
+     * @param [in] count Количество векторов
+     * @param [in] results Результаты векторов first..first+count-1
+     * @return true если запись сохранена, false в случае ошибки
+     */
+    bool append(size_t first, size_t count, const double* results);
+
+    /**
+     * @brief Проверяет, открыт ли журнал
+     */
+    bool isOpen() const { return fileFD >= 0; }
+
+    /**
+     * @brief Закрывает и удаляет журнал
+     * @details Вызывается после успешного сохранения результатов.
+     */
+    void remove();
+
+    /**
+     * @brief Закрывает журнал
+     */
+    void close();
+
+    /**
+     * @brief Вычисляет диапазоны векторов, которых нет в журнале
+     * @param [in] completed Выполненные диапазоны (в любом порядке, могут пересекаться)
+     * @param [in] vectorCount Количество векторов
+     * @return Невыполненные диапазоны по возрастанию
+     */
+    static std::vector<Range> pending(std::vector<Range> completed, size_t vectorCount);
+};
+
+#endif // CHECKPOINT_JOURNAL_H
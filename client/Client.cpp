@@ -10,23 +10,66 @@
 
 #include "Client.h"
 #include "ErrorHandler.h"
+#include "Logger.h"
 #include "Authenticator.h"
 #include "DataProcessor.h"
 #include "ServerConnection.h"
-#include <iostream>
+#include "StreamProcessor.h"
+#include "VbinFormat.h"
+#include "ShardedProcessor.h"
+#include "BatchProcessor.h"
+#include "Metrics.h"
+#include "Tracer.h"
+#include "Profiler.h"
+#include "MemoryTracker.h"
+#include "CheckpointJournal.h"
 #include <fstream>
 #include <cstring>
 #include <unistd.h>
 #include <pwd.h>
+#include <random>
+#include <thread>
+#include <chrono>
+
+/**
+ * @brief Наибольшее количество векторов в одной записи журнала
+ */
+static const size_t JOURNAL_CHUNK_VECTORS = 1 << 20;
+
+/**
+ * @brief Наибольший объем векторов в одной записи журнала (64 МБ)
+ */
+static const size_t JOURNAL_CHUNK_BYTES = 64 << 20;
+
+/**
+ * @brief Пауза перед первой попыткой повторного подключения, мс
+ */
+static const unsigned RECONNECT_BASE_DELAY_MS = 100;
+
+/**
+ * @brief Наибольшая пауза между попытками повторного подключения, мс
+ */
+static const unsigned RECONNECT_MAX_DELAY_MS = 10000;
 
 /**
  * @brief Конструктор структуры ClientConfig
  * @details Инициализирует значения по умолчанию:
  * - serverPort: 33333
  * - configFileName: "~/.config/velient.conf"
+ * - pipelineWindow: 1 (без конвейера)
+ * - streamMode: false
+ * - parseThreads: 0 (по числу ядер)
+ * - connections: 1
+ * - ioBackend: "auto"
+ * - resultFormat: ResultWriter::TEXT
+ * - profile, memoryReport, checkpoint, resume: false
+ * - retries: 5
  * - Остальные поля: пустые строки
  */
-ClientConfig::ClientConfig() : serverPort(33333), configFileName("~/.config/velient.conf") {}
+ClientConfig::ClientConfig() : serverPort(33333), configFileName("~/.config/velient.conf"), pipelineWindow(1),
+                               streamMode(false), parseThreads(0), connections(1), ioBackend("auto"),
+                               resultFormat(ResultWriter::TEXT), profile(false),
+                               memoryReport(false), checkpoint(false), resume(false), retries(5) {}
 
 /**
  * @brief Парсит аргументы командной строки
@@ -41,6 +84,18 @@ ClientConfig::ClientConfig() : serverPort(33333), configFileName("~/.config/veli
  * 2. Опциональные:
  *    - -p <порт>: порт сервера (по умолчанию: 33333)
  *    - -c <файл_конфига>: файл с учетными данными (по умолчанию: ~/.config/velient.conf)
+ *    - -w <окно>: окно конвейерной отправки векторов (по умолчанию: 1)
+ *    - --stream: потоковая обработка с ограниченным расходом памяти
+ *    - -t <потоки>: количество потоков разбора входного файла (по умолчанию: по числу ядер)
+ *    - -j <соединения>: количество параллельных соединений с сервером (по умолчанию: 1)
+ *    - --io <механизм>: механизм ввода-вывода auto, uring или blocking (по умолчанию: auto)
+ *    - --metrics=<файл>: файл метрик этапов (JSON, для *.prom - формат Prometheus)
+ *    - --trace=<файл>: временная шкала в формате Chrome trace events (JSON)
+ *    - --profile: профиль этапов по счетчикам процессора
+ *    - --memory: расход памяти по этапам
+ *    - --checkpoint: вести журнал выполненных векторов
+ *    - --resume: продолжить прерванную работу по журналу (включает --checkpoint)
+ *    - --retries <n>: попыток повторного подключения после разрыва (по умолчанию: 5)
  *    - -h: вывод справки
  * @warning Требует минимум 4 аргумента (включая имя программы)
  */
@@ -55,12 +110,88 @@ bool Client::parseCommandLineArgs(int argc, char* argv[]) {
     config.inputFileName = argv[2];
     config.outputFileName = argv[3];
     
-    // Опциональные параметры
-    for (int i = 4; i < argc; i++) {
+    return parseOptions(argc, argv, 4);
+}
+
+/**
+ * @brief Парсит опциональные аргументы командной строки
+ * @param [in] argc Количество аргументов
+ * @param [in] argv Массив аргументов
+ * @param [in] first Индекс первого опционального аргумента
+ * @return true если парсинг успешен, false в случае ошибки
+ * @details Общая часть разбора для основного режима и подкоманды batch.
+ */
+bool Client::parseOptions(int argc, char* argv[], int first) {
+    for (int i = first; i < argc; i++) {
         if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
             config.serverPort = std::stoi(argv[++i]);
         } else if (strcmp(argv[i], "-c") == 0 && i + 1 < argc) {
             config.configFileName = argv[++i];
+        } else if (strcmp(argv[i], "-w") == 0 && i + 1 < argc) {
+            int window = std::stoi(argv[++i]);
+            if (window <= 0) {
+                ErrorHandler::logError("Размер окна должен быть положительным: " + std::string(argv[i]));
+                return false;
+            }
+            config.pipelineWindow = static_cast<size_t>(window);
+        } else if (strcmp(argv[i], "--stream") == 0) {
+            config.streamMode = true;
+        } else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc) {
+            int threads = std::stoi(argv[++i]);
+            if (threads <= 0) {
+                ErrorHandler::logError("Количество потоков должно быть положительным: " + std::string(argv[i]));
+                return false;
+            }
+            config.parseThreads = static_cast<size_t>(threads);
+        } else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) {
+            int connections = std::stoi(argv[++i]);
+            if (connections <= 0) {
+                ErrorHandler::logError("Количество соединений должно быть положительным: " + std::string(argv[i]));
+                return false;
+            }
+            config.connections = static_cast<size_t>(connections);
+        } else if (strcmp(argv[i], "--io") == 0 && i + 1 < argc) {
+            config.ioBackend = argv[++i];
+            if (!IoBackend::isValidKind(config.ioBackend)) {
+                ErrorHandler::logError("Неизвестный механизм ввода-вывода: " + config.ioBackend);
+                return false;
+            }
+        } else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc) {
+            if (!ResultWriter::parseFormat(argv[++i], config.resultFormat)) {
+                ErrorHandler::logError("Неизвестный формат результатов: " + std::string(argv[i]));
+                return false;
+            }
+        } else if (strcmp(argv[i], "-v") == 0) {
+            if (LOG_MIN_LEVEL > LOG_LEVEL_DEBUG) {
+                LOG_WARNING("Отладочные сообщения исключены при сборке (LOG_MIN_LEVEL), -v не действует");
+            }
+            Logger::setLevel(LOG_LEVEL_DEBUG);
+        } else if (strcmp(argv[i], "-q") == 0) {
+            Logger::setLevel(LOG_LEVEL_ERROR);
+        } else if (strncmp(argv[i], "--metrics=", 10) == 0 && argv[i][10] != '\0') {
+            config.metricsFile = argv[i] + 10;
+        } else if (strncmp(argv[i], "--trace=", 8) == 0 && argv[i][8] != '\0') {
+            config.traceFile = argv[i] + 8;
+            Tracer::enable();
+            Tracer::nameThread("main");
+        } else if (strcmp(argv[i], "--profile") == 0) {
+            config.profile = true;
+            Profiler::enable();
+        } else if (strcmp(argv[i], "--memory") == 0) {
+            config.memoryReport = true;
+            MemoryTracker::enable();
+        } else if (strcmp(argv[i], "--checkpoint") == 0) {
+            config.checkpoint = true;
+        } else if (strcmp(argv[i], "--resume") == 0) {
+            config.resume = true;
+            config.checkpoint = true;
+        } else if (strcmp(argv[i], "--retries") == 0 && i + 1 < argc) {
+            int retries = std::stoi(argv[++i]);
+            if (retries < 0) {
+                ErrorHandler::logError("Количество попыток не может быть отрицательным: " + std::string(argv[i]));
+                return false;
+            }
+            config.retries = static_cast<size_t>(retries);
         } else if (strcmp(argv[i], "-h") == 0) {
             ErrorHandler::printHelp();
             return false;
@@ -90,6 +221,8 @@ bool Client::parseCommandLineArgs(int argc, char* argv[]) {
  * а при ее отсутствии - системный вызов getpwuid()
  */
 bool Client::readConfigFile() {
+    PhaseTimer timer(Metrics::CONFIG);
+    
     // Разворачиваем ~ в домашнюю директорию
     if (config.configFileName.find("~/") == 0) {
         const char* homeDir = getenv("HOME");
@@ -152,10 +285,103 @@ bool Client::readConfigFile() {
     config.password = password;
     
     configFile.close();
-    std::cout << "Лог: Прочитан логин: " << config.login << std::endl;
+    LOG_INFO("Прочитан логин: " << config.login);
     return true;
 }
 
+/**
+ * @brief Преобразует файл векторов между текстовым форматом и .vbin
+ * @param [in] argc Количество аргументов
+ * @param [in] argv Массив аргументов: client convert <источник> <приемник> [опции]
+ * @return true если преобразование успешно, false в случае ошибки
+ * @details Источник читается DataProcessor::readVectorsFromFile(), который
+ * сам определяет формат. Текстовый источник записывается в .vbin с индексом,
+ * источник .vbin - в текстовый формат. Опции разбираются так же, как в
+ * основном режиме; для преобразования имеют смысл -t, -v, -q и опции отчетов.
+ */
+bool Client::runConvert(int argc, char* argv[]) {
+    if (argc < 4) {
+        ErrorHandler::printHelp();
+        return false;
+    }
+    if (!parseOptions(argc, argv, 4)) {
+        return false;
+    }
+    
+    const std::string source = argv[2];
+    const std::string target = argv[3];
+    const bool toBinary = !VbinFormat::isVbinFile(source);
+    
+    DataProcessor dataProcessor;
+    dataProcessor.setParseThreads(config.parseThreads);
+    if (!dataProcessor.readVectorsFromFile(source) || !dataProcessor.validateData()) {
+        ErrorHandler::logError("Ошибка чтения векторов из файла " + source);
+        return false;
+    }
+    
+    if (!dataProcessor.saveVectors(target, toBinary)) {
+        return false;
+    }
+    
+    LOG_INFO("Преобразовано " << dataProcessor.getVectorsCount() << " векторов: " << source
+             << " -> " << target << (toBinary ? " (.vbin)" : " (текст)"));
+    return true;
+}
+
+/**
+ * @brief Выполняет подкоманду batch
+ * @param [in] argc Количество аргументов командной строки
+ * @param [in] argv Массив аргументов: batch <адрес_сервера> <манифест> [опции]
+ * @return true если все задания выполнены успешно, false в случае ошибки
+ * @details Конфигурация, подключение и обмен LOGIN/SALT/HASH выполняются
+ * один раз на весь пакет, поэтому их стоимость не повторяется для каждого
+ * файла. Задания выполняются по очереди в одной сессии, а с опцией -j -
+ * одновременно в нескольких асинхронных соединениях одного потока.
+ */
+bool Client::runBatch(int argc, char* argv[]) {
+    if (argc < 4) {
+        ErrorHandler::printHelp();
+        return false;
+    }
+    
+    config.serverAddress = argv[2];
+    const std::string manifest = argv[3];
+    if (!parseOptions(argc, argv, 4) || !readConfigFile()) {
+        return false;
+    }
+    
+    std::vector<BatchJob> jobs;
+    if (!BatchProcessor::readManifest(manifest, jobs)) {
+        return false;
+    }
+    LOG_INFO("Прочитано " << jobs.size() << " заданий из манифеста " << manifest);
+    
+    if (config.connections > 1) {
+        return BatchProcessor::runConcurrent(jobs, config);
+    }
+    
+    ServerConnection connection;
+    if (!connection.establishConnection(config.serverAddress, config.serverPort)) {
+        ErrorHandler::logError("Ошибка установки соединения с сервером");
+        return false;
+    }
+    
+    connection.setPipelineWindow(config.pipelineWindow);
+    connection.setIoBackend(config.ioBackend);
+    
+    if (!connection.authenticate(config.login, config.password)) {
+        ErrorHandler::logError("Ошибка аутентификации");
+        connection.closeConnection();
+        return false;
+    }
+    
+    BatchProcessor batch(connection, config.streamMode, config.parseThreads);
+    batch.setResultFormat(config.resultFormat);
+    const bool ok = batch.run(jobs);
+    connection.closeConnection();
+    return ok;
+}
+
 /**
  * @brief Основной метод запуска клиента
  * @param [in] argc Количество аргументов командной строки
@@ -172,76 +398,329 @@ bool Client::readConfigFile() {
  * 8. Сохранение результатов в выходной файл
  * 9. Закрытие соединения и завершение работы
  * 
+ * Подкоманда convert преобразует файлы векторов без подключения к серверу,
+ * подкоманда batch обрабатывает манифест заданий в одной сессии.
+ * 
+ * В потоковом режиме (--stream) шаги 3 и 6-8 выполняются одновременно
+ * конвейером StreamProcessor, без загрузки всего файла в память.
+ * При нескольких соединениях (-j) шаги 4-7 выполняет ShardedProcessor.
+ * 
+ * После завершения любого режима, в том числе неудачного, в журнал
+ * выводятся квантили задержек ответа на векторы, а с опцией --metrics
+ * записывается файл с временем этапов, счетчиками и задержками Metrics.
+ * С опцией --trace записывается временная шкала Tracer: этапы, отправка и
+ * прием по пачкам векторов и файловый ввод-вывод по потокам. С опцией
+ * --profile в журнал выводятся такты, инструкции, IPC, промахи кэша и
+ * ветвлений по этапам (Profiler), с опцией --memory - выделения памяти,
+ * VmRSS и VmHWM по этапам и прирост памяти на вектор (MemoryTracker).
+ * 
  * @note Все этапы обрабатывают ошибки через ErrorHandler
  * @see parseCommandLineArgs()
  * @see readConfigFile()
  */
 bool Client::run(int argc, char* argv[]) {
-    // 1. Парсинг аргументов командной строки
-    if (!parseCommandLineArgs(argc, argv)) {
-        return false;
+    const uint64_t start = Tracer::now();
+    bool ok;
+    if (argc >= 2 && strcmp(argv[1], "convert") == 0) {
+        ok = runConvert(argc, argv);
+    } else if (argc >= 2 && strcmp(argv[1], "batch") == 0) {
+        ok = runBatch(argc, argv);
+    } else {
+        ok = runSingle(argc, argv);
     }
     
-    // 2. Чтение конфигурационного файла
-    if (!readConfigFile()) {
+    Metrics::logLatency();
+    if (config.profile) {
+        Profiler::logReport();
+    }
+    if (config.memoryReport) {
+        MemoryTracker::logReport();
+    }
+    if (!config.metricsFile.empty() && Metrics::writeFile(config.metricsFile, ok)) {
+        LOG_INFO("Метрики записаны в " << config.metricsFile);
+    }
+    if (!config.traceFile.empty()) {
+        Tracer::span("run", "stage", start, Tracer::now());
+        if (Tracer::writeFile(config.traceFile)) {
+            LOG_INFO("Трассировка записана в " << config.traceFile);
+        }
+    }
+    return ok;
+}
+
+/**
+ * @brief Обрабатывает один входной файл
+ * @param [in] argc Количество аргументов командной строки
+ * @param [in] argv Массив аргументов: <адрес_сервера> <входной_файл> <выходной_файл> [опции]
+ * @return true если результаты сохранены, false в случае ошибки
+ * @details Ошибки этапов только записываются в журнал, а не завершают
+ * программу, чтобы run() мог вывести метрики и для неудачного запуска.
+ * 
+ * При одном соединении без --stream разрыв соединения во время обмена
+ * не прерывает работу: сессия восстанавливается и отправляются только
+ * векторы без результатов. С --checkpoint полученные результаты, кроме
+ * того, дописываются в журнал выполненных векторов (CheckpointJournal)
+ * рядом с файлом результатов; после сохранения результатов он удаляется.
+ * Запуск с --resume отправляет только векторы, которых нет в журнале.
+ */
+bool Client::runSingle(int argc, char* argv[]) {
+    // 1. Парсинг аргументов командной строки
+    if (!parseCommandLineArgs(argc, argv)) {
         return false;
     }
-    
-    // 3. Обработка данных
-    DataProcessor dataProcessor;
-    if (!dataProcessor.readVectorsFromFile(config.inputFileName)) {
-        ErrorHandler::exitWithError("Ошибка чтения векторов из файла");
+    if (config.checkpoint && (config.streamMode || config.connections > 1)) {
+        ErrorHandler::logError("Опции --checkpoint и --resume поддерживаются только для одного соединения без --stream");
         return false;
     }
-    
-    if (!dataProcessor.validateData()) {
-        ErrorHandler::exitWithError("Ошибка валидации данных");
+    // Формат проверяется до подключения, чтобы не открывать сессию впустую
+    if (config.streamMode && VbinFormat::isVbinFile(config.inputFileName)) {
+        ErrorHandler::logError("Потоковый режим поддерживает только текстовые входные файлы: " +
+                               config.inputFileName);
         return false;
     }
-    
-    std::cout << "Отладка: Прочитано " << dataProcessor.getVectorsCount() << " векторов из файла " << config.inputFileName << std::endl;
-    
-    // 4. Установка соединения с сервером
-    ServerConnection connection;
-    if (!connection.establishConnection(config.serverAddress, config.serverPort)) {
-        ErrorHandler::exitWithError("Ошибка установки соединения с сервером");
+
+    // 2. Чтение конфигурационного файла
+    if (!readConfigFile()) {
         return false;
     }
     
-    // 5. Аутентификация
-    if (!connection.authenticate(config.login, config.password)) {
-        ErrorHandler::exitWithError("Ошибка аутентификации");
-        connection.closeConnection();
-        return false;
+    // 3. Обработка данных (в потоковом режиме файл читается по мере отправки)
+    DataProcessor dataProcessor;
+    dataProcessor.setParseThreads(config.parseThreads);
+    dataProcessor.setResultFormat(config.resultFormat);
+    if (!config.streamMode) {
+        if (!dataProcessor.readVectorsFromFile(config.inputFileName)) {
+            ErrorHandler::logError("Ошибка чтения векторов из файла");
+            return false;
+        }
+        
+        if (!dataProcessor.validateData()) {
+            ErrorHandler::logError("Ошибка валидации данных");
+            return false;
+        }
+        
+        LOG_DEBUG("Прочитано " << dataProcessor.getVectorsCount() << " векторов из файла " << config.inputFileName);
     }
     
-    // 6. Получение векторов и их отправка
-    const std::vector<std::vector<double>>& vectors = dataProcessor.getVectors();
+    const VectorStore& vectors = dataProcessor.getVectors();
     std::vector<double> results;
+    ServerConnection connection;
+    CheckpointJournal journal;
+    std::vector<CheckpointJournal::Range> pending;
     
-    if (!connection.sendVectors(vectors, results)) {
-        ErrorHandler::exitWithError("Ошибка отправки векторов на сервер");
-        connection.closeConnection();
+    if (config.connections > 1 && !config.streamMode) {
+        // 4-6. Несколько соединений: векторы делятся между сессиями
+        TraceSpan span("transfer", "stage", 0, vectors.size());
+        ShardedProcessor sharded(config);
+        if (!sharded.run(vectors, results)) {
+            ErrorHandler::logError("Ошибка обработки векторов в нескольких соединениях");
+            return false;
+        }
+    } else if (!config.streamMode && !openJournal(vectors, results, journal, pending)) {
         return false;
+    } else if (!config.streamMode && pending.empty()) {
+        LOG_INFO("Все " << vectors.size() << " векторов выполнены по журналу, подключение не требуется");
+    } else {
+        // 4. Установка соединения с сервером
+        if (!connection.establishConnection(config.serverAddress, config.serverPort)) {
+            ErrorHandler::logError("Ошибка установки соединения с сервером");
+            return false;
+        }
+        
+        connection.setPipelineWindow(config.pipelineWindow);
+        connection.setIoBackend(config.ioBackend);
+        
+        // 5. Аутентификация
+        if (!connection.authenticate(config.login, config.password)) {
+            ErrorHandler::logError("Ошибка аутентификации");
+            connection.closeConnection();
+            return false;
+        }
+        
+        // 6-7. Потоковый режим: чтение, отправка, прием и запись одновременно
+        if (config.streamMode) {
+            TraceSpan span("transfer", "stage");
+            StreamProcessor stream(connection);
+            stream.setResultFormat(config.resultFormat);
+            if (!stream.run(config.inputFileName, config.outputFileName)) {
+                ErrorHandler::logError("Ошибка потоковой обработки данных");
+                connection.closeConnection();
+                return false;
+            }
+            
+            connection.closeConnection();
+            LOG_INFO("Программа завершена успешно. Результаты сохранены в " << config.outputFileName);
+            return true;
+        }
+        
+        // 6. Отправка векторов, результаты которых еще не записаны в журнал
+        TraceSpan span("transfer", "stage", 0, vectors.size());
+        if (!sendPending(connection, vectors, pending, results, journal)) {
+            ErrorHandler::logError("Ошибка отправки векторов на сервер");
+            if (journal.isOpen()) {
+                LOG_INFO("Полученные результаты сохранены в журнале "
+                         << CheckpointJournal::pathFor(config.outputFileName)
+                         << ", для продолжения повторите запуск с --resume");
+            }
+            connection.closeConnection();
+            return false;
+        }
     }
     
-    std::cout << "Лог: Получено " << results.size() << " результатов от сервера" << std::endl;
+    LOG_INFO("Получено " << results.size() << " результатов от сервера");
     
     // Проверяем количество результатов
     if (results.size() != vectors.size()) {
-        std::cout << "Предупреждение: получено " << results.size() << " результатов, ожидалось " << vectors.size() << std::endl;
+        LOG_WARNING("Получено " << results.size() << " результатов, ожидалось " << vectors.size());
     }
     
     // 7. Сохранение результатов
     if (!dataProcessor.saveResults(config.outputFileName, results)) {
-        ErrorHandler::exitWithError("Ошибка сохранения результатов");
+        ErrorHandler::logError("Ошибка сохранения результатов");
         connection.closeConnection();
         return false;
     }
     
-    // 8. Закрытие соединения
+    // 8. Закрытие соединения; журнал больше не нужен
     connection.closeConnection();
+    journal.remove();
     
-    std::cout << "Программа завершена успешно. Результаты сохранены в " << config.outputFileName << std::endl;
+    LOG_INFO("Программа завершена успешно. Результаты сохранены в " << config.outputFileName);
     return true;
 }
+
+/**
+ * @brief Определяет векторы для отправки и открывает журнал выполненных векторов
+ * @param [in] vectors Входные векторы
+ * @param [out] results Буфер результатов
+ * @param [out] journal Журнал
+ * @param [out] pending Векторы для отправки
+ * @return true если векторы определены, false в случае ошибки
+ * @details Журнал привязан к контрольной сумме входных векторов, поэтому
+ * после изменения входного файла выполненные векторы не переиспользуются.
+ * Без --checkpoint журнал не создается: запуск не платит за запись
+ * и fdatasync() каждой части.
+ */
+bool Client::openJournal(const VectorStore& vectors, std::vector<double>& results, CheckpointJournal& journal,
+                         std::vector<CheckpointJournal::Range>& pending) {
+    results.assign(vectors.size(), 0.0);
+    pending.clear();
+    if (!vectors.empty()) {
+        CheckpointJournal::Range all = { 0, vectors.size() };
+        pending.push_back(all);
+    }
+    if (!config.checkpoint) {
+        return true;
+    }
+    
+    uint64_t checksum = ResultWriter::CHECKSUM_SEED;
+    for (size_t i = 0; i < vectors.size(); ++i) {
+        checksum = ResultWriter::updateChecksum(checksum, vectors[i]);
+    }
+    
+    const std::string path = CheckpointJournal::pathFor(config.outputFileName);
+    std::vector<CheckpointJournal::Range> completed;
+    if (config.resume && journal.load(path, checksum, vectors.size(), results.data(), completed)) {
+        pending = CheckpointJournal::pending(completed, vectors.size());
+        size_t remaining = 0;
+        for (const CheckpointJournal::Range& range : pending) {
+            remaining += range.end - range.begin;
+        }
+        LOG_INFO("Журнал " << path << ": выполнено " << vectors.size() - remaining << " векторов, осталось "
+                 << remaining);
+        return true;
+    }
+    
+    return journal.create(path, checksum, vectors.size());
+}
+
+/**
+ * @brief Отправляет невыполненные векторы, записывая результаты в журнал
+ * @param [in,out] connection Соединение
+ * @param [in] vectors Входные векторы
+ * @param [in] pending Диапазоны для отправки
+ * @param [in,out] results Буфер результатов
+ * @param [in,out] journal Журнал (может быть не открыт)
+ * @return true если получены все результаты, false в случае ошибки
+ * @details Каждая часть отправляется отдельным заданием sendVectorRange();
+ * граница части опустошает конвейер, поэтому части крупные, а без журнала
+ * диапазон не делится. Векторы учитываются в метрике один раз, до отправки:
+ * повторно отправленные после разрыва не добавляются.
+ */
+bool Client::sendPending(ServerConnection& connection, const VectorStore& vectors,
+                         const std::vector<CheckpointJournal::Range>& pending, std::vector<double>& results,
+                         CheckpointJournal& journal) {
+    ProfileScope profile(Metrics::SEND);
+    MemoryScope memory(Metrics::SEND);
+    for (const CheckpointJournal::Range& range : pending) {
+        Metrics::add(Metrics::VECTORS, range.end - range.begin);
+    }
+    
+    size_t attempt = 0;
+    for (const CheckpointJournal::Range& range : pending) {
+        size_t begin = range.begin;
+        while (begin < range.end) {
+            size_t end = range.end;
+            if (journal.isOpen()) {
+                size_t bytes = 0;
+                end = begin;
+                while (end < range.end && end - begin < JOURNAL_CHUNK_VECTORS &&
+                       (end == begin || bytes + vectors[end].byteSize() <= JOURNAL_CHUNK_BYTES)) {
+                    bytes += vectors[end].byteSize();
+                    ++end;
+                }
+            }
+            
+            const bool ok = connection.sendVectorRange(vectors, begin, end, results.data() + begin);
+            const size_t received = ok ? end - begin : connection.getResultsReceived();
+            Metrics::add(Metrics::RESULTS, received);
+            if (journal.isOpen() && !journal.append(begin, received, results.data() + begin)) {
+                return false;
+            }
+            begin += received;
+            if (ok) {
+                continue;
+            }
+            
+            // Разрыв: продолжаем с первого вектора без результата в новой сессии
+            if (received > 0) {
+                attempt = 0;
+            }
+            LOG_WARNING("Обмен прерван на векторе " << begin << ", получено " << received << " результатов из "
+                        << end - begin + received);
+            if (!reconnect(connection, attempt)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Восстанавливает сессию после разрыва соединения
+ * @param [in,out] connection Соединение
+ * @param [in,out] attempt Номер попытки подряд без продвижения
+ * @return true если сессия восстановлена, false если попытки исчерпаны
+ */
+bool Client::reconnect(ServerConnection& connection, size_t& attempt) {
+    static std::mt19937 random(std::random_device{}());
+    connection.closeConnection();
+    while (attempt < config.retries) {
+        ++attempt;
+        const unsigned shift = static_cast<unsigned>(std::min<size_t>(attempt - 1, 16));
+        const unsigned delay = std::min(RECONNECT_MAX_DELAY_MS, RECONNECT_BASE_DELAY_MS << shift);
+        const unsigned jittered = std::uniform_int_distribution<unsigned>(delay / 2, delay)(random);
+        LOG_WARNING("Повторное подключение через " << jittered << " мс (попытка " << attempt << " из "
+                    << config.retries << ")");
+        std::this_thread::sleep_for(std::chrono::milliseconds(jittered));
+        
+        if (connection.establishConnection(config.serverAddress, config.serverPort) &&
+            connection.authenticate(config.login, config.password)) {
+            Metrics::add(Metrics::RECONNECTS);
+            return true;
+        }
+        connection.closeConnection();
+    }
+    ErrorHandler::logError("Не удалось восстановить соединение за " + std::to_string(config.retries) + " попыток");
+    return false;
+}
@@ -1,7 +1,13 @@
 #ifndef CLIENT_H
 #define CLIENT_H
 
+#include "ResultWriter.h"
+#include "CheckpointJournal.h"
 #include <string>
+#include <vector>
+
+class ServerConnection;
+class VectorStore;
 
 /**
  * @brief Структура для хранения конфигурации клиента
@@ -16,12 +22,36 @@ struct ClientConfig {
     std::string configFileName; ///< Имя файла конфигурации с учетными данными
     std::string login;          ///< Логин пользователя
     std::string password;       ///< Пароль пользователя
+    size_t pipelineWindow;      ///< Окно конвейерной отправки векторов
+    bool streamMode;            ///< Потоковая обработка с ограниченным расходом памяти
+    size_t parseThreads;        ///< Количество потоков разбора входного файла (0 - по числу ядер)
+    size_t connections;         ///< Количество параллельных соединений с сервером
+    std::string ioBackend;      ///< Механизм ввода-вывода: auto, uring или blocking
+    ResultWriter::Format resultFormat;  ///< Формат файла результатов
+    std::string metricsFile;    ///< Файл метрик этапов (пусто - метрики не выводятся)
+    std::string traceFile;      ///< Файл временной шкалы (пусто - трассировка выключена)
+    bool profile;               ///< Профиль этапов по счетчикам процессора
+    bool memoryReport;          ///< Отчет о расходе памяти по этапам
+    bool checkpoint;            ///< Вести журнал выполненных векторов (--checkpoint, --resume)
+    bool resume;                ///< Продолжить работу по журналу выполненных векторов
+    size_t retries;             ///< Попыток повторного подключения подряд после разрыва
     
     /**
      * @brief Конструктор по умолчанию
      * @details Инициализирует значения по умолчанию:
      * - serverPort: 33333
      * - configFileName: "~/.config/velient.conf"
+     * - pipelineWindow: 1 (без конвейера)
+     * - streamMode: false
+     * - parseThreads: 0 (по числу ядер)
+     * - connections: 1
+     * - ioBackend: "auto"
+     * - resultFormat: ResultWriter::TEXT
+     * - profile: false
+     * - memoryReport: false
+     * - checkpoint: false
+     * - resume: false
+     * - retries: 5
      * - Остальные поля: пустые строки
      */
     ClientConfig();
@@ -50,6 +80,21 @@ private:
      * - Опциональные:
      *   -p <порт> - порт сервера (по умолчанию: 33333)
      *   -c <файл_конфига> - файл с логином и паролем
+     *   -w <окно> - число векторов, отправляемых без ожидания ответа (по умолчанию: 1)
+     *   --stream - потоковая обработка файла с ограниченным расходом памяти
+     *   -t <потоки> - количество потоков разбора входного файла (по умолчанию: по числу ядер)
+     *   -j <соединения> - количество параллельных соединений с сервером (по умолчанию: 1)
+     *   --io <механизм> - механизм ввода-вывода: auto, uring, blocking (по умолчанию: auto)
+     *   -f <формат> - формат файла результатов: text, binary, columnar (по умолчанию: text)
+     *   -v - подробный журнал с отладочными сообщениями (если они не исключены при сборке)
+     *   -q - выводить только ошибки
+     *   --metrics=<файл> - записать время этапов и счетчики (JSON, для *.prom - формат Prometheus)
+     *   --trace=<файл> - записать временную шкалу в формате Chrome trace events (Perfetto)
+     *   --profile - вывести профиль этапов по счетчикам процессора (perf_event_open)
+     *   --memory - вывести выделения памяти и размер процесса по этапам
+     *   --checkpoint - вести журнал выполненных векторов для продолжения с --resume
+     *   --resume - пропустить векторы, выполненные по журналу прерванного запуска (включает --checkpoint)
+     *   --retries <n> - попыток повторного подключения после разрыва (0 - не подключаться)
      *   -h - вывод справки
      */
     bool parseCommandLineArgs(int argc, char* argv[]);
@@ -63,6 +108,90 @@ private:
      */
     bool readConfigFile();
     
+    /**
+     * @brief Преобразует файл векторов между текстовым форматом и .vbin
+     * @param [in] argc Количество аргументов
+     * @param [in] argv Массив аргументов: client convert <источник> <приемник>
+     * @return true если преобразование успешно, false в случае ошибки
+     * @details Направление определяется по источнику: файл .vbin
+     * преобразуется в текст, текстовый файл - в .vbin.
+     */
+    bool runConvert(int argc, char* argv[]);
+    
+    /**
+     * @brief Выполняет подкоманду batch
+     * @param [in] argc Количество аргументов командной строки
+     * @param [in] argv Массив аргументов: batch <адрес_сервера> <манифест> [опции]
+     * @return true если все задания выполнены успешно, false в случае ошибки
+     * @details Подключение и аутентификация выполняются один раз,
+     * после чего задания манифеста обрабатываются в этой же сессии.
+     */
+    bool runBatch(int argc, char* argv[]);
+    
+    /**
+     * @brief Обрабатывает один входной файл
+     * @param [in] argc Количество аргументов командной строки
+     * @param [in] argv Массив аргументов: <адрес_сервера> <входной_файл> <выходной_файл> [опции]
+     * @return true если результаты сохранены, false в случае ошибки
+     */
+    bool runSingle(int argc, char* argv[]);
+    
+    /**
+     * @brief Определяет векторы для отправки и открывает журнал выполненных векторов
+     * @param [in] vectors Входные векторы
+     * @param [out] results Буфер результатов по числу векторов; заполняется из журнала
+     * @param [out] journal Журнал, открытый для дописывания (только с --checkpoint)
+     * @param [out] pending Векторы, которые нужно отправить
+     * @return true если векторы определены, false если журнал не создан
+     * @details Без --checkpoint журнал не ведется и отправке подлежат все
+     * векторы. С --resume загружается журнал прерванного запуска; если его
+     * нет или он относится к другим данным, а также с одной --checkpoint,
+     * создается новый журнал и отправке подлежат все векторы.
+     */
+    bool openJournal(const VectorStore& vectors, std::vector<double>& results, CheckpointJournal& journal,
+                     std::vector<CheckpointJournal::Range>& pending);
+    
+    /**
+     * @brief Отправляет невыполненные векторы, записывая результаты в журнал
+     * @param [in,out] connection Соединение после аутентификации
+     * @param [in] vectors Входные векторы
+     * @param [in] pending Диапазоны векторов для отправки
+     * @param [in,out] results Буфер результатов по числу векторов
+     * @param [in,out] journal Журнал; если он не открыт, результаты в него не пишутся
+     * @return true если получены все результаты, false в случае ошибки
+     * @details С открытым журналом диапазоны отправляются частями не больше
+     * JOURNAL_CHUNK_VECTORS векторов и JOURNAL_CHUNK_BYTES байт, и результаты
+     * каждой части сразу дописываются в журнал; без журнала каждый диапазон
+     * уходит одним заданием. При обрыве reconnect() восстанавливает сессию
+     * и отправка продолжается с первого вектора без результата.
+     */
+    bool sendPending(ServerConnection& connection, const VectorStore& vectors,
+                     const std::vector<CheckpointJournal::Range>& pending, std::vector<double>& results,
+                     CheckpointJournal& journal);
+    
+    /**
+     * @brief Восстанавливает сессию после разрыва соединения
+     * @param [in,out] connection Соединение
+     * @param [in,out] attempt Номер попытки подряд без продвижения; увеличивается
+     * @return true если соединение установлено и аутентификация пройдена,
+     * false если попытки (config.retries) исчерпаны
+     * @details Перед каждой попыткой выдерживается пауза с экспоненциальным
+     * ростом от RECONNECT_BASE_DELAY_MS до RECONNECT_MAX_DELAY_MS и случайным
+     * разбросом (от половины до полной паузы), чтобы клиенты, потерявшие
+     * соединение одновременно, не подключались разом. Аутентификация
+     * выполняется заново с новой солью сервера.
+     */
+    bool reconnect(ServerConnection& connection, size_t& attempt);
+    
+    /**
+     * @brief Парсит опциональные аргументы командной строки
+     * @param [in] argc Количество аргументов
+     * @param [in] argv Массив аргументов
+     * @param [in] first Индекс первого опционального аргумента
+     * @return true если парсинг успешен, false в случае ошибки
+     */
+    bool parseOptions(int argc, char* argv[], int first);
+    
 public:
     /**
      * @brief Основной метод запуска клиента
@@ -77,6 +206,12 @@ public:
      * 5. Чтение и обработка данных
      * 6. Отправка данных на сервер
      * 7. Получение и сохранение результатов
+     * 
+     * Если первый аргумент - convert, выполняется runConvert(),
+     * если batch - runBatch(), иначе - runSingle(). По завершении выводятся
+     * квантили задержек ответа, а с опцией --metrics записывается файл метрик,
+     * с опцией --trace - файл временной шкалы, с опцией --profile - профиль этапов,
+     * с опцией --memory - расход памяти.
      */
     bool run(int argc, char* argv[]);
 };
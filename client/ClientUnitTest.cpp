@@ -1,13 +1,38 @@
 #include <UnitTest++/UnitTest++.h>
+#include "TextParser.h"
+#include "VectorStore.h"
+#include "VbinFormat.h"
+#include "LatencyHistogram.h"
+#include "CheckpointJournal.h"
+#include "DataProcessor.h"
+#include "ResultWriter.h"
+#include "ReferenceServer.h"
+#include "Client.h"
+#include "Metrics.h"
+#include "Logger.h"
+#include "ServerConnection.h"
+#include "ShardedProcessor.h"
+#include "AsyncConnection.h"
+#include "Scheduler.h"
+#include "BatchProcessor.h"
+#include <dirent.h>
+#include <chrono>
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 #include <string>
 #include <vector>
 #include <sstream>
 #include <cstring>
+#include <cstdlib>
 #include <cmath>
 #include <unistd.h>
+#include <fcntl.h>
+#include <functional>
 #include <sys/stat.h>
+#include <sys/resource.h>
+#include <signal.h>
+#include <charconv>
 
 using namespace std;
 
@@ -32,6 +57,24 @@ namespace TestUtils {
     void deleteFile(const string& filename) {
         unlink(filename.c_str());
     }
+    
+    // Выполняет action и возвращает то, что журнал вывел в target
+    // (STDOUT_FILENO - ход работы, STDERR_FILENO - предупреждения и ошибки)
+    string captureOutput(int target, const function<void()>& action) {
+        Logger::flush();
+        const string filename = createTempFile("");
+        const int saved = dup(target);
+        const int fd = open(filename.c_str(), O_WRONLY);
+        dup2(fd, target);
+        close(fd);
+        action();
+        Logger::flush();
+        dup2(saved, target);
+        close(saved);
+        const string text = readFile(filename);
+        deleteFile(filename);
+        return text;
+    }
 }
 
 
@@ -446,18 +489,6 @@ SUITE(FormatTests)
     }
 }
 
-struct ClientConfig {
-    string serverAddress;
-    int serverPort;
-    string inputFileName;
-    string outputFileName;
-    string configFileName;
-    string login;
-    string password;
-    
-    ClientConfig() : serverPort(33333), configFileName("~/.config/velient.conf") {}
-};
-
 SUITE(ClientConfigTest)
 {
     TEST(DefaultConstructorTest) {
@@ -473,6 +504,1305 @@ SUITE(ClientConfigTest)
     }
 }
 
+namespace ParserUtils {
+    bool parse(const string& token, double& value) {
+        return TextParser::parseDoubleToken(token.data(), token.data() + token.size(), value);
+    }
+    
+    bool sameBits(double a, double b) {
+        return memcmp(&a, &b, sizeof(a)) == 0;
+    }
+}
+
+SUITE(TextParserTest)
+{
+    // Тест 1: Быстрый путь - простые десятичные записи
+    TEST(FastPathTest) {
+        double value = 0;
+        CHECK(ParserUtils::parse("1.5", value));
+        CHECK_EQUAL(1.5, value);
+        CHECK(ParserUtils::parse("-0.25", value));
+        CHECK_EQUAL(-0.25, value);
+        CHECK(ParserUtils::parse("+3", value));
+        CHECK_EQUAL(3.0, value);
+        CHECK(ParserUtils::parse(".5", value));
+        CHECK_EQUAL(0.5, value);
+        CHECK(ParserUtils::parse("5.", value));
+        CHECK_EQUAL(5.0, value);
+        CHECK(ParserUtils::parse("1E3", value));
+        CHECK_EQUAL(1000.0, value);
+        CHECK(ParserUtils::parse("-0", value));
+        CHECK(ParserUtils::sameBits(-0.0, value));
+    }
+    
+    // Тест 2: Граница быстрого и медленного пути
+    TEST(PathBoundaryTest) {
+        // 19 значащих цифр и мантисса больше 2^53 - медленный путь
+        const char* tokens[] = {
+            "1234567890123456789",         // 19 цифр
+            "12345678901234567890",        // 20 цифр
+            "9007199254740992",            // 2^53 - еще быстрый путь
+            "9007199254740993",            // 2^53 + 1 - округление к четному
+            "0.1234567890123456789012345", // длинная дробная часть
+            "1e22", "1e23", "1e-22", "1e-23",
+            "123.456e-30", "4.9e-324", "2.2250738585072014e-308",
+            "1.7976931348623157e308"
+        };
+        for (const char* token : tokens) {
+            double value = 0;
+            CHECK(ParserUtils::parse(token, value));
+            CHECK(ParserUtils::sameBits(strtod(token, nullptr), value));
+        }
+    }
+    
+    // Тест 3: Нулевые и незначащие цифры
+    TEST(ZerosTest) {
+        double value = 1;
+        CHECK(ParserUtils::parse("0000000000000000000000001", value));
+        CHECK_EQUAL(1.0, value);
+        CHECK(ParserUtils::parse("0.000000000000000000000000", value));
+        CHECK_EQUAL(0.0, value);
+        CHECK(ParserUtils::parse("1.0000000000000000000000000001", value));
+        CHECK_EQUAL(1.0, value);
+    }
+    
+    // Тест 4: Выход за пределы double
+    TEST(OutOfRangeTest) {
+        double value = 1;
+        CHECK(!ParserUtils::parse("1e400", value));
+        CHECK(!ParserUtils::parse("-1e309", value));
+        CHECK(ParserUtils::parse("1e-400", value));
+        CHECK_EQUAL(0.0, value);
+        CHECK(ParserUtils::parse("-1e-400", value));
+        CHECK(ParserUtils::sameBits(-0.0, value));
+    }
+    
+    // Тест 5: Записи, которые не являются десятичными числами
+    TEST(RejectedFormsTest) {
+        const char* tokens[] = {
+            "inf", "-inf", "infinity", "nan", "NAN", "0x1p3", "0x10",
+            "1e", "1e+", ".", "-", "+-1", "1.2.3", "1,5", "abc", "1a"
+        };
+        for (const char* token : tokens) {
+            double value = 42;
+            CHECK(!ParserUtils::parse(token, value));
+            CHECK_EQUAL(42.0, value);
+        }
+    }
+    
+    // Тест 6: Позиция ошибки
+    TEST(ErrorPositionTest) {
+        string text = "2\n3\n1.0 2.0 3.0\n2\n4.0 nan\n";
+        TextParser parser(text.data(), text.size());
+        uint64_t count = 0;
+        double value = 0;
+        CHECK(parser.parseCount(count));
+        CHECK(parser.parseCount(count));
+        for (int i = 0; i < 3; ++i) {
+            CHECK(parser.parseDouble(value));
+        }
+        CHECK(parser.parseCount(count));
+        CHECK(parser.parseDouble(value));
+        CHECK(!parser.parseDouble(value));
+        CHECK_EQUAL("строка 5, столбец 5: 'nan'", parser.describePosition());
+        
+        string truncated = "1\n2\n1.0";
+        TextParser tail(truncated.data(), truncated.size());
+        CHECK(tail.parseCount(count));
+        CHECK(tail.parseCount(count));
+        CHECK(tail.parseDouble(value));
+        CHECK(!tail.parseDouble(value));
+        CHECK_EQUAL("строка 3, столбец 4: неожиданный конец файла", tail.describePosition());
+    }
+}
+
+namespace ParallelParseUtils {
+    // Файл больше PARALLEL_PARSE_MIN_BYTES (1 МБ): векторы размеров 1-9,
+    // значения badValues заменяют первое значение векторов с этими номерами
+    string writeInput(size_t count, const vector<pair<size_t, string>>& badValues = {}) {
+        string text = to_string(count) + "\n";
+        char value[64];
+        for (size_t i = 0; i < count; ++i) {
+            const size_t size = 1 + i % 9;
+            text += to_string(size) + "\n";
+            for (size_t j = 0; j < size; ++j) {
+                snprintf(value, sizeof(value), "%.17g", (static_cast<double>(i) * 13 + j) / 7.0 - 1000.0);
+                string token = value;
+                for (const pair<size_t, string>& bad : badValues) {
+                    if (bad.first == i && j == 0) {
+                        token = bad.second;
+                    }
+                }
+                text += (j > 0 ? " " : "") + token;
+            }
+            text += "\n";
+        }
+        return TestUtils::createTempFile(text);
+    }
+    
+    // Разбирает файл и возвращает сообщение об ошибке (пустое при успехе)
+    string parseErrors(const string& filename, size_t threads, bool& ok) {
+        return TestUtils::captureOutput(STDERR_FILENO, [&]() {
+            DataProcessor processor;
+            processor.setParseThreads(threads);
+            ok = processor.readVectorsFromFile(filename);
+        });
+    }
+}
+
+SUITE(ParallelParseTest)
+{
+    // Тест 1: Разбор в несколько потоков сохраняет порядок векторов
+    TEST(MatchesSingleThread)
+    {
+        const string filename = ParallelParseUtils::writeInput(20000);
+        struct stat info;
+        CHECK(stat(filename.c_str(), &info) == 0 && info.st_size >= (1 << 20));
+        
+        DataProcessor single;
+        DataProcessor parallel;
+        parallel.setParseThreads(4);
+        CHECK(single.readVectorsFromFile(filename));
+        CHECK(parallel.readVectorsFromFile(filename));
+        
+        const VectorStore& expected = single.getVectors();
+        const VectorStore& actual = parallel.getVectors();
+        CHECK_EQUAL(20000u, actual.size());
+        CHECK_EQUAL(expected.size(), actual.size());
+        CHECK_EQUAL(expected.valueCount(), actual.valueCount());
+        size_t mismatches = 0;
+        for (size_t i = 0; i < expected.size() && i < actual.size(); ++i) {
+            if (expected.dimension(i) != actual.dimension(i)) {
+                ++mismatches;
+                continue;
+            }
+            for (size_t j = 0; j < expected.dimension(i); ++j) {
+                mismatches += ParserUtils::sameBits(expected[i][j], actual[i][j]) ? 0 : 1;
+            }
+        }
+        CHECK_EQUAL(0u, mismatches);
+        TestUtils::deleteFile(filename);
+    }
+    
+    // Тест 2: Сообщается ошибка вектора с наименьшим номером
+    TEST(ReportsLowestVectorError)
+    {
+        // Участки по ~1/16 файла: вектор 18999 лежит в последнем участке,
+        // вектор 4000 - в четвертом
+        const vector<vector<pair<size_t, string>>> cases = {
+            {{18999, "bad"}, {4000, "1.0e"}},
+            {{4000, "bad"}, {4001, "bad"}, {18999, "bad"}},
+            {{4000, "nan"}, {19999, "oops"}},
+        };
+        for (const vector<pair<size_t, string>>& badValues : cases) {
+            const string filename = ParallelParseUtils::writeInput(20000, badValues);
+            bool singleOk = true;
+            bool parallelOk = true;
+            const string expected = ParallelParseUtils::parseErrors(filename, 1, singleOk);
+            const string actual = ParallelParseUtils::parseErrors(filename, 4, parallelOk);
+            CHECK(!singleOk);
+            CHECK(!parallelOk);
+            CHECK(expected.find("вектора 4001 (строка 8003,") != string::npos);
+            CHECK_EQUAL(expected, actual);
+            TestUtils::deleteFile(filename);
+        }
+        
+        // Ошибка структуры (размер вектора) после ошибки значения
+        const string filename = ParallelParseUtils::writeInput(20000, {{4000, "bad"}});
+        string content = TestUtils::readFile(filename);
+        const size_t line = content.find("\n9\n", content.size() - 4096);
+        CHECK(line != string::npos);
+        content.replace(line + 1, 1, "x");
+        ofstream(filename, ios::binary | ios::trunc) << content;
+        bool ok = true;
+        const string actual = ParallelParseUtils::parseErrors(filename, 4, ok);
+        CHECK(!ok);
+        CHECK(actual.find("значения вектора 4001 ") != string::npos);
+        CHECK(actual.find("размера") == string::npos);
+        TestUtils::deleteFile(filename);
+    }
+}
+
+namespace VbinUtils {
+    // Три вектора: {1, 2, 3}, {}, {4.5}
+    VectorStore sampleVectors() {
+        VectorStore vectors;
+        double* first = vectors.append(3);
+        first[0] = 1; first[1] = 2; first[2] = 3;
+        vectors.append(0);
+        vectors.append(1)[0] = 4.5;
+        return vectors;
+    }
+    
+    string writeSample(bool withIndex) {
+        string filename = TestUtils::createTempFile("");
+        VbinFormat::write(sampleVectors(), filename, withIndex);
+        return filename;
+    }
+    
+    VbinHeader readHeader(const string& content) {
+        VbinHeader header;
+        memcpy(&header, content.data(), sizeof(header));
+        return header;
+    }
+    
+    bool loadContent(const string& content) {
+        string filename = TestUtils::createTempFile(content);
+        VectorStore vectors;
+        bool ok = VbinFormat::load(filename, vectors);
+        TestUtils::deleteFile(filename);
+        return ok;
+    }
+}
+
+SUITE(VbinFormatTest)
+{
+    // Тест 1: Запись и чтение с индексом и без него
+    TEST(RoundTripTest) {
+        for (int withIndex = 0; withIndex < 2; ++withIndex) {
+            string filename = VbinUtils::writeSample(withIndex != 0);
+            VectorStore vectors;
+            CHECK(VbinFormat::load(filename, vectors));
+            CHECK(vectors.isMapped());
+            CHECK_EQUAL(3u, vectors.size());
+            CHECK_EQUAL(4u, vectors.valueCount());
+            CHECK_EQUAL(3u, vectors.dimension(0));
+            CHECK_EQUAL(0u, vectors.dimension(1));
+            CHECK_EQUAL(3.0, vectors[0][2]);
+            CHECK_EQUAL(4.5, vectors[2][0]);
+            TestUtils::deleteFile(filename);
+        }
+    }
+    
+    // Тест 2: Файл, обрезанный в любом месте, не загружается
+    TEST(TruncatedFileTest) {
+        for (int withIndex = 0; withIndex < 2; ++withIndex) {
+            string filename = VbinUtils::writeSample(withIndex != 0);
+            string content = TestUtils::readFile(filename);
+            TestUtils::deleteFile(filename);
+            for (size_t length = 0; length < content.size(); ++length) {
+                CHECK(!VbinUtils::loadContent(content.substr(0, length)));
+            }
+        }
+    }
+    
+    // Тест 3: Количество векторов в нагрузке больше, чем в заголовке
+    TEST(PayloadCountMismatchTest) {
+        for (int withIndex = 0; withIndex < 2; ++withIndex) {
+            string filename = VbinUtils::writeSample(withIndex != 0);
+            string content = TestUtils::readFile(filename);
+            TestUtils::deleteFile(filename);
+            
+            VbinHeader header = VbinUtils::readHeader(content);
+            uint32_t count = 1000000;
+            memcpy(&content[header.payloadOffset], &count, sizeof(count));
+            CHECK(!VbinUtils::loadContent(content));
+            
+            count = 2;
+            memcpy(&content[header.payloadOffset], &count, sizeof(count));
+            CHECK(!VbinUtils::loadContent(content));
+        }
+    }
+    
+    // Тест 4: Испорченные размеры, индекс и заголовок
+    TEST(CorruptFileTest) {
+        string filename = VbinUtils::writeSample(true);
+        const string content = TestUtils::readFile(filename);
+        TestUtils::deleteFile(filename);
+        const VbinHeader header = VbinUtils::readHeader(content);
+        
+        // Размер первого вектора выходит за нагрузку
+        string corrupt = content;
+        uint32_t hugeSize = 0x7FFFFFFF;
+        memcpy(&corrupt[header.payloadOffset + sizeof(uint32_t)], &hugeSize, sizeof(hugeSize));
+        CHECK(!VbinUtils::loadContent(corrupt));
+        
+        // Смещение в индексе не совпадает с данными
+        corrupt = content;
+        uint64_t badOffset = 12345;
+        memcpy(&corrupt[header.indexOffset + sizeof(uint64_t)], &badOffset, sizeof(badOffset));
+        CHECK(!VbinUtils::loadContent(corrupt));
+        
+        // Индекс за концом файла
+        corrupt = content;
+        VbinHeader badHeader = header;
+        badHeader.indexOffset = content.size();
+        memcpy(&corrupt[0], &badHeader, sizeof(badHeader));
+        CHECK(!VbinUtils::loadContent(corrupt));
+        
+        // Заголовок обещает больше векторов, чем есть в нагрузке и индексе
+        corrupt = content;
+        badHeader = header;
+        badHeader.vectorCount = 1000000;
+        memcpy(&corrupt[0], &badHeader, sizeof(badHeader));
+        CHECK(!VbinUtils::loadContent(corrupt));
+        
+        // Сумма размеров не совпадает с количеством значений
+        corrupt = content;
+        badHeader = header;
+        badHeader.valueCount = 5;
+        memcpy(&corrupt[0], &badHeader, sizeof(badHeader));
+        CHECK(!VbinUtils::loadContent(corrupt));
+        
+        // Неверная сигнатура
+        corrupt = content;
+        corrupt[0] = 'X';
+        CHECK(!VbinUtils::loadContent(corrupt));
+    }
+    
+    // Тест 5: Перемещение хранилища без индекса в файле
+    TEST(MoveMappedStoreTest) {
+        string filename = VbinUtils::writeSample(false);
+        VectorStore source;
+        CHECK(VbinFormat::load(filename, source));
+        
+        VectorStore moved(std::move(source));
+        CHECK(source.empty());
+        CHECK_EQUAL(3u, moved.size());
+        CHECK_EQUAL(1u, moved.dimension(2));
+        CHECK_EQUAL(4.5, moved[2][0]);
+        
+        VectorStore assigned;
+        assigned = std::move(moved);
+        CHECK(moved.empty());
+        CHECK_EQUAL(2.0, assigned[0][1]);
+        CHECK_EQUAL(assigned.wireOffset(3), assigned.wireBytes(0, 3) + sizeof(uint32_t));
+        TestUtils::deleteFile(filename);
+    }
+}
+
+SUITE(LatencyHistogramTest)
+{
+    // Тест 1: Пустая гистограмма
+    TEST(EmptyHistogram)
+    {
+        LatencyHistogram histogram;
+        CHECK_EQUAL(0u, histogram.count());
+        CHECK_EQUAL(0u, histogram.max());
+        CHECK_EQUAL(0u, histogram.percentile(0.0));
+        CHECK_EQUAL(0u, histogram.percentile(0.5));
+        CHECK_EQUAL(0u, histogram.percentile(1.0));
+    }
+    
+    // Тест 2: Точные значения и ноль
+    TEST(LinearValues)
+    {
+        for (uint64_t value = 0; value < LatencyHistogram::LINEAR_VALUES; ++value) {
+            CHECK_EQUAL(value, LatencyHistogram::indexOf(value));
+            CHECK_EQUAL(value, LatencyHistogram::upperBound(LatencyHistogram::indexOf(value)));
+        }
+        
+        LatencyHistogram histogram;
+        histogram.record(0);
+        CHECK_EQUAL(1u, histogram.count());
+        CHECK_EQUAL(0u, histogram.percentile(0.0));
+        CHECK_EQUAL(0u, histogram.percentile(1.0));
+    }
+    
+    // Тест 3: Границы интервалов
+    TEST(BucketBoundaries)
+    {
+        CHECK_EQUAL(63u, LatencyHistogram::indexOf(63));
+        CHECK_EQUAL(64u, LatencyHistogram::indexOf(64));
+        CHECK_EQUAL(64u, LatencyHistogram::indexOf(65));
+        CHECK_EQUAL(65u, LatencyHistogram::indexOf(66));
+        CHECK_EQUAL(65u, LatencyHistogram::upperBound(64));
+        
+        // Наибольшее значение интервала лежит в нем, следующее - в следующем
+        for (size_t index = LatencyHistogram::LINEAR_VALUES; index < LatencyHistogram::BUCKET_COUNT; ++index) {
+            const uint64_t bound = LatencyHistogram::upperBound(index);
+            CHECK_EQUAL(index, LatencyHistogram::indexOf(bound));
+            CHECK_EQUAL(index - 1, LatencyHistogram::indexOf(LatencyHistogram::upperBound(index - 1)));
+            if (index + 1 < LatencyHistogram::BUCKET_COUNT) {
+                CHECK_EQUAL(index + 1, LatencyHistogram::indexOf(bound + 1));
+            }
+            // Ширина интервала не больше 1/32 его начала
+            const uint64_t lower = LatencyHistogram::upperBound(index - 1) + 1;
+            CHECK(bound - lower + 1 <= lower / LatencyHistogram::SUB_BUCKETS);
+        }
+    }
+    
+    // Тест 4: Наибольшее значение
+    TEST(LargestValue)
+    {
+        const uint64_t limit = (1ull << LatencyHistogram::MAX_EXPONENT) - 1;
+        CHECK_EQUAL(LatencyHistogram::BUCKET_COUNT - 1, LatencyHistogram::indexOf(limit));
+        CHECK_EQUAL(limit, LatencyHistogram::upperBound(LatencyHistogram::BUCKET_COUNT - 1));
+        
+        // Значения больше предела попадают в последний интервал, max() остается точным
+        LatencyHistogram histogram;
+        histogram.record(1ull << 50);
+        CHECK_EQUAL(1ull << 50, histogram.max());
+        CHECK_EQUAL(limit, histogram.percentile(1.0));
+        
+        LatencyHistogram exact;
+        exact.record(limit);
+        CHECK_EQUAL(limit, exact.percentile(0.5));
+    }
+    
+    // Тест 5: Квантили
+    TEST(Percentiles)
+    {
+        LatencyHistogram histogram;
+        for (uint64_t value = 1; value <= 100; ++value) {
+            histogram.record(value);
+        }
+        CHECK_EQUAL(100u, histogram.count());
+        CHECK_EQUAL(5050u, histogram.totalSum());
+        CHECK_EQUAL(1u, histogram.percentile(0.0));
+        CHECK_EQUAL(50u, histogram.percentile(0.5));
+        CHECK_EQUAL(99u, histogram.percentile(0.99));
+        // Граница интервала 100..101 ограничивается наибольшим значением
+        CHECK_EQUAL(100u, histogram.percentile(1.0));
+        
+        LatencyHistogram merged;
+        merged.add(histogram);
+        merged.add(histogram);
+        CHECK_EQUAL(200u, merged.count());
+        CHECK_EQUAL(50u, merged.percentile(0.5));
+        CHECK_EQUAL(100u, merged.max());
+    }
+}
+
+namespace RunUtils {
+    // Входной файл: количество векторов, затем размер и значения каждого
+    // (размеры от 1 до maxSize по кругу)
+    string writeInput(size_t count, size_t maxSize = 5) {
+        ostringstream text;
+        text << count << "\n";
+        for (size_t i = 0; i < count; ++i) {
+            const size_t size = 1 + i % maxSize;
+            text << size << "\n";
+            for (size_t j = 0; j < size; ++j) {
+                text << (j > 0 ? " " : "") << (static_cast<double>(i * 7 + j) / 3.0 - 10.0);
+            }
+            text << "\n";
+        }
+        return TestUtils::createTempFile(text.str());
+    }
+    
+    uint64_t inputChecksum(const VectorStore& vectors) {
+        uint64_t checksum = ResultWriter::CHECKSUM_SEED;
+        for (size_t i = 0; i < vectors.size(); ++i) {
+            checksum = ResultWriter::updateChecksum(checksum, vectors[i]);
+        }
+        return checksum;
+    }
+    
+    bool runClient(const vector<string>& args) {
+        vector<char*> argv;
+        for (const string& arg : args) {
+            argv.push_back(const_cast<char*>(arg.c_str()));
+        }
+        argv.push_back(nullptr);
+        Client client;
+        return client.run(static_cast<int>(args.size()), argv.data());
+    }
+    
+    size_t openDescriptors() {
+        size_t count = 0;
+        DIR* dir = opendir("/proc/self/fd");
+        if (dir == nullptr) return 0;
+        while (readdir(dir) != nullptr) {
+            ++count;
+        }
+        closedir(dir);
+        return count;
+    }
+    
+    vector<string> clientArgs(int port, const string& input, const string& output, const string& conf) {
+        return {"client", "127.0.0.1", input, output, "-p", to_string(port), "-c", conf, "-q"};
+    }
+}
+
+// Эталонный сервер, входной файл и результат непрерывного запуска в fullOutput;
+// файлы удаляются и сервер останавливается и при провале проверки
+struct ServerFixture {
+    ReferenceServer server;
+    string input;
+    string conf;
+    string fullOutput;
+    string output;
+    LogLevel savedLevel;
+    
+    ServerFixture()
+        : server("user", "pass"), conf(TestUtils::createTempFile("user\npass\n")),
+          fullOutput(TestUtils::createTempFile("")), output(TestUtils::createTempFile("")),
+          savedLevel(Logger::getLevel()) {
+        CHECK(server.start(0));
+        useInput(60);
+    }
+    
+    ~ServerFixture() {
+        server.stop();
+        TestUtils::deleteFile(input);
+        TestUtils::deleteFile(conf);
+        TestUtils::deleteFile(fullOutput);
+        TestUtils::deleteFile(output);
+        TestUtils::deleteFile(CheckpointJournal::pathFor(output));
+        Logger::setLevel(savedLevel);  // Клиент с -q понижает уровень журнала
+    }
+    
+    // Заменяет входной файл на count векторов и заново получает fullOutput
+    void useInput(size_t count, size_t maxSize = 5) {
+        useInputFile(RunUtils::writeInput(count, maxSize));
+    }
+    
+    // Заменяет входной файл готовым (файл удаляет фикстура) и заново получает fullOutput
+    void useInputFile(const string& filename) {
+        TestUtils::deleteFile(input);
+        input = filename;
+        CHECK(runClient(fullOutput));
+    }
+    
+    vector<string> args(const string& outputFile, const vector<string>& options = {}) const {
+        vector<string> result = RunUtils::clientArgs(server.getPort(), input, outputFile, conf);
+        result.insert(result.end(), options.begin(), options.end());
+        return result;
+    }
+    
+    bool runClient(const string& outputFile, const vector<string>& options = {}) const {
+        return RunUtils::runClient(args(outputFile, options));
+    }
+    
+    bool outputMatches() const {
+        return TestUtils::readFile(fullOutput) == TestUtils::readFile(output);
+    }
+};
+
+namespace ResultUtils {
+    // Векторы размерностей 3, 1, 4, 2
+    VectorStore sampleVectors() {
+        VectorStore vectors;
+        const uint32_t sizes[4] = {3, 1, 4, 2};
+        for (uint32_t size : sizes) {
+            double* values = vectors.append(size);
+            for (uint32_t j = 0; j < size; ++j) {
+                values[j] = size * 10.0 + j;
+            }
+        }
+        return vectors;
+    }
+    
+    // Значения, которые трудно записать кратко и точно, и случайные битовые образы
+    vector<double> trickyValues() {
+        vector<double> values = {
+            0.0, -0.0, 0.1, 1.0 / 3.0, -2.0 / 3.0, 1e23, 5e-324, 2.2250738585072014e-308,
+            1.7976931348623157e308, -1.7976931348623157e308, 123456789012345680.0, 9007199254740993.0,
+            HUGE_VAL, -HUGE_VAL,
+        };
+        uint64_t state = 0x9e3779b97f4a7c15ull;
+        while (values.size() < 10000) {
+            state = state * 6364136223846793005ull + 1442695040888963407ull;
+            double value;
+            memcpy(&value, &state, sizeof(value));
+            if (!std::isnan(value)) {
+                values.push_back(value);
+            }
+        }
+        return values;
+    }
+    
+    ResultHeader readHeader(const string& content) {
+        ResultHeader header;
+        memset(&header, 0, sizeof(header));
+        memcpy(&header, content.data(), min(content.size(), sizeof(header)));
+        return header;
+    }
+    
+    template <typename T>
+    T readAt(const string& content, uint64_t offset) {
+        T value;
+        memcpy(&value, content.data() + offset, sizeof(value));
+        return value;
+    }
+    
+    bool exists(const string& filename) {
+        return access(filename.c_str(), F_OK) == 0;
+    }
+}
+
+SUITE(ResultWriterTest)
+{
+    // Тест 1: Текстовые значения читаются обратно в те же числа double
+    TEST(TextRoundTrip)
+    {
+        const vector<double> values = ResultUtils::trickyValues();
+        string filename = TestUtils::createTempFile("");
+        CHECK(ResultWriter::writeText(filename, values.data(), values.size(), 1));
+        
+        const string content = TestUtils::readFile(filename);
+        CHECK(!content.empty() && content.back() == '\n');
+        istringstream text(content);
+        size_t count = 0;
+        text >> count;
+        CHECK_EQUAL(values.size(), count);
+        
+        size_t mismatches = 0;
+        for (size_t i = 0; i < values.size(); ++i) {
+            string token;
+            text >> token;
+            double parsed = 0.0;
+            const from_chars_result result = from_chars(token.data(), token.data() + token.size(), parsed);
+            if (result.ec != errc() || result.ptr != token.data() + token.size() ||
+                !ParserUtils::sameBits(values[i], parsed)) {
+                ++mismatches;
+            }
+        }
+        CHECK_EQUAL(0u, mismatches);
+        string rest;
+        CHECK(!(text >> rest));
+        TestUtils::deleteFile(filename);
+    }
+    
+    // Тест 2: Параллельное форматирование дает тот же файл, что и однопоточное
+    TEST(ParallelFormattingMatches)
+    {
+        // Больше трех участков FORMAT_CHUNK_MIN (64K результатов) и неровный хвост
+        vector<double> values;
+        const vector<double> tricky = ResultUtils::trickyValues();
+        while (values.size() < 3 * 64 * 1024 + 12345) {
+            values.push_back(tricky[values.size() % tricky.size()]);
+        }
+        string single = TestUtils::createTempFile("");
+        string parallel = TestUtils::createTempFile("");
+        CHECK(ResultWriter::writeText(single, values.data(), values.size(), 1));
+        for (size_t threads : {2u, 3u, 4u, 16u}) {
+            CHECK(ResultWriter::writeText(parallel, values.data(), values.size(), threads));
+            CHECK(TestUtils::readFile(single) == TestUtils::readFile(parallel));
+        }
+        
+        // Пустой набор: только количество и перевод строки
+        CHECK(ResultWriter::writeText(parallel, values.data(), 0, 4));
+        CHECK_EQUAL(string("0\n"), TestUtils::readFile(parallel));
+        TestUtils::deleteFile(single);
+        TestUtils::deleteFile(parallel);
+    }
+    
+    // Тест 3: Неудачная запись не трогает целевой файл и не оставляет временный
+    TEST(FailedWriteKeepsTarget)
+    {
+        const VectorStore vectors = ResultUtils::sampleVectors();
+        const vector<double> values(200000, 1.0 / 3.0);
+        string filename = TestUtils::createTempFile("старые результаты\n");
+        const string tempName = filename + ".tmp." + to_string(getpid());
+        
+        // Предел размера файла обрывает запись посередине (EFBIG)
+        struct rlimit oldLimit;
+        getrlimit(RLIMIT_FSIZE, &oldLimit);
+        struct rlimit limit = oldLimit;
+        limit.rlim_cur = 4096;
+        void (*oldHandler)(int) = signal(SIGXFSZ, SIG_IGN);
+        CHECK_EQUAL(0, setrlimit(RLIMIT_FSIZE, &limit));
+        const bool textWritten = ResultWriter::writeText(filename, values.data(), values.size(), 2);
+        const bool binaryWritten = ResultWriter::write(filename, ResultWriter::BINARY, vectors, values.data(),
+                                                       vectors.size(), 1);
+        setrlimit(RLIMIT_FSIZE, &oldLimit);
+        signal(SIGXFSZ, oldHandler);
+        
+        CHECK(!textWritten);
+        CHECK(binaryWritten);  // 64 + 4 * 8 байт помещаются в предел
+        CHECK(!ResultUtils::exists(tempName));
+        CHECK_EQUAL(sizeof(ResultHeader) + 4 * sizeof(double), TestUtils::readFile(filename).size());
+        
+        ofstream(filename, ios::trunc) << "старые результаты\n";
+        CHECK_EQUAL(0, setrlimit(RLIMIT_FSIZE, &limit));
+        oldHandler = signal(SIGXFSZ, SIG_IGN);
+        CHECK(!ResultWriter::writeText(filename, values.data(), values.size(), 1));
+        setrlimit(RLIMIT_FSIZE, &oldLimit);
+        signal(SIGXFSZ, oldHandler);
+        CHECK_EQUAL(string("старые результаты\n"), TestUtils::readFile(filename));
+        CHECK(!ResultUtils::exists(tempName));
+        
+        // Целевой файл на месте каталога: rename() не проходит
+        TestUtils::deleteFile(filename);
+        CHECK_EQUAL(0, mkdir(filename.c_str(), 0700));
+        CHECK(!ResultWriter::writeText(filename, values.data(), 10, 1));
+        CHECK(!ResultUtils::exists(tempName));
+        struct stat info;
+        CHECK(stat(filename.c_str(), &info) == 0 && S_ISDIR(info.st_mode));
+        rmdir(filename.c_str());
+    }
+    
+    // Тест 4: Заголовок и столбцы двоичного и столбцового форматов
+    TEST(BinaryLayout)
+    {
+        const VectorStore vectors = ResultUtils::sampleVectors();
+        const double values[4] = {0.5, -1.0 / 3.0, 1e300, -0.0};
+        string filename = TestUtils::createTempFile("");
+        uint64_t checksum = ResultWriter::CHECKSUM_SEED;
+        for (size_t i = 0; i < vectors.size(); ++i) {
+            checksum = ResultWriter::updateChecksum(checksum, vectors[i]);
+        }
+        
+        // Результаты есть только для первых трех векторов
+        const size_t count = 3;
+        for (ResultWriter::Format format : {ResultWriter::BINARY, ResultWriter::COLUMNAR}) {
+            CHECK(ResultWriter::write(filename, format, vectors, values, count, 1));
+            const string content = TestUtils::readFile(filename);
+            const ResultHeader header = ResultUtils::readHeader(content);
+            CHECK(memcmp(header.magic, "VRES", 4) == 0);
+            CHECK_EQUAL(1u, header.version);
+            CHECK_EQUAL(static_cast<uint32_t>(format), header.format);
+            CHECK_EQUAL(count, header.count);
+            CHECK_EQUAL(checksum, header.sourceChecksum);
+            CHECK_EQUAL(sizeof(ResultHeader), header.resultsOffset);
+            CHECK_EQUAL(0u, header.resultsOffset % alignof(double));
+            for (size_t i = 0; i < count; ++i) {
+                CHECK(ParserUtils::sameBits(values[i],
+                      ResultUtils::readAt<double>(content, header.resultsOffset + i * sizeof(double))));
+            }
+            
+            if (format == ResultWriter::BINARY) {
+                CHECK_EQUAL(0u, header.dimsOffset);
+                CHECK_EQUAL(0u, header.indexOffset);
+                CHECK_EQUAL(header.resultsOffset + count * sizeof(double), content.size());
+                continue;
+            }
+            CHECK_EQUAL(header.resultsOffset + count * sizeof(double), header.dimsOffset);
+            CHECK_EQUAL(header.dimsOffset + count * sizeof(uint32_t), header.indexOffset);
+            CHECK_EQUAL(0u, header.dimsOffset % alignof(uint32_t));
+            CHECK_EQUAL(0u, header.indexOffset % alignof(uint32_t));
+            CHECK_EQUAL(header.indexOffset + count * sizeof(uint32_t), content.size());
+            for (size_t i = 0; i < count; ++i) {
+                CHECK_EQUAL(vectors.dimension(i),
+                            ResultUtils::readAt<uint32_t>(content, header.dimsOffset + i * sizeof(uint32_t)));
+                CHECK_EQUAL(i, ResultUtils::readAt<uint32_t>(content, header.indexOffset + i * sizeof(uint32_t)));
+            }
+        }
+        
+        // Результатов больше, чем векторов
+        CHECK(!ResultWriter::write(filename, ResultWriter::BINARY, vectors, values, 5, 1));
+        TestUtils::deleteFile(filename);
+    }
+    
+    // Тест 5: Контрольная сумма одинакова для текстового и .vbin входа
+    TEST(ChecksumMatchesForVbinInput)
+    {
+        const string textInput = RunUtils::writeInput(50);
+        const string vbinInput = TestUtils::createTempFile("");
+        DataProcessor textProcessor;
+        CHECK(textProcessor.readVectorsFromFile(textInput));
+        CHECK(textProcessor.saveVectors(vbinInput, true));
+        DataProcessor vbinProcessor;
+        CHECK(vbinProcessor.readVectorsFromFile(vbinInput));
+        CHECK(vbinProcessor.getVectors().isMapped());
+        
+        const vector<double> results(50, 2.5);
+        const string textOutput = TestUtils::createTempFile("");
+        const string vbinOutput = TestUtils::createTempFile("");
+        textProcessor.setResultFormat(ResultWriter::COLUMNAR);
+        vbinProcessor.setResultFormat(ResultWriter::COLUMNAR);
+        CHECK(textProcessor.saveResults(textOutput, results));
+        CHECK(vbinProcessor.saveResults(vbinOutput, results));
+        
+        const ResultHeader header = ResultUtils::readHeader(TestUtils::readFile(textOutput));
+        CHECK_EQUAL(RunUtils::inputChecksum(textProcessor.getVectors()), header.sourceChecksum);
+        CHECK(header.sourceChecksum != ResultWriter::CHECKSUM_SEED);
+        CHECK(TestUtils::readFile(textOutput) == TestUtils::readFile(vbinOutput));
+        
+        TestUtils::deleteFile(textInput);
+        TestUtils::deleteFile(vbinInput);
+        TestUtils::deleteFile(textOutput);
+        TestUtils::deleteFile(vbinOutput);
+    }
+}
+
+SUITE(CheckpointJournalTest)
+{
+    // Тест 1: Неполная последняя запись отбрасывается и обрезается
+    TEST(TornTail)
+    {
+        // Предупреждение об отброшенном конце выводилось бы на каждой итерации
+        const LogLevel savedLevel = Logger::getLevel();
+        Logger::setLevel(LOG_LEVEL_ERROR);
+        string filename = TestUtils::createTempFile("");
+        const double results[5] = {1.0, 2.0, 3.0, 4.0, 5.0};
+        {
+            CheckpointJournal journal;
+            CHECK(journal.create(filename, 42, 10));
+            CHECK(journal.append(0, 3, results));
+            CHECK(journal.append(3, 2, results + 3));
+        }
+        const string full = TestUtils::readFile(filename);
+        const size_t firstRecord = sizeof(JournalHeader) + 2 * sizeof(uint64_t) + 3 * sizeof(double) + sizeof(uint64_t);
+        
+        // Обрыв на любом байте второй записи оставляет только первую
+        for (size_t cut = firstRecord; cut < full.size(); ++cut) {
+            ofstream(filename, ios::binary | ios::trunc) << full.substr(0, cut);
+            vector<double> loaded(10, 0.0);
+            vector<CheckpointJournal::Range> completed;
+            CheckpointJournal journal;
+            CHECK(journal.load(filename, 42, 10, loaded.data(), completed));
+            CHECK_EQUAL(1u, completed.size());
+            CHECK_EQUAL(0u, completed[0].begin);
+            CHECK_EQUAL(3u, completed[0].end);
+            CHECK_EQUAL(3.0, loaded[2]);
+            CHECK_EQUAL(0.0, loaded[3]);
+            CHECK_EQUAL(firstRecord, TestUtils::readFile(filename).size());
+        }
+        
+        // Испорченная контрольная сумма тоже завершает чтение
+        string corrupt = full;
+        corrupt[corrupt.size() - 1] ^= 1;
+        ofstream(filename, ios::binary | ios::trunc) << corrupt;
+        vector<double> loaded(10, 0.0);
+        vector<CheckpointJournal::Range> completed;
+        CheckpointJournal journal;
+        CHECK(journal.load(filename, 42, 10, loaded.data(), completed));
+        CHECK_EQUAL(1u, completed.size());
+        
+        // После обрезки новые записи дописываются следом
+        CHECK(journal.append(3, 2, results + 3));
+        journal.close();
+        CHECK(TestUtils::readFile(filename) == full);
+        
+        // Журнал других входных данных не принимается
+        CHECK(!journal.load(filename, 43, 10, loaded.data(), completed));
+        CHECK(!journal.load(filename, 42, 11, loaded.data(), completed));
+        TestUtils::deleteFile(filename);
+        Logger::setLevel(savedLevel);
+    }
+    
+    // Тест 2: Невыполненные диапазоны
+    TEST(PendingGaps)
+    {
+        typedef CheckpointJournal::Range Range;
+        vector<Range> gaps = CheckpointJournal::pending({}, 10);
+        CHECK_EQUAL(1u, gaps.size());
+        CHECK_EQUAL(0u, gaps[0].begin);
+        CHECK_EQUAL(10u, gaps[0].end);
+        
+        // Диапазоны в любом порядке, с пересечениями и вложенные
+        gaps = CheckpointJournal::pending({{5, 8}, {0, 2}, {1, 3}, {6, 7}}, 10);
+        CHECK_EQUAL(2u, gaps.size());
+        CHECK_EQUAL(3u, gaps[0].begin);
+        CHECK_EQUAL(5u, gaps[0].end);
+        CHECK_EQUAL(8u, gaps[1].begin);
+        CHECK_EQUAL(10u, gaps[1].end);
+        
+        // Смежные диапазоны покрывают все векторы
+        CHECK(CheckpointJournal::pending({{4, 10}, {0, 4}}, 10).empty());
+        CHECK(CheckpointJournal::pending({}, 0).empty());
+        
+        gaps = CheckpointJournal::pending({{0, 1}, {9, 10}}, 10);
+        CHECK_EQUAL(1u, gaps.size());
+        CHECK_EQUAL(1u, gaps[0].begin);
+        CHECK_EQUAL(9u, gaps[0].end);
+    }
+    
+    // Тест 3: Возобновленная работа дает тот же файл, что и непрерывная
+    TEST_FIXTURE(ServerFixture, ResumedRunMatches)
+    {
+        const string journalName = CheckpointJournal::pathFor(output);
+        
+        // Журнал прерванного запуска: две записи и недописанная третья
+        DataProcessor dataProcessor;
+        CHECK(dataProcessor.readVectorsFromFile(input));
+        const VectorStore& vectors = dataProcessor.getVectors();
+        vector<double> results(vectors.size());
+        for (size_t i = 0; i < vectors.size(); ++i) {
+            results[i] = ReferenceServer::processVector(vectors[i].data(), vectors[i].size());
+        }
+        {
+            CheckpointJournal journal;
+            CHECK(journal.create(journalName, RunUtils::inputChecksum(vectors), vectors.size()));
+            CHECK(journal.append(0, 20, results.data()));
+            CHECK(journal.append(35, 10, results.data() + 35));
+        }
+        ofstream(journalName, ios::binary | ios::app) << string(12, '\x7f');
+        
+        // Отправляются только векторы [20, 35) и [45, 60)
+        const uint64_t servedBefore = server.getVectorsServed();
+        CHECK(runClient(output, {"--resume"}));
+        CHECK_EQUAL(30u, server.getVectorsServed() - servedBefore);
+        CHECK(outputMatches());
+        CHECK(access(journalName.c_str(), F_OK) != 0);
+        
+        // Без --checkpoint журнал не создается
+        CHECK(runClient(output));
+        CHECK(access(journalName.c_str(), F_OK) != 0);
+    }
+}
+
+SUITE(ReconnectTest)
+{
+    // Тест 1: После разрыва отправляются только векторы без результатов
+    TEST_FIXTURE(ServerFixture, ResendOnlyUnanswered)
+    {
+        const uint64_t servedBefore = server.getVectorsServed();
+        const uint64_t reconnectsBefore = Metrics::get(Metrics::RECONNECTS);
+        server.dropAfterVectors(servedBefore + 25);
+        const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        CHECK(runClient(output, {"--retries", "3"}));
+        const double elapsedMs = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+        
+        CHECK(outputMatches());
+        CHECK_EQUAL(60u, server.getVectorsServed() - servedBefore);
+        CHECK_EQUAL(1u, Metrics::get(Metrics::RECONNECTS) - reconnectsBefore);
+        // Первая пауза - от половины до полной RECONNECT_BASE_DELAY_MS (100 мс)
+        CHECK(elapsedMs >= 50.0);
+    }
+    
+    // Тест 2: Разрыв при конвейерной отправке
+    TEST_FIXTURE(ServerFixture, PipelinedReconnect)
+    {
+        useInput(200);
+        server.dropAfterVectors(server.getVectorsServed() + 70);
+        CHECK(runClient(output, {"-w", "16"}));
+        CHECK(outputMatches());
+    }
+    
+    // Тест 3: Без попыток подключения результаты остаются в журнале для --resume
+    TEST_FIXTURE(ServerFixture, NoRetriesKeepsJournal)
+    {
+        const string journalName = CheckpointJournal::pathFor(output);
+        const uint64_t servedBefore = server.getVectorsServed();
+        server.dropAfterVectors(servedBefore + 25);
+        CHECK(!runClient(output, {"--checkpoint", "--retries", "0"}));
+        CHECK(access(journalName.c_str(), F_OK) == 0);
+        CHECK_EQUAL(25u, server.getVectorsServed() - servedBefore);
+        
+        CHECK(runClient(output, {"--checkpoint", "--retries", "0", "--resume"}));
+        CHECK_EQUAL(60u, server.getVectorsServed() - servedBefore);
+        CHECK(outputMatches());
+        CHECK(access(journalName.c_str(), F_OK) != 0);
+    }
+    
+    // Тест 4: Разрыв во время отправки не завершает процесс по SIGPIPE
+    // (тесты не игнорируют SIGPIPE, в отличие от main.cpp)
+    TEST_FIXTURE(ServerFixture, DropDuringSendNoSigpipe)
+    {
+        useInput(4000, 1000);
+        const vector<vector<string>> modes = {
+            {"-w", "4096", "--io", "blocking"},
+            {"-w", "4096", "--io", "uring"},
+            {"-w", "10000"},
+        };
+        for (const vector<string>& mode : modes) {
+            server.dropAfterVectors(server.getVectorsServed() + 100);
+            vector<string> options = mode;
+            options.push_back("--retries");
+            options.push_back("3");
+            CHECK(runClient(output, options));
+            CHECK(outputMatches());
+        }
+        
+        // Файл .vbin отправляется sendfile(), которому MSG_NOSIGNAL не передать
+        DataProcessor dataProcessor;
+        CHECK(dataProcessor.readVectorsFromFile(input));
+        TestUtils::deleteFile(input);
+        input = TestUtils::createTempFile("");
+        CHECK(dataProcessor.saveVectors(input, true));
+        server.dropAfterVectors(server.getVectorsServed() + 100);
+        CHECK(runClient(output, {"--retries", "3"}));
+        CHECK(outputMatches());
+    }
+    
+    // Тест 5: Неудачное подключение не оставляет открытых сокетов
+    TEST(FailedConnectClosesSocket)
+    {
+        ReferenceServer server("user", "pass");
+        CHECK(server.start(0));
+        const int port = server.getPort();
+        server.stop();
+        
+        const size_t before = RunUtils::openDescriptors();
+        for (int attempt = 0; attempt < 5; ++attempt) {
+            ServerConnection connection;
+            CHECK(!connection.establishConnection("127.0.0.1", port));
+            CHECK(!connection.establishConnection("not-an-address", port));
+        }
+        CHECK_EQUAL(before, RunUtils::openDescriptors());
+    }
+}
+
+SUITE(ProcessingModesTest)
+{
+    // Тест 1: Задержки ответа учитываются во всех режимах отправки
+    TEST_FIXTURE(ServerFixture, LatencyRecordedInAllModes)
+    {
+        const vector<vector<string>> modes = {
+            {}, {"-w", "8"}, {"-w", "8", "--io", "uring"}, {"-j", "3"}, {"-j", "3", "-w", "8"}, {"--stream"},
+        };
+        for (const vector<string>& mode : modes) {
+            const uint64_t before = Metrics::latencyCount();
+            CHECK(runClient(output, mode));
+            CHECK_EQUAL(60u, Metrics::latencyCount() - before);
+        }
+    }
+    
+    // Тест 2: Потоковый режим пишет тот же файл, что и обычный, во всех форматах
+    TEST_FIXTURE(ServerFixture, StreamMatchesNormalMode)
+    {
+        // Несколько пачек потокового режима (по 4096 векторов) и неполная последняя
+        useInput(10000, 9);
+        const string streamOutput = TestUtils::createTempFile("");
+        for (const char* format : {"text", "binary", "columnar"}) {
+            CHECK(runClient(output, {"-f", format}));
+            CHECK(runClient(streamOutput, {"-f", format, "--stream"}));
+            const string expected = TestUtils::readFile(output);
+            CHECK(!expected.empty());
+            CHECK(expected == TestUtils::readFile(streamOutput));
+        }
+        TestUtils::deleteFile(streamOutput);
+    }
+    
+    // Тест 3: Результаты -j N возвращаются в порядке входного файла
+    TEST_FIXTURE(ServerFixture, ShardsKeepInputOrder)
+    {
+        // Редкие длинные векторы делают участки равного объема неравными по числу векторов
+        ostringstream text;
+        text << 3001 << "\n";
+        for (size_t i = 0; i < 3001; ++i) {
+            const size_t size = i % 97 == 5 ? 1500 + i % 7 : 1 + i % 3;
+            text << size << "\n";
+            for (size_t j = 0; j < size; ++j) {
+                text << (j > 0 ? " " : "") << (static_cast<double>(i) - static_cast<double>(j) / 8.0);
+            }
+            text << "\n";
+        }
+        useInputFile(TestUtils::createTempFile(text.str()));
+        
+        DataProcessor dataProcessor;
+        CHECK(dataProcessor.readVectorsFromFile(input));
+        const vector<size_t> bounds = ShardedProcessor::splitByBytes(dataProcessor.getVectors(), 7);
+        CHECK_EQUAL(8u, bounds.size());
+        CHECK_EQUAL(0u, bounds.front());
+        CHECK_EQUAL(3001u, bounds.back());
+        CHECK(is_sorted(bounds.begin(), bounds.end()));
+        
+        const string columnarSingle = TestUtils::createTempFile("");
+        CHECK(runClient(columnarSingle, {"-j", "1", "-f", "columnar"}));
+        const vector<vector<string>> modes = {{"-j", "1"}, {"-j", "7"}, {"-j", "7", "-w", "16"}, {"-j", "2"}};
+        for (const vector<string>& mode : modes) {
+            CHECK(runClient(output, mode));
+            CHECK(outputMatches());
+        }
+        CHECK(runClient(output, {"-j", "7", "-f", "columnar"}));
+        CHECK(TestUtils::readFile(columnarSingle) == TestUtils::readFile(output));
+        TestUtils::deleteFile(columnarSingle);
+        
+        // Векторов меньше, чем соединений
+        useInput(3);
+        CHECK(runClient(output, {"-j", "7"}));
+        CHECK(outputMatches());
+    }
+    
+    // Тест 4: Синхронные обертки AsyncConnection
+    TEST_FIXTURE(ServerFixture, AsyncConnectionSyncWrappers)
+    {
+        DataProcessor dataProcessor;
+        CHECK(dataProcessor.readVectorsFromFile(input));
+        const VectorStore& vectors = dataProcessor.getVectors();
+        Scheduler scheduler;
+        
+        // Неверный пароль
+        {
+            AsyncConnection connection(scheduler);
+            CHECK(connection.connectSync("127.0.0.1", server.getPort()));
+            CHECK(!connection.authenticateSync("user", "wrong"));
+        }
+        
+        AsyncConnection connection(scheduler);
+        CHECK(connection.connectSync("127.0.0.1", server.getPort()));
+        CHECK(connection.authenticateSync("user", "pass"));
+        vector<double> results;
+        connection.setPipelineWindow(8);
+        CHECK(connection.processSync(vectors, results));
+        CHECK_EQUAL(vectors.size(), results.size());
+        size_t mismatches = 0;
+        for (size_t i = 0; i < vectors.size() && i < results.size(); ++i) {
+            const double expected = ReferenceServer::processVector(vectors[i].data(), vectors[i].size());
+            mismatches += ParserUtils::sameBits(expected, results[i]) ? 0 : 1;
+        }
+        CHECK_EQUAL(0u, mismatches);
+        
+        // Второе задание в той же сессии
+        CHECK(connection.processSync(vectors, results));
+        CHECK_EQUAL(vectors.size(), results.size());
+        connection.closeConnection();
+        
+        // Сервер не слушает порт
+        const int port = server.getPort();
+        server.stop();
+        AsyncConnection refused(scheduler);
+        CHECK(!refused.connectSync("127.0.0.1", port));
+    }
+    
+    // Тест 5: Окно конвейера и механизм ввода-вывода не меняют результат
+    TEST_FIXTURE(ServerFixture, WindowModesMatch)
+    {
+        useInput(3000, 700);
+        const vector<vector<string>> modes = {
+            {"-w", "1"}, {"-w", "64", "--io", "blocking"}, {"-w", "64", "--io", "uring"},
+        };
+        for (const vector<string>& mode : modes) {
+            CHECK(runClient(output, mode));
+            CHECK(outputMatches());
+        }
+    }
+    
+    // Тест 6: Частичная отправка, закончившаяся внутри поля размера и внутри данных
+    TEST(AdvanceIovPartialSends)
+    {
+        uint32_t sizes[2] = {3, 2};
+        double first[3] = {1.0, 2.0, 3.0};
+        double second[2] = {4.0, 5.0};
+        struct iovec vectors[4] = {
+            {&sizes[0], sizeof(uint32_t)}, {first, sizeof(first)},
+            {&sizes[1], sizeof(uint32_t)}, {second, sizeof(second)},
+        };
+        struct iovec* iov = vectors;
+        size_t count = 4;
+        
+        // Внутри поля размера первого вектора
+        ServerConnection::advanceIov(iov, count, 2);
+        CHECK_EQUAL(4u, count);
+        CHECK(iov == &vectors[0]);
+        CHECK(iov->iov_base == reinterpret_cast<char*>(&sizes[0]) + 2);
+        CHECK_EQUAL(2u, iov->iov_len);
+        
+        // Остаток поля размера и 11 байтов данных первого вектора
+        ServerConnection::advanceIov(iov, count, 2 + 11);
+        CHECK_EQUAL(3u, count);
+        CHECK(iov == &vectors[1]);
+        CHECK(iov->iov_base == reinterpret_cast<char*>(first) + 11);
+        CHECK_EQUAL(sizeof(first) - 11, iov->iov_len);
+        
+        // Остаток данных и 3 байта поля размера второго вектора
+        ServerConnection::advanceIov(iov, count, sizeof(first) - 11 + 3);
+        CHECK_EQUAL(2u, count);
+        CHECK(iov == &vectors[2]);
+        CHECK(iov->iov_base == reinterpret_cast<char*>(&sizes[1]) + 3);
+        CHECK_EQUAL(1u, iov->iov_len);
+        
+        // Ровно до границы описателей: частично отправленных не остается
+        ServerConnection::advanceIov(iov, count, 1);
+        CHECK_EQUAL(1u, count);
+        CHECK(iov == &vectors[3]);
+        CHECK(iov->iov_base == second);
+        CHECK_EQUAL(sizeof(second), iov->iov_len);
+        
+        ServerConnection::advanceIov(iov, count, sizeof(second));
+        CHECK_EQUAL(0u, count);
+    }
+}
+
+namespace BatchUtils {
+    // Читает манифест из строки; errors - сообщения об ошибках
+    bool readManifest(const string& content, vector<BatchJob>& jobs, string& errors) {
+        const string filename = TestUtils::createTempFile(content);
+        bool ok = false;
+        errors = TestUtils::captureOutput(STDERR_FILENO, [&]() {
+            ok = BatchProcessor::readManifest(filename, jobs);
+        });
+        TestUtils::deleteFile(filename);
+        return ok;
+    }
+    
+    size_t countOf(const string& text, const string& pattern) {
+        size_t count = 0;
+        for (size_t pos = text.find(pattern); pos != string::npos; pos = text.find(pattern, pos + 1)) {
+            ++count;
+        }
+        return count;
+    }
+}
+
+SUITE(BatchProcessorTest)
+{
+    // Тест 1: Комментарии и пустые строки пропускаются, номера строк сохраняются
+    TEST(ManifestCommentsAndBlankLines)
+    {
+        vector<BatchJob> jobs;
+        string errors;
+        CHECK(BatchUtils::readManifest("# пакет\n\n  in1.txt   out1.txt\n\t \n  # a b c\nin2.vbin out2.bin\n",
+                                       jobs, errors));
+        CHECK_EQUAL(2u, jobs.size());
+        CHECK_EQUAL(string("in1.txt"), jobs[0].inputFileName);
+        CHECK_EQUAL(string("out1.txt"), jobs[0].outputFileName);
+        CHECK_EQUAL(3u, jobs[0].line);
+        CHECK_EQUAL(string("in2.vbin"), jobs[1].inputFileName);
+        CHECK_EQUAL(string("out2.bin"), jobs[1].outputFileName);
+        CHECK_EQUAL(6u, jobs[1].line);
+        CHECK(errors.empty());
+        
+        // Последняя строка без перевода строки
+        CHECK(BatchUtils::readManifest("a b\nc d", jobs, errors));
+        CHECK_EQUAL(2u, jobs.size());
+        CHECK_EQUAL(string("d"), jobs[1].outputFileName);
+    }
+    
+    // Тест 2: Строка не из двух полей отклоняется с ее номером
+    TEST(ManifestFieldCount)
+    {
+        vector<BatchJob> jobs;
+        string errors;
+        CHECK(!BatchUtils::readManifest("# пакет\nin1 out1\n\nin2 out2 extra\nin3 out3\n", jobs, errors));
+        CHECK(errors.find("строка 4:") != string::npos);
+        
+        CHECK(!BatchUtils::readManifest("in1 out1\nin2\n", jobs, errors));
+        CHECK(errors.find("строка 2:") != string::npos);
+    }
+    
+    // Тест 3: Манифест без заданий и отсутствующий манифест
+    TEST(EmptyManifest)
+    {
+        vector<BatchJob> jobs;
+        string errors;
+        CHECK(!BatchUtils::readManifest("", jobs, errors));
+        CHECK(errors.find("не содержит заданий") != string::npos);
+        CHECK(!BatchUtils::readManifest("# только комментарий\n\n   \n", jobs, errors));
+        CHECK(errors.find("не содержит заданий") != string::npos);
+        
+        errors = TestUtils::captureOutput(STDERR_FILENO, [&]() {
+            CHECK(!BatchProcessor::readManifest("/nonexistent/manifest.txt", jobs));
+        });
+        CHECK(errors.find("Не удалось открыть манифест") != string::npos);
+    }
+    
+    // Тест 4: После потери соединения оставшиеся задания пропускаются
+    TEST_FIXTURE(ServerFixture, SkipsJobsAfterConnectionLoss)
+    {
+        ServerConnection connection;
+        CHECK(connection.establishConnection("127.0.0.1", server.getPort()));
+        CHECK(connection.authenticate("user", "pass"));
+        
+        // Задание с ошибкой чтения не прерывает пакет, обрыв в третьем - прерывает
+        vector<string> outputs;
+        for (int i = 0; i < 4; ++i) {
+            outputs.push_back(TestUtils::createTempFile(""));
+            TestUtils::deleteFile(outputs.back());
+        }
+        const vector<BatchJob> jobs = {
+            {"/nonexistent/input.txt", outputs[0], 1},
+            {input, output, 2},
+            {input, outputs[1], 3},
+            {input, outputs[2], 4},
+            {input, outputs[3], 5},
+        };
+        server.dropAfterVectors(server.getVectorsServed() + 60 + 10);
+        
+        BatchProcessor batch(connection, false, 1);
+        Logger::setLevel(LOG_LEVEL_INFO);  // Итоги заданий - сообщения хода работы
+        bool ok = true;
+        const string log = TestUtils::captureOutput(STDOUT_FILENO, [&]() {
+            TestUtils::captureOutput(STDERR_FILENO, [&]() {
+                ok = batch.run(jobs);
+            });
+        });
+        CHECK(!ok);
+        CHECK(outputMatches());
+        for (const string& name : outputs) {
+            CHECK(access(name.c_str(), F_OK) != 0);
+        }
+        CHECK_EQUAL(2u, BatchUtils::countOf(log, "ПРОПУЩЕНО"));
+        CHECK(log.find("Задание 4/5 (строка 4)") != string::npos);
+        CHECK(log.find("успешно 1, с ошибками 2, пропущено 2") != string::npos);
+    }
+}
+
 int main()
 {
     // Отключаем вывод в cout для чистоты тестов
@@ -10,11 +10,51 @@
 
 #include "DataProcessor.h"
 #include "ErrorHandler.h"
+#include "Logger.h"
+#include "MappedFile.h"
+#include "TextParser.h"
+#include "VbinFormat.h"
+#include "ResultWriter.h"
+#include "Metrics.h"
+#include "Tracer.h"
 #include <fstream>
 #include <sstream>
-#include <iostream>
 #include <cstring>
 #include <cstdint>
+#include <cstdio>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+
+/**
+ * @brief Минимальный размер файла для параллельного разбора (1 МБ)
+ */
+static const size_t PARALLEL_PARSE_MIN_BYTES = 1 << 20;
+
+/**
+ * @brief Конструктор класса DataProcessor
+ * @details Разбор входного файла по умолчанию выполняется в одном потоке
+ */
+DataProcessor::DataProcessor() : parseThreads(1), resultFormat(ResultWriter::TEXT) {}
+
+/**
+ * @brief Задает количество потоков разбора входного файла
+ * @param [in] threads Количество потоков (0 - по числу ядер процессора)
+ */
+void DataProcessor::setParseThreads(size_t threads) {
+    if (threads == 0) {
+        threads = std::thread::hardware_concurrency();
+    }
+    parseThreads = threads > 0 ? threads : 1;
+}
+
+/**
+ * @brief Задает формат файла результатов
+ * @param [in] format Формат
+ */
+void DataProcessor::setResultFormat(ResultWriter::Format format) {
+    resultFormat = format;
+}
 
 /**
  * @brief Читает векторы из файла
@@ -25,54 +65,202 @@
  * 2. Для каждого вектора:
  *    a. Размер вектора (size_t)
  *    b. Значения вектора (double), разделенные пробелами
- * @warning При ошибке чтения вызывает exitWithError
+ * 
+ * Файл отображается в память (MappedFile) и разбирается TextParser без
+ * промежуточных буферов и без учета локали. Файлы от 1 МБ при нескольких
+ * потоках разбора обрабатываются parseParallel().
+ * 
+ * Файлы .vbin (см. VbinFormat) определяются по сигнатуре и отображаются
+ * в память без разбора.
+ * @warning При ошибке выводит сообщение с номером строки и столбца
  */
 bool DataProcessor::readVectorsFromFile(const std::string& filename) {
-    std::ifstream file(filename);
-    if (!file.is_open()) {
-        ErrorHandler::exitWithError("Не удалось открыть файл: " + filename);
+    PhaseTimer timer(Metrics::PARSE);
+    if (VbinFormat::isVbinFile(filename)) {
+        if (!VbinFormat::load(filename, vectors)) {
+            return false;
+        }
+        LOG_DEBUG("Отображен файл .vbin " << filename << " без разбора");
+        return true;
+    }
+    
+    MappedFile file;
+    if (!file.open(filename)) {
         return false;
     }
-
-    size_t numVectors;
-    file >> numVectors;
     
-    if (!file || numVectors == 0) {
-        ErrorHandler::exitWithError("Ошибка чтения количества векторов из файла: " + filename);
+    TextParser parser(file.data(), file.size());
+    
+    uint64_t numVectors;
+    if (!parser.parseCount(numVectors) || numVectors == 0) {
+        ErrorHandler::logError("Ошибка чтения количества векторов из файла " + filename +
+                               " (" + parser.describePosition() + ")");
         return false;
     }
-
+    
     vectors.clear();
-    vectors.reserve(numVectors);
-
-    for (size_t i = 0; i < numVectors; ++i) {
-        size_t vectorSize;
-        file >> vectorSize;
-        
-        if (!file || vectorSize == 0) {
-            ErrorHandler::exitWithError("Ошибка чтения размера вектора " + std::to_string(i+1));
+    Metrics::add(Metrics::BYTES_PARSED, file.size());
+    // Каждый вектор занимает в файле минимум 4 байта: не доверяем заголовку больше
+    vectors.reserve(std::min<uint64_t>(numVectors, file.size() / 4 + 1), 0);
+    
+    if (parseThreads > 1 && file.size() >= PARALLEL_PARSE_MIN_BYTES) {
+        if (!parseParallel(file, parser, numVectors)) {
+            return false;
+        }
+        LOG_DEBUG("Разобрано " << file.size() << " байт из файла " << filename
+                  << " в " << parseThreads << " потоков");
+        return true;
+    }
+    
+    for (uint64_t i = 0; i < numVectors; ++i) {
+        uint64_t vectorSize;
+        if (!parser.parseCount(vectorSize) || vectorSize == 0 || vectorSize > UINT32_MAX) {
+            ErrorHandler::logError("Ошибка чтения размера вектора " + std::to_string(i + 1) +
+                                   " (" + parser.describePosition() + ")");
             return false;
         }
-
-        std::vector<double> vec;
-        vec.reserve(vectorSize);
         
-        for (size_t j = 0; j < vectorSize; ++j) {
-            double value;
-            file >> value;
-            if (!file) {
-                ErrorHandler::exitWithError("Ошибка чтения значения вектора " + std::to_string(i+1));
+        double* values = vectors.append(static_cast<uint32_t>(vectorSize));
+        
+        for (uint64_t j = 0; j < vectorSize; ++j) {
+            if (!parser.parseDouble(values[j])) {
+                ErrorHandler::logError("Ошибка чтения значения вектора " + std::to_string(i + 1) +
+                                       " (" + parser.describePosition() + ")");
                 return false;
             }
-            vec.push_back(value);
+        }
+    }
+    
+    LOG_DEBUG("Разобрано " << file.size() << " байт из файла " << filename);
+    return true;
+}
+
+/**
+ * @brief Разбирает векторы входного файла в несколько потоков
+ * @param [in] file Отображенный в память входной файл
+ * @param [in,out] parser Разборщик, остановленный после количества векторов
+ * @param [in] numVectors Количество векторов из заголовка файла
+ * @return true если разбор успешен, false в случае ошибки
+ * @details Алгоритм:
+ * 1. Последовательный проход: читает размер каждого вектора и пропускает
+ *    его значения без преобразования. Размеры сразу добавляются в хранилище,
+ *    каждые ~size/(потоки*4) байт запоминается начало участка.
+ * 2. Хранилище выделяет память под все значения одним блоком.
+ * 3. Пул потоков разбирает участки, записывая значения на их места,
+ *    поэтому порядок векторов сохраняется.
+ * 
+ * Сообщается ошибка с наименьшим номером вектора, как при последовательном
+ * разборе: если первый проход остановился на векторе k, второй проход все
+ * равно проверяет значения векторов до k.
+ */
+bool DataProcessor::parseParallel(const MappedFile& file, TextParser& parser, uint64_t numVectors) {
+    // Участок: номер первого вектора и смещение его размера в файле
+    struct Chunk {
+        size_t firstVector;
+        size_t offset;
+    };
+    std::vector<Chunk> chunks;
+    const size_t chunkBytes = file.size() / (parseThreads * 4) + 1;
+    size_t nextBoundary = 0;
+    
+    // 1. Поиск границ векторов
+    std::string structureError;
+    const uint64_t scanStart = Tracer::isEnabled() ? Tracer::now() : 0;
+    for (uint64_t i = 0; i < numVectors; ++i) {
+        if (parser.offset() >= nextBoundary) {
+            Chunk chunk = { static_cast<size_t>(i), parser.offset() };
+            chunks.push_back(chunk);
+            nextBoundary = parser.offset() + chunkBytes;
         }
         
-        vectors.push_back(vec);
+        uint64_t vectorSize;
+        if (!parser.parseCount(vectorSize) || vectorSize == 0 || vectorSize > UINT32_MAX) {
+            structureError = "Ошибка чтения размера вектора " + std::to_string(i + 1) +
+                             " (" + parser.describePosition() + ")";
+            break;
+        }
+        
+        uint64_t j = 0;
+        while (j < vectorSize && parser.skipToken()) {
+            ++j;
+        }
+        if (j < vectorSize) {
+            structureError = "Ошибка чтения значения вектора " + std::to_string(i + 1) +
+                             " (" + parser.describePosition() + ")";
+            // Вектор без значений не разбирается вторым проходом
+            break;
+        }
         
-        std::cout << "Отладка: Вектор " << i << ", размер " << vectorSize << std::endl;
+        vectors.appendShape(static_cast<uint32_t>(vectorSize));
     }
-
-    file.close();
+    if (Tracer::isEnabled()) {
+        Tracer::span("scan_structure", "file", scanStart, Tracer::now());
+    }
+    
+    // 2. Выделение памяти под значения
+    vectors.allocateValues();
+    const size_t parsedVectors = vectors.size();
+    
+    // 3. Разбор значений участками
+    std::vector<std::string> errors(chunks.size());
+    std::atomic<size_t> nextChunk(0);
+    std::atomic<size_t> firstFailedChunk(chunks.size());
+    
+    auto worker = [&]() {
+        TextParser local(file.data(), file.size());
+        size_t c;
+        while ((c = nextChunk++) < chunks.size()) {
+            if (c > firstFailedChunk) {
+                continue;  // Ошибка уже найдена раньше
+            }
+            
+            size_t first = chunks[c].firstVector;
+            size_t last = c + 1 < chunks.size() ? chunks[c + 1].firstVector : parsedVectors;
+            TraceSpan span("parse_chunk", "file", first, last - first);
+            local.seek(chunks[c].offset);
+            
+            for (size_t i = first; i < last && errors[c].empty(); ++i) {
+                uint64_t vectorSize;
+                local.parseCount(vectorSize);  // Проверен первым проходом
+                double* values = vectors.mutableData(i);
+                for (uint64_t j = 0; j < vectorSize; ++j) {
+                    if (!local.parseDouble(values[j])) {
+                        errors[c] = "Ошибка чтения значения вектора " + std::to_string(i + 1) +
+                                    " (" + local.describePosition() + ")";
+                        break;
+                    }
+                }
+            }
+            
+            if (!errors[c].empty()) {
+                size_t expected = firstFailedChunk;
+                while (c < expected && !firstFailedChunk.compare_exchange_weak(expected, c)) {
+                }
+            }
+        }
+    };
+    
+    std::vector<std::thread> pool;
+    for (size_t t = 1; t < parseThreads; ++t) {
+        pool.emplace_back([&]() {
+            Tracer::nameThread("parse");
+            worker();
+        });
+    }
+    worker();
+    for (auto& thread : pool) {
+        thread.join();
+    }
+    
+    if (firstFailedChunk < chunks.size()) {
+        ErrorHandler::logError(errors[firstFailedChunk]);
+        return false;
+    }
+    if (!structureError.empty()) {
+        ErrorHandler::logError(structureError);
+        return false;
+    }
+    
     return true;
 }
 
@@ -85,13 +273,14 @@ bool DataProcessor::readVectorsFromFile(const std::string& filename) {
  * @note Не проверяет числовые значения на корректность (NaN, Inf)
  */
 bool DataProcessor::validateData() const {
+    PhaseTimer timer(Metrics::VALIDATE);
     if (vectors.empty()) {
         ErrorHandler::logError("Нет векторов для обработки");
         return false;
     }
     
-    for (const auto& vec : vectors) {
-        if (vec.empty()) {
+    for (size_t i = 0; i < vectors.size(); ++i) {
+        if (vectors.dimension(i) == 0) {
             ErrorHandler::logError("Обнаружен пустой вектор");
             return false;
         }
@@ -109,37 +298,28 @@ bool DataProcessor::validateData() const {
  *    a. uint32_t - размер вектора (little-endian)
  *    b. double[] - значения вектора (little-endian)
  * @note Все числа сохраняются в формате little-endian
+ * @note Буфер выделяется один раз, значения векторов копируются блоками
  */
 std::vector<char> DataProcessor::convertToBinary() const {
-    std::vector<char> binaryData;
-    
-    std::cout << "Отладка: Отправляем " << vectors.size() << " векторов" << std::endl;
+    // Размер буфера известен заранее: выделяем его один раз
+    std::vector<char> binaryData(sizeof(uint32_t) + vectors.wireBytes(0, vectors.size()));
+    char* out = binaryData.data();
     
     // Количество векторов
     uint32_t numVectors = static_cast<uint32_t>(vectors.size());
-    char* numVectorsPtr = reinterpret_cast<char*>(&numVectors);
-    binaryData.insert(binaryData.end(), numVectorsPtr, numVectorsPtr + sizeof(uint32_t));
+    memcpy(out, &numVectors, sizeof(numVectors));
+    out += sizeof(numVectors);
     
-    // Каждый вектор
+    // Каждый вектор: размер и значения
     for (size_t i = 0; i < vectors.size(); ++i) {
-        const auto& vec = vectors[i];
-        
-        // Размер вектора
-        uint32_t vecSize = static_cast<uint32_t>(vec.size());
-        char* vecSizePtr = reinterpret_cast<char*>(&vecSize);
-        binaryData.insert(binaryData.end(), vecSizePtr, vecSizePtr + sizeof(uint32_t));
-        
-        std::cout << "Отладка: Вектор " << i << " имеет " << vec.size() << " элементов" << std::endl;
-        
-        // Значения вектора
-        for (size_t j = 0; j < vec.size(); ++j) {
-            double value = vec[j];
-            char* valuePtr = reinterpret_cast<char*>(&value);
-            binaryData.insert(binaryData.end(), valuePtr, valuePtr + sizeof(double));
-        }
+        VectorView vec = vectors[i];
+        memcpy(out, vec.sizeField(), sizeof(uint32_t));
+        out += sizeof(uint32_t);
+        memcpy(out, vec.data(), vec.byteSize());
+        out += vec.byteSize();
     }
     
-    std::cout << "Отладка: Всего байт для отправки: " << binaryData.size() << std::endl;
+    LOG_DEBUG("Всего байт для отправки: " << binaryData.size());
     
     return binaryData;
 }
@@ -149,32 +329,52 @@ std::vector<char> DataProcessor::convertToBinary() const {
  * @param [in] filename Имя файла для сохранения
  * @param [in] results Результаты обработки от сервера
  * @return true если сохранение успешно, false в случае ошибки
- * @details Формат файла результатов:
+ * @details Текстовый формат файла результатов:
  * 1. Количество результатов (size_t)
  * 2. Значения результатов (double), разделенные пробелами
+ * 
+ * Значения записываются кратчайшим точным представлением и форматируются
+ * в parseThreads потоков; файл публикуется атомарно (см. ResultWriter).
+ * Форматы BINARY и COLUMNAR (setResultFormat()) записываются без
+ * форматирования, в заголовок попадает контрольная сумма векторов.
  */
 bool DataProcessor::saveResults(const std::string& filename, const std::vector<double>& results) const {
-    std::ofstream file(filename);
-    if (!file.is_open()) {
-        ErrorHandler::logError("Не удалось открыть файл для записи результатов: " + filename);
-        return false;
+    PhaseTimer timer(Metrics::SAVE);
+    return ResultWriter::write(filename, resultFormat, vectors, results.data(), results.size(), parseThreads);
+}
+
+/**
+ * @brief Сохраняет векторы в файл
+ * @param [in] filename Имя файла для сохранения
+ * @param [in] binary true - формат .vbin с индексом, false - текстовый формат
+ * @return true если сохранение успешно, false в случае ошибки
+ * @details Текстовый формат совпадает с форматом readVectorsFromFile():
+ * количество векторов, затем для каждого вектора размер и значения на
+ * отдельных строках. Значения записываются с 17 значащими цифрами, чтобы
+ * обратное преобразование было точным.
+ */
+bool DataProcessor::saveVectors(const std::string& filename, bool binary) const {
+    if (binary) {
+        return VbinFormat::write(vectors, filename, true);
     }
     
-    // Количество результатов
-    file << results.size() << " ";
+    FILE* file = fopen(filename.c_str(), "w");
+    if (!file) {
+        ErrorHandler::logError("Не удалось открыть файл для записи: " + filename);
+        return false;
+    }
     
-    // Сами результаты
-    for (size_t i = 0; i < results.size(); ++i) {
-        file << results[i];
-        if (i != results.size() - 1) {
-            file << " ";
+    fprintf(file, "%zu\n", vectors.size());
+    for (size_t i = 0; i < vectors.size(); ++i) {
+        VectorView vec = vectors[i];
+        fprintf(file, "%u\n", vec.size());
+        for (uint32_t j = 0; j < vec.size(); ++j) {
+            fprintf(file, j == 0 ? "%.17g" : " %.17g", vec[j]);
         }
+        fputc('\n', file);
     }
     
-    file << std::endl;
-    file.close();
-    
-    if (!file) {
+    if (fclose(file) != 0) {
         ErrorHandler::logError("Ошибка записи в файл: " + filename);
         return false;
     }
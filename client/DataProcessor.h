@@ -1,9 +1,14 @@
 #ifndef DATAPROCESSOR_H
 #define DATAPROCESSOR_H
 
+#include "VectorStore.h"
+#include "ResultWriter.h"
 #include <string>
 #include <vector>
 
+class MappedFile;
+class TextParser;
+
 /**
  * @brief Класс для обработки данных (векторов)
  * @details Предоставляет функциональность для чтения векторов из файла,
@@ -14,15 +19,51 @@
  */
 class DataProcessor {
 private:
-    std::vector<std::vector<double>> vectors;  ///< Коллекция векторов для обработки
+    VectorStore vectors;  ///< Коллекция векторов для обработки
+    size_t parseThreads;  ///< Количество потоков разбора входного файла и записи результатов
+    ResultWriter::Format resultFormat;  ///< Формат файла результатов
+    
+    /**
+     * @brief Разбирает векторы входного файла в несколько потоков
+     * @param [in] file Отображенный в память входной файл
+     * @param [in,out] parser Разборщик, остановленный после количества векторов
+     * @param [in] numVectors Количество векторов из заголовка файла
+     * @return true если разбор успешен, false в случае ошибки
+     * @details Первый проход находит границы векторов по их размерам, не
+     * преобразуя значения. Затем файл делится на участки, которые разбираются
+     * пулом потоков прямо в заранее выделенную память хранилища.
+     */
+    bool parseParallel(const MappedFile& file, TextParser& parser, uint64_t numVectors);
     
 public:
+    /**
+     * @brief Конструктор класса DataProcessor
+     * @details Разбор входного файла по умолчанию выполняется в одном потоке
+     */
+    DataProcessor();
+    
+    /**
+     * @brief Задает количество потоков разбора входного файла
+     * @details Те же потоки форматируют большие наборы результатов в saveResults()
+     * @param [in] threads Количество потоков (0 - по числу ядер процессора)
+     */
+    void setParseThreads(size_t threads);
+    
+    /**
+     * @brief Задает формат файла результатов
+     * @param [in] format Формат (по умолчанию ResultWriter::TEXT)
+     */
+    void setResultFormat(ResultWriter::Format format);
+    
     /**
      * @brief Читает векторы из файла
      * @param [in] filename Имя файла с данными
      * @return true если чтение успешно, false в случае ошибки
      * @details Ожидает формат файла, где каждый вектор представлен
      * на отдельной строке, а числа разделены пробелами.
+     * Файл отображается в память и разбирается без учета локали;
+     * сообщения об ошибках содержат номер строки и столбца.
+     * Файлы .vbin отображаются в память без разбора.
      */
     bool readVectorsFromFile(const std::string& filename);
     
@@ -51,11 +92,19 @@ public:
      */
     bool saveResults(const std::string& filename, const std::vector<double>& results) const;
     
+    /**
+     * @brief Сохраняет векторы в файл
+     * @param [in] filename Имя файла для сохранения
+     * @param [in] binary true - формат .vbin, false - текстовый формат
+     * @return true если сохранение успешно, false в случае ошибки
+     */
+    bool saveVectors(const std::string& filename, bool binary) const;
+    
     /**
      * @brief Возвращает константную ссылку на векторы
-     * @return Константная ссылка на коллекцию векторов
+     * @return Константная ссылка на непрерывное хранилище векторов
      */
-    const std::vector<std::vector<double>>& getVectors() const { return vectors; }
+    const VectorStore& getVectors() const { return vectors; }
     
     /**
      * @brief Возвращает количество векторов
@@ -8,28 +8,30 @@
  */
 
 #include "ErrorHandler.h"
+#include "Logger.h"
 #include <iostream>
 #include <cstdlib>
 
 /**
  * @brief Логирует сообщение об ошибке
  * @param [in] message Текст сообщения об ошибке
- * @details Выводит сообщение об ошибке в стандартный поток ошибок (stderr)
- * с префиксом "[ОШИБКА]".
+ * @details Передает сообщение в журнал (Logger) с уровнем LOG_LEVEL_ERROR;
+ * журнал выводит его в стандартный поток ошибок (stderr) с префиксом "[ОШИБКА]".
  */
 void ErrorHandler::logError(const std::string& message) {
-    std::cerr << "[ОШИБКА] " << message << std::endl;
+    Logger::write(LOG_LEVEL_ERROR, message);
 }
 
 /**
  * @brief Выводит сообщение об ошибке и завершает программу
  * @param [in] message Текст сообщения об ошибке
- * @details Вызывает logError() для вывода сообщения, затем завершает программу
- * с кодом возврата EXIT_FAILURE.
+ * @details Вызывает logError() для вывода сообщения, дожидается вывода журнала,
+ * затем завершает программу с кодом возврата EXIT_FAILURE.
  * @warning Приводит к немедленному завершению программы!
  */
 void ErrorHandler::exitWithError(const std::string& message) {
     logError(message);
+    Logger::flush();
     std::exit(EXIT_FAILURE);
 }
 
@@ -39,9 +41,32 @@ void ErrorHandler::exitWithError(const std::string& message) {
  * командной строки и доступных опциях клиентского приложения.
  */
 void ErrorHandler::printHelp() {
+    Logger::flush();
     std::cout << "Использование: ./client <адрес_сервера> <входной_файл> <выходной_файл> [опции]\n";
+    std::cout << "               ./client convert <источник> <приемник> [опции]\n";
+    std::cout << "               ./client batch <адрес_сервера> <манифест> [опции]\n";
+    std::cout << "Входной файл - текстовый или .vbin (определяется по содержимому).\n";
+    std::cout << "convert преобразует текстовый файл в .vbin и обратно.\n";
+    std::cout << "batch выполняет задания манифеста (строки '<входной_файл> <выходной_файл>') в одной сессии.\n";
     std::cout << "Опции:\n";
     std::cout << "  -p <порт>          Порт сервера (по умолчанию: 33333)\n";
     std::cout << "  -c <файл_конфига>  Файл с логином и паролем (по умолчанию: ~/.config/velient.conf)\n";
+    std::cout << "  -w <окно>          Число векторов, отправляемых без ожидания ответа (по умолчанию: 1)\n";
+    std::cout << "  --stream           Потоковая обработка с ограниченным расходом памяти\n";
+    std::cout << "  -t <потоки>        Потоки разбора входного файла (по умолчанию: по числу ядер)\n";
+    std::cout << "  -j <соединения>    Количество параллельных соединений с сервером (по умолчанию: 1)\n";
+    std::cout << "  --io <механизм>    Ввод-вывод: auto, uring, blocking (по умолчанию: auto)\n";
+    std::cout << "  -f <формат>        Формат результатов: text, binary, columnar (по умолчанию: text)\n";
+    if (LOG_MIN_LEVEL <= LOG_LEVEL_DEBUG) {
+        std::cout << "  -v                 Подробный журнал с отладочными сообщениями\n";
+    }
+    std::cout << "  -q                 Выводить только ошибки\n";
+    std::cout << "  --metrics=<файл>   Записать время этапов и счетчики (JSON; *.prom - формат Prometheus)\n";
+    std::cout << "  --trace=<файл>     Записать временную шкалу в формате Chrome trace events (Perfetto)\n";
+    std::cout << "  --profile          Вывести такты, инструкции, IPC и промахи по этапам (perf_event_open)\n";
+    std::cout << "  --memory           Вывести выделения памяти и размер процесса по этапам\n";
+    std::cout << "  --checkpoint       Вести журнал выполненных векторов <выходной_файл>.journal\n";
+    std::cout << "  --resume           Продолжить прерванную обработку по журналу (включает --checkpoint)\n";
+    std::cout << "  --retries <n>      Попыток повторного подключения после разрыва (по умолчанию: 5)\n";
     std::cout << "  -h                 Показать эту справку\n";
 }
@@ -0,0 +1,115 @@
+/**
+ * @file EventLoop.cpp
+ * @brief Реализация класса EventLoop
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+
+#include "EventLoop.h"
+#include "ErrorHandler.h"
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <errno.h>
+
+/**
+ * @brief Максимальное число событий, получаемых одним вызовом epoll_wait
+ */
+static const int MAX_EVENTS = 256;
+
+/**
+ * @brief Конструктор класса EventLoop
+ */
+EventLoop::EventLoop() : epollFD(epoll_create1(EPOLL_CLOEXEC)), registered(0) {
+    if (epollFD < 0) {
+        ErrorHandler::logError("Ошибка создания epoll");
+    }
+}
+
+/**
+ * @brief Деструктор класса EventLoop
+ */
+EventLoop::~EventLoop() {
+    if (epollFD >= 0) {
+        close(epollFD);
+    }
+}
+
+/**
+ * @brief Регистрирует дескриптор
+ * @param [in] fd Неблокирующий дескриптор
+ * @param [in] events Ожидаемые события (EPOLLIN, EPOLLOUT)
+ * @param [in] handler Обработчик, вызываемый при готовности
+ * @return true если дескриптор зарегистрирован
+ */
+bool EventLoop::add(int fd, uint32_t events, EventHandler* handler) {
+    struct epoll_event event;
+    event.events = events;
+    event.data.ptr = handler;
+    if (epoll_ctl(epollFD, EPOLL_CTL_ADD, fd, &event) < 0) {
+        return false;
+    }
+    ++registered;
+    return true;
+}
+
+/**
+ * @brief Изменяет ожидаемые события дескриптора
+ * @param [in] fd Зарегистрированный дескриптор
+ * @param [in] events Новые ожидаемые события
+ * @param [in] handler Обработчик
+ * @return true если изменение выполнено
+ */
+bool EventLoop::modify(int fd, uint32_t events, EventHandler* handler) {
+    struct epoll_event event;
+    event.events = events;
+    event.data.ptr = handler;
+    return epoll_ctl(epollFD, EPOLL_CTL_MOD, fd, &event) == 0;
+}
+
+/**
+ * @brief Снимает дескриптор с регистрации
+ * @param [in] fd Зарегистрированный дескриптор
+ */
+void EventLoop::remove(int fd) {
+    if (epoll_ctl(epollFD, EPOLL_CTL_DEL, fd, nullptr) == 0) {
+        --registered;
+    }
+}
+
+/**
+ * @brief Ждет событий и вызывает обработчики один раз
+ * @param [in] timeoutMs Время ожидания в миллисекундах (-1 - без ограничения)
+ * @return Количество обработанных событий или -1 при ошибке epoll_wait
+ * @details Обработчик может снять с регистрации свой дескриптор, но не
+ * дескрипторы других обработчиков из той же пачки событий.
+ */
+int EventLoop::runOnce(int timeoutMs) {
+    struct epoll_event events[MAX_EVENTS];
+    int count = epoll_wait(epollFD, events, MAX_EVENTS, timeoutMs);
+    if (count < 0) {
+        if (errno == EINTR) {
+            return 0;
+        }
+        ErrorHandler::logError("Ошибка ожидания событий epoll");
+        return -1;
+    }
+    
+    for (int i = 0; i < count; ++i) {
+        static_cast<EventHandler*>(events[i].data.ptr)->onEvent(events[i].events);
+    }
+    return count;
+}
+
+/**
+ * @brief Обрабатывает события, пока есть зарегистрированные дескрипторы
+ * @return true если цикл завершился штатно, false при ошибке epoll_wait
+ */
+bool EventLoop::run() {
+    while (registered > 0) {
+        if (runOnce(-1) < 0) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,104 @@
+#ifndef EVENTLOOP_H
+#define EVENTLOOP_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Обработчик событий дескриптора
+ * @details Реализуется объектами, которые регистрируют свои дескрипторы
+ * в EventLoop и реагируют на готовность к чтению и записи.
+ */
+class EventHandler {
+public:
+    virtual ~EventHandler() {}
+    
+    /**
+     * @brief Обрабатывает готовность дескриптора
+     * @param [in] events Маска событий epoll (EPOLLIN, EPOLLOUT, EPOLLERR, EPOLLHUP)
+     */
+    virtual void onEvent(uint32_t events) = 0;
+};
+
+/**
+ * @brief Цикл событий на основе epoll
+ * @details Ожидает готовности зарегистрированных неблокирующих дескрипторов
+ * и вызывает их обработчики в одном потоке. Работа run() заканчивается,
+ * когда не остается зарегистрированных дескрипторов.
+ * @warning Объекты класса не копируются.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+class EventLoop {
+private:
+    int epollFD;        ///< Дескриптор epoll
+    size_t registered;  ///< Количество зарегистрированных дескрипторов
+    
+public:
+    /**
+     * @brief Конструктор класса EventLoop
+     * @details Создает экземпляр epoll; проверить результат можно методом isValid().
+     */
+    EventLoop();
+    
+    /**
+     * @brief Деструктор класса EventLoop
+     */
+    ~EventLoop();
+    
+    EventLoop(const EventLoop&) = delete;
+    EventLoop& operator=(const EventLoop&) = delete;
+    
+    /**
+     * @brief Проверяет, создан ли экземпляр epoll
+     * @return true если цикл готов к работе
+     */
+    bool isValid() const { return epollFD >= 0; }
+    
+    /**
+     * @brief Регистрирует дескриптор
+     * @param [in] fd Неблокирующий дескриптор
+     * @param [in] events Ожидаемые события (EPOLLIN, EPOLLOUT)
+     * @param [in] handler Обработчик, вызываемый при готовности
+     * @return true если дескриптор зарегистрирован
+     */
+    bool add(int fd, uint32_t events, EventHandler* handler);
+    
+    /**
+     * @brief Изменяет ожидаемые события дескриптора
+     * @param [in] fd Зарегистрированный дескриптор
+     * @param [in] events Новые ожидаемые события
+     * @param [in] handler Обработчик
+     * @return true если изменение выполнено
+     */
+    bool modify(int fd, uint32_t events, EventHandler* handler);
+    
+    /**
+     * @brief Снимает дескриптор с регистрации
+     * @param [in] fd Зарегистрированный дескриптор
+     * @details Вызывается до закрытия дескриптора.
+     */
+    void remove(int fd);
+    
+    /**
+     * @brief Возвращает количество зарегистрированных дескрипторов
+     * @return Количество дескрипторов
+     */
+    size_t size() const { return registered; }
+    
+    /**
+     * @brief Ждет событий и вызывает обработчики один раз
+     * @param [in] timeoutMs Время ожидания в миллисекундах (-1 - без ограничения)
+     * @return Количество обработанных событий или -1 при ошибке epoll_wait
+     */
+    int runOnce(int timeoutMs);
+    
+    /**
+     * @brief Обрабатывает события, пока есть зарегистрированные дескрипторы
+     * @return true если цикл завершился штатно, false при ошибке epoll_wait
+     */
+    bool run();
+};
+
+#endif // EVENTLOOP_H
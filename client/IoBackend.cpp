@@ -0,0 +1,49 @@
+/**
+ * @file IoBackend.cpp
+ * @brief Выбор механизма ввода-вывода
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+
+#include "IoBackend.h"
+#include "BlockingIoBackend.h"
+#include "UringIoBackend.h"
+#include "ErrorHandler.h"
+
+/**
+ * @brief Размер очереди отправки io_uring
+ * @details Соединению одновременно нужно не больше нескольких операций:
+ * отправка, прием и служебные вызовы.
+ */
+static const unsigned URING_ENTRIES = 8;
+
+/**
+ * @brief Проверяет название механизма
+ * @param [in] kind Название из командной строки
+ * @return true если название допустимо
+ */
+bool IoBackend::isValidKind(const std::string& kind) {
+    return kind == "auto" || kind == "uring" || kind == "blocking";
+}
+
+/**
+ * @brief Создает механизм ввода-вывода
+ * @param [in] kind "blocking", "uring" или "auto"
+ * @return Механизм; при недоступности io_uring - блокирующий
+ * @details Если io_uring явно запрошен, но недоступен (старое ядро, запрет
+ * через sysctl kernel.io_uring_disabled или seccomp), выводится сообщение
+ * об ошибке и используется блокирующий механизм.
+ */
+std::unique_ptr<IoBackend> IoBackend::create(const std::string& kind) {
+    if (kind != "blocking") {
+        std::unique_ptr<UringIoBackend> uring(new UringIoBackend());
+        if (uring->open(URING_ENTRIES)) {
+            return std::unique_ptr<IoBackend>(uring.release());
+        }
+        if (kind == "uring") {
+            ErrorHandler::logError("io_uring недоступен, используется блокирующий ввод-вывод");
+        }
+    }
+    return std::unique_ptr<IoBackend>(new BlockingIoBackend());
+}
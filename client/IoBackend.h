@@ -0,0 +1,113 @@
+#ifndef IOBACKEND_H
+#define IOBACKEND_H
+
+#include <string>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <sys/types.h>
+
+struct msghdr;
+
+/**
+ * @brief Результат завершенной операции ввода-вывода
+ */
+struct IoCompletion {
+    uint64_t tag;   ///< Метка, переданная при постановке операции
+    ssize_t result; ///< Число переданных байтов или -errno
+};
+
+/**
+ * @brief Интерфейс механизма ввода-вывода для сокета
+ * @details Операции сначала ставятся в очередь, затем wait() отправляет
+ * их на выполнение и возвращает завершенные. Блокирующая реализация
+ * выполняет очередь последовательно обычными системными вызовами,
+ * асинхронная (io_uring) отправляет всю очередь одним вызовом, и операции
+ * выполняются одновременно.
+ * @warning Объект используется одним потоком.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+class IoBackend {
+public:
+    virtual ~IoBackend() {}
+    
+    /**
+     * @brief Возвращает название механизма для журнала
+     * @return Название механизма
+     */
+    virtual const char* name() const = 0;
+    
+    /**
+     * @brief Проверяет, выполняются ли операции очереди одновременно
+     * @return true если отправка и прием могут ожидать завершения параллельно
+     */
+    virtual bool isAsync() const = 0;
+    
+    /**
+     * @brief Ставит в очередь отправку sendmsg
+     * @param [in] fd Дескриптор сокета
+     * @param [in] msg Описание отправляемых буферов (должно жить до завершения)
+     * @param [in] flags Флаги sendmsg (например, MSG_MORE)
+     * @param [in] tag Метка операции
+     * @return true если операция поставлена в очередь
+     * @details К флагам всегда добавляется MSG_NOSIGNAL: разрыв соединения
+     * сервером дает ошибку EPIPE, а не SIGPIPE, и в программах без
+     * обработчика сигнала.
+     */
+    virtual bool queueSendmsg(int fd, const struct msghdr* msg, int flags, uint64_t tag) = 0;
+    
+    /**
+     * @brief Ставит в очередь прием recv
+     * @param [in] fd Дескриптор сокета
+     * @param [out] buffer Буфер приема (должен жить до завершения)
+     * @param [in] size Размер буфера
+     * @param [in] flags Флаги recv (например, MSG_WAITALL)
+     * @param [in] tag Метка операции
+     * @return true если операция поставлена в очередь
+     */
+    virtual bool queueRecv(int fd, void* buffer, size_t size, int flags, uint64_t tag) = 0;
+    
+    /**
+     * @brief Отправляет очередь на выполнение и ждет завершения операций
+     * @param [out] completions Массив для завершенных операций
+     * @param [in] max Размер массива
+     * @return Количество завершенных операций: не меньше 1, если есть
+     * незавершенные операции, 0 - если их нет; -1 при ошибке механизма
+     */
+    virtual int wait(IoCompletion* completions, size_t max) = 0;
+    
+    /**
+     * @brief Регистрирует буфер приема в ядре
+     * @param [in] buffer Начало буфера
+     * @param [in] size Размер буфера
+     * @return true если буфер зарегистрирован
+     * @details Прием в зарегистрированный буфер не требует отображения
+     * страниц пользователя при каждой операции. Механизм без поддержки
+     * регистрации возвращает false, и прием идет обычным путем.
+     */
+    virtual bool registerBuffer(void* buffer, size_t size) { (void)buffer; (void)size; return false; }
+    
+    /**
+     * @brief Снимает регистрацию буфера приема
+     */
+    virtual void unregisterBuffer() {}
+    
+    /**
+     * @brief Создает механизм ввода-вывода
+     * @param [in] kind "blocking", "uring" или "auto"
+     * @return Механизм; при недоступности io_uring - блокирующий
+     * @details "auto" выбирает io_uring, если ядро его поддерживает.
+     */
+    static std::unique_ptr<IoBackend> create(const std::string& kind);
+    
+    /**
+     * @brief Проверяет название механизма
+     * @param [in] kind Название из командной строки
+     * @return true если название допустимо
+     */
+    static bool isValidKind(const std::string& kind);
+};
+
+#endif // IOBACKEND_H
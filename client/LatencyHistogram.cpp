@@ -0,0 +1,70 @@
+/**
+ * @file LatencyHistogram.cpp
+ * @brief Реализация класса LatencyHistogram
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+
+#include "LatencyHistogram.h"
+#include <cmath>
+
+/**
+ * @brief Добавляет значения другой гистограммы
+ * @param [in] other Гистограмма
+ */
+void LatencyHistogram::add(const LatencyHistogram& other) {
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        const uint64_t value = other.counts[i].load(std::memory_order_relaxed);
+        if (value > 0) {
+            counts[i].fetch_add(value, std::memory_order_relaxed);
+        }
+    }
+    total.fetch_add(other.count(), std::memory_order_relaxed);
+    sum.fetch_add(other.totalSum(), std::memory_order_relaxed);
+    const uint64_t otherMax = other.max();
+    uint64_t current = maxValue.load(std::memory_order_relaxed);
+    while (otherMax > current && !maxValue.compare_exchange_weak(current, otherMax, std::memory_order_relaxed)) {
+    }
+}
+
+/**
+ * @brief Возвращает наибольшее значение интервала
+ * @param [in] index Номер интервала
+ * @return Верхняя граница интервала включительно
+ */
+uint64_t LatencyHistogram::upperBound(size_t index) {
+    if (index < LINEAR_VALUES) {
+        return index;
+    }
+    const size_t offset = index - LINEAR_VALUES;
+    const unsigned shift = static_cast<unsigned>(offset / SUB_BUCKETS) + 1;
+    const uint64_t subBucket = offset % SUB_BUCKETS + SUB_BUCKETS;
+    return ((subBucket + 1) << shift) - 1;
+}
+
+/**
+ * @brief Возвращает квантиль
+ * @param [in] quantile Доля от 0 до 1
+ * @return Верхняя граница интервала квантиля, не больше max()
+ * @details Ищется интервал, на котором накопленное количество значений
+ * достигает ceil(quantile * count()).
+ */
+uint64_t LatencyHistogram::percentile(double quantile) const {
+    const uint64_t n = count();
+    if (n == 0) {
+        return 0;
+    }
+    uint64_t rank = static_cast<uint64_t>(std::ceil(quantile * static_cast<double>(n)));
+    rank = rank < 1 ? 1 : (rank > n ? n : rank);
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        seen += counts[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            const uint64_t bound = upperBound(i);
+            return bound < max() ? bound : max();
+        }
+    }
+    return max();
+}
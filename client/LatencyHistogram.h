@@ -0,0 +1,110 @@
+#ifndef LATENCY_HISTOGRAM_H
+#define LATENCY_HISTOGRAM_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Гистограмма задержек с логарифмически-линейными интервалами
+ * @details Устроена как HDR Histogram: значения меньше 64 хранятся точно,
+ * каждый следующий диапазон [2^e, 2^(e+1)) делится на 32 равных интервала,
+ * поэтому относительная погрешность квантиля не превышает 1/32 (~3%) при
+ * постоянном объеме памяти. Значения от 2^40 нс (~18 минут) попадают в
+ * последний интервал.
+ *
+ * Запись - вычисление номера интервала по старшему биту и атомарное
+ * увеличение счетчика без блокировок, поэтому гистограмму можно заполнять
+ * из нескольких потоков.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+class LatencyHistogram {
+public:
+    static const unsigned SUB_BUCKET_BITS = 5;                    ///< log2 числа интервалов в диапазоне
+    static const unsigned SUB_BUCKETS = 1u << SUB_BUCKET_BITS;    ///< Интервалов в диапазоне [2^e, 2^(e+1))
+    static const unsigned LINEAR_VALUES = 2 * SUB_BUCKETS;        ///< Значения, хранящиеся точно
+    static const unsigned MAX_EXPONENT = 40;                      ///< Значения ограничены 2^40 - 1
+    static const size_t BUCKET_COUNT = LINEAR_VALUES + (MAX_EXPONENT - SUB_BUCKET_BITS - 1) * SUB_BUCKETS;
+
+    /**
+     * @brief Конструктор: пустая гистограмма
+     * @details constexpr: статические гистограммы обнуляются при загрузке
+     * программы, без заполнения памяти при запуске.
+     */
+    constexpr LatencyHistogram() : counts{}, total(0), sum(0), maxValue(0) {}
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    /**
+     * @brief Учитывает значение
+     * @param [in] value Значение (наносекунды)
+     */
+    void record(uint64_t value) {
+        const uint64_t clamped = value < (1ull << MAX_EXPONENT) ? value : (1ull << MAX_EXPONENT) - 1;
+        counts[indexOf(clamped)].fetch_add(1, std::memory_order_relaxed);
+        total.fetch_add(1, std::memory_order_relaxed);
+        sum.fetch_add(value, std::memory_order_relaxed);
+        uint64_t current = maxValue.load(std::memory_order_relaxed);
+        while (value > current && !maxValue.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+        }
+    }
+
+    /**
+     * @brief Добавляет значения другой гистограммы
+     * @param [in] other Гистограмма
+     */
+    void add(const LatencyHistogram& other);
+
+    /**
+     * @brief Возвращает количество значений
+     */
+    uint64_t count() const { return total.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Возвращает сумму значений
+     */
+    uint64_t totalSum() const { return sum.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Возвращает наибольшее значение
+     */
+    uint64_t max() const { return maxValue.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Возвращает квантиль
+     * @param [in] quantile Доля от 0 до 1 (0.999 - 99.9-й процентиль)
+     * @return Верхняя граница интервала, в который попал квантиль (не больше max()),
+     * 0 для пустой гистограммы
+     */
+    uint64_t percentile(double quantile) const;
+
+    /**
+     * @brief Возвращает номер интервала значения
+     * @param [in] value Значение меньше 2^MAX_EXPONENT
+     */
+    static size_t indexOf(uint64_t value) {
+        if (value < LINEAR_VALUES) {
+            return static_cast<size_t>(value);
+        }
+        const unsigned exponent = 63 - static_cast<unsigned>(__builtin_clzll(value));
+        const uint64_t subBucket = (value >> (exponent - SUB_BUCKET_BITS)) - SUB_BUCKETS;
+        return LINEAR_VALUES + (exponent - SUB_BUCKET_BITS - 1) * SUB_BUCKETS + static_cast<size_t>(subBucket);
+    }
+
+    /**
+     * @brief Возвращает наибольшее значение интервала
+     * @param [in] index Номер интервала
+     */
+    static uint64_t upperBound(size_t index);
+
+private:
+    std::atomic<uint64_t> counts[BUCKET_COUNT];  ///< Счетчики интервалов
+    std::atomic<uint64_t> total;                 ///< Количество значений
+    std::atomic<uint64_t> sum;                   ///< Сумма значений
+    std::atomic<uint64_t> maxValue;              ///< Наибольшее значение
+};
+
+#endif // LATENCY_HISTOGRAM_H
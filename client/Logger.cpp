@@ -0,0 +1,229 @@
+/**
+ * @file Logger.cpp
+ * @brief Реализация класса Logger
+ * @details Содержит кольцевой буфер сообщений без блокировок (алгоритм
+ * ограниченной очереди с порядковыми номерами ячеек) и фоновый поток вывода.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+
+#include "Logger.h"
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <unistd.h>
+#include <errno.h>
+
+namespace {
+
+/**
+ * @brief Префиксы уровней в порядке LogLevel
+ */
+const char* const LEVEL_PREFIX[] = { "Отладка: ", "Лог: ", "Предупреждение: ", "[ОШИБКА] " };
+
+/**
+ * @brief Очередь сообщений и фоновый поток вывода
+ * @details Ячейка свободна для записи номер pos, когда ее sequence == pos,
+ * и готова к чтению, когда sequence == pos + 1. Писатели занимают номер
+ * через compare_exchange на tail, единственный читатель двигает head.
+ */
+class LogQueue {
+private:
+    /**
+     * @brief Ячейка кольцевого буфера
+     */
+    struct Slot {
+        std::atomic<size_t> sequence;  ///< Порядковый номер состояния ячейки
+        LogLevel level;                ///< Уровень сообщения
+        std::string text;              ///< Текст сообщения
+    };
+
+    static const size_t CAPACITY = 4096;  ///< Емкость буфера (степень двойки)
+
+    std::vector<Slot> slots;           ///< Ячейки буфера
+    std::atomic<size_t> tail;          ///< Следующий номер для писателя
+    size_t head;                       ///< Следующий номер для читателя (только фоновый поток)
+    std::atomic<size_t> written;       ///< Сколько сообщений уже выведено
+    std::atomic<uint32_t> signal;      ///< Счетчик событий для пробуждения читателя
+    std::atomic<bool> sleeping;        ///< Читатель ждет на signal
+    std::atomic<bool> stopping;        ///< Программа завершается
+    std::thread writer;                ///< Фоновый поток вывода
+
+    /**
+     * @brief Будит фоновый поток, если он спит
+     */
+    void wake() {
+        signal.fetch_add(1);
+        if (sleeping.load()) {
+            signal.notify_one();
+        }
+    }
+
+    /**
+     * @brief Проверяет, есть ли готовое к чтению сообщение
+     */
+    bool hasMessage() const {
+        return slots[head & (CAPACITY - 1)].sequence.load(std::memory_order_acquire) == head + 1;
+    }
+
+    /**
+     * @brief Выводит накопленный текст в дескриптор
+     */
+    static void writeAll(int fd, std::string& buffer) {
+        size_t done = 0;
+        while (done < buffer.size()) {
+            ssize_t n = ::write(fd, buffer.data() + done, buffer.size() - done);
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n <= 0) {
+                break;  // Вывод журнала недоступен: сообщения отбрасываются
+            }
+            done += static_cast<size_t>(n);
+        }
+        buffer.clear();
+    }
+
+    /**
+     * @brief Забирает все готовые сообщения и выводит их
+     * @details Подряд идущие сообщения одного потока вывода собираются в
+     * один буфер, поэтому порядок между stdout и stderr сохраняется.
+     */
+    void drain() {
+        std::string buffer;
+        int bufferFD = STDOUT_FILENO;
+        while (hasMessage()) {
+            Slot& slot = slots[head & (CAPACITY - 1)];
+            const int fd = slot.level >= LOG_LEVEL_WARNING ? STDERR_FILENO : STDOUT_FILENO;
+            if (fd != bufferFD) {
+                writeAll(bufferFD, buffer);
+                bufferFD = fd;
+            }
+            buffer += LEVEL_PREFIX[slot.level];
+            buffer += slot.text;
+            buffer += '\n';
+            slot.text.clear();
+            slot.sequence.store(head + CAPACITY, std::memory_order_release);
+            ++head;
+        }
+        writeAll(bufferFD, buffer);
+        written.store(head, std::memory_order_release);
+        written.notify_all();
+    }
+
+    /**
+     * @brief Цикл фонового потока
+     */
+    void run() {
+        for (;;) {
+            drain();
+            if (stopping.load() && !hasMessage()) {
+                return;
+            }
+            sleeping.store(true);
+            const uint32_t seen = signal.load();
+            if (!hasMessage() && !stopping.load()) {
+                signal.wait(seen);
+            }
+            sleeping.store(false);
+        }
+    }
+
+public:
+    LogQueue() : slots(CAPACITY), tail(0), head(0), written(0), signal(0), sleeping(false), stopping(false) {
+        for (size_t i = 0; i < CAPACITY; ++i) {
+            slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+        writer = std::thread(&LogQueue::run, this);
+    }
+
+    /**
+     * @brief Выводит оставшиеся сообщения и останавливает поток
+     */
+    ~LogQueue() {
+        stopping.store(true);
+        wake();
+        writer.join();
+    }
+
+    /**
+     * @brief Кладет сообщение в буфер
+     * @param [in] level Уровень
+     * @param [in] text Текст
+     */
+    void push(LogLevel level, std::string&& text) {
+        size_t pos = tail.load(std::memory_order_relaxed);
+        Slot* slot;
+        for (;;) {
+            slot = &slots[pos & (CAPACITY - 1)];
+            const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                // Буфер заполнен: ждем, пока фоновый поток освободит ячейку
+                wake();
+                std::this_thread::yield();
+                pos = tail.load(std::memory_order_relaxed);
+            } else {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+        slot->level = level;
+        slot->text = std::move(text);
+        slot->sequence.store(pos + 1, std::memory_order_release);
+        wake();
+    }
+
+    /**
+     * @brief Ждет вывода всех сообщений, занявших ячейку до вызова
+     */
+    void flush() {
+        const size_t target = tail.load(std::memory_order_acquire);
+        size_t done = written.load(std::memory_order_acquire);
+        while (done < target) {
+            wake();
+            written.wait(done);
+            done = written.load(std::memory_order_acquire);
+        }
+    }
+};
+
+/**
+ * @brief Возвращает очередь журнала, создавая ее при первом обращении
+ * @details Статический объект разрушается при завершении программы
+ * (в том числе через std::exit), и оставшиеся сообщения выводятся.
+ */
+LogQueue& queue() {
+    static LogQueue instance;
+    return instance;
+}
+
+}  // namespace
+
+/**
+ * @brief Задает наименьший выводимый уровень
+ * @param [in] level Уровень
+ */
+void Logger::setLevel(LogLevel level) {
+    currentLevel.store(level, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Ставит сообщение в очередь вывода
+ * @param [in] level Уровень
+ * @param [in] message Текст без префикса и перевода строки
+ */
+void Logger::write(LogLevel level, std::string message) {
+    queue().push(level, std::move(message));
+}
+
+/**
+ * @brief Ждет вывода всех сообщений, поставленных в очередь до вызова
+ */
+void Logger::flush() {
+    queue().flush();
+}
@@ -0,0 +1,107 @@
+#ifndef LOGGER_H
+#define LOGGER_H
+
+#include <string>
+#include <sstream>
+#include <atomic>
+
+/**
+ * @brief Наименьший уровень сообщений, попадающих в программу при сборке
+ * @details Сообщения ниже этого уровня отбрасываются компилятором вместе
+ * с вычислением их аргументов. По умолчанию отладочные сообщения есть
+ * и включаются опцией -v; выпускная сборка (make LOG_MIN_LEVEL=1) их исключает,
+ * и опция -v в ней не выводится в справке.
+ */
+#ifndef LOG_MIN_LEVEL
+#define LOG_MIN_LEVEL 0
+#endif
+
+/**
+ * @brief Уровень сообщения журнала
+ */
+enum LogLevel {
+    LOG_LEVEL_DEBUG = 0,    ///< Отладка: подробности работы, префикс "Отладка:"
+    LOG_LEVEL_INFO = 1,     ///< Ход работы, префикс "Лог:"
+    LOG_LEVEL_WARNING = 2,  ///< Предупреждения, префикс "Предупреждение:"
+    LOG_LEVEL_ERROR = 3     ///< Ошибки, префикс "[ОШИБКА]"
+};
+
+/**
+ * @brief Асинхронный журнал с уровнями сообщений
+ * @details Потоки, пишущие в журнал, только кладут готовую строку в кольцевой
+ * буфер без блокировок (несколько писателей, один читатель). Фоновый поток
+ * забирает сообщения пачками и выводит их одним вызовом write() на пачку:
+ * отладка и ход работы - в stdout, предупреждения и ошибки - в stderr.
+ * При переполнении буфера писатель ждет, сообщения не теряются.
+ *
+ * Сообщения пишутся макросами LOG_DEBUG, LOG_INFO, LOG_WARNING и LOG_ERROR,
+ * аргумент которых - цепочка для operator<<. Уровень ниже текущего
+ * (setLevel()) отсекается до форматирования, а ниже LOG_MIN_LEVEL - при
+ * компиляции.
+ * @warning Все методы являются статическими, экземпляры класса не создаются.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+class Logger {
+private:
+    static inline std::atomic<int> currentLevel{LOG_LEVEL_INFO};  ///< Текущий уровень журнала
+
+public:
+    /**
+     * @brief Задает наименьший выводимый уровень
+     * @param [in] level Уровень (по умолчанию LOG_LEVEL_INFO)
+     */
+    static void setLevel(LogLevel level);
+
+    /**
+     * @brief Возвращает наименьший выводимый уровень
+     * @return Уровень, заданный setLevel()
+     */
+    static LogLevel getLevel() {
+        return static_cast<LogLevel>(currentLevel.load(std::memory_order_relaxed));
+    }
+
+    /**
+     * @brief Проверяет, выводятся ли сообщения уровня
+     * @param [in] level Уровень
+     * @return true если сообщение будет выведено
+     */
+    static bool isEnabled(LogLevel level) {
+        return level >= LOG_MIN_LEVEL && level >= currentLevel.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @brief Ставит сообщение в очередь вывода
+     * @param [in] level Уровень
+     * @param [in] message Текст без префикса и перевода строки
+     */
+    static void write(LogLevel level, std::string message);
+
+    /**
+     * @brief Ждет вывода всех сообщений, поставленных в очередь до вызова
+     */
+    static void flush();
+};
+
+/**
+ * @brief Пишет сообщение заданного уровня
+ * @details Аргумент вычисляется, только если уровень включен
+ */
+#define LOG_AT(level, expr)                                  \
+    do {                                                     \
+        if constexpr ((level) >= LOG_MIN_LEVEL) {            \
+            if (Logger::isEnabled(level)) {                  \
+                std::ostringstream logStream_;               \
+                logStream_ << expr;                          \
+                Logger::write((level), logStream_.str());    \
+            }                                                \
+        }                                                    \
+    } while (0)
+
+#define LOG_DEBUG(expr) LOG_AT(LOG_LEVEL_DEBUG, expr)
+#define LOG_INFO(expr) LOG_AT(LOG_LEVEL_INFO, expr)
+#define LOG_WARNING(expr) LOG_AT(LOG_LEVEL_WARNING, expr)
+#define LOG_ERROR(expr) LOG_AT(LOG_LEVEL_ERROR, expr)
+
+#endif // LOGGER_H
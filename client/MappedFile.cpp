@@ -0,0 +1,101 @@
+/**
+ * @file MappedFile.cpp
+ * @brief Реализация класса MappedFile
+ * @details Содержит реализацию отображения файла в память с помощью mmap
+ * и запасной вариант с чтением файла в буфер.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+
+#include "MappedFile.h"
+#include "ErrorHandler.h"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+
+/**
+ * @brief Конструктор класса MappedFile
+ * @details Создает объект без открытого файла
+ */
+MappedFile::MappedFile() : fileFD(-1), mapping(nullptr), length(0) {}
+
+/**
+ * @brief Деструктор класса MappedFile
+ * @details Освобождает отображение и закрывает файл
+ */
+MappedFile::~MappedFile() {
+    close();
+}
+
+/**
+ * @brief Открывает файл и отображает его в память
+ * @param [in] filename Имя файла
+ * @return true если файл открыт, false в случае ошибки
+ * @details Для обычных файлов используется mmap с подсказкой
+ * последовательного чтения. Для остальных (каналы, /dev/stdin) и при ошибке
+ * mmap содержимое читается в буфер целиком.
+ */
+bool MappedFile::open(const std::string& filename) {
+    close();
+    
+    fileFD = ::open(filename.c_str(), O_RDONLY);
+    if (fileFD < 0) {
+        ErrorHandler::logError("Не удалось открыть файл: " + filename);
+        return false;
+    }
+    
+    struct stat st;
+    if (fstat(fileFD, &st) == 0 && S_ISREG(st.st_mode)) {
+        length = static_cast<size_t>(st.st_size);
+        if (length == 0) {
+            return true;
+        }
+        
+        void* addr = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fileFD, 0);
+        if (addr != MAP_FAILED) {
+            madvise(addr, length, MADV_SEQUENTIAL);
+            mapping = static_cast<const char*>(addr);
+            return true;
+        }
+    }
+    
+    // Запасной вариант: читаем содержимое в буфер
+    length = 0;
+    buffer.resize(1 << 16);
+    while (true) {
+        if (length == buffer.size()) {
+            buffer.resize(buffer.size() * 2);
+        }
+        ssize_t got = read(fileFD, buffer.data() + length, buffer.size() - length);
+        if (got < 0 && errno == EINTR) continue;
+        if (got < 0) {
+            ErrorHandler::logError("Ошибка чтения файла: " + filename);
+            close();
+            return false;
+        }
+        if (got == 0) break;
+        length += static_cast<size_t>(got);
+    }
+    buffer.resize(length);
+    
+    return true;
+}
+
+/**
+ * @brief Освобождает отображение и закрывает файл
+ */
+void MappedFile::close() {
+    if (mapping) {
+        munmap(const_cast<char*>(mapping), length);
+        mapping = nullptr;
+    }
+    if (fileFD >= 0) {
+        ::close(fileFD);
+        fileFD = -1;
+    }
+    buffer.clear();
+    length = 0;
+}
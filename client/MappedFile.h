@@ -0,0 +1,71 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+/**
+ * @brief Класс для отображения файла в память только для чтения
+ * @details Отображает файл целиком с помощью mmap. Если файл нельзя отобразить
+ * (канал, специальный файл), содержимое читается в собственный буфер.
+ * Отображение освобождается при закрытии или уничтожении объекта.
+ * @warning Объекты класса не копируются.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+class MappedFile {
+private:
+    int fileFD;                ///< Дескриптор открытого файла
+    const char* mapping;       ///< Начало отображения (nullptr, если не отображен)
+    size_t length;             ///< Размер содержимого в байтах
+    std::vector<char> buffer;  ///< Содержимое файла, если mmap недоступен
+    
+public:
+    /**
+     * @brief Конструктор класса MappedFile
+     */
+    MappedFile();
+    
+    /**
+     * @brief Деструктор класса MappedFile
+     * @details Освобождает отображение и закрывает файл
+     */
+    ~MappedFile();
+    
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    
+    /**
+     * @brief Открывает файл и отображает его в память
+     * @param [in] filename Имя файла
+     * @return true если файл открыт, false в случае ошибки
+     */
+    bool open(const std::string& filename);
+    
+    /**
+     * @brief Освобождает отображение и закрывает файл
+     */
+    void close();
+    
+    /**
+     * @brief Возвращает указатель на начало содержимого файла
+     * @return Указатель на содержимое (может быть nullptr для пустого файла)
+     */
+    const char* data() const { return mapping ? mapping : buffer.data(); }
+    
+    /**
+     * @brief Возвращает размер содержимого файла
+     * @return Размер в байтах
+     */
+    size_t size() const { return length; }
+    
+    /**
+     * @brief Возвращает дескриптор открытого файла
+     * @return Дескриптор или -1, если файл не открыт
+     */
+    int descriptor() const { return fileFD; }
+};
+
+#endif // MAPPEDFILE_H
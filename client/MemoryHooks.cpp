@@ -0,0 +1,44 @@
+/**
+ * @file MemoryHooks.cpp
+ * @brief Замена глобальных operator new и operator delete
+ * @details Все формы операторов передаются в MemoryTracker::allocate() и
+ * MemoryTracker::release(). Файл входит только в программу client:
+ * программы замера и тесты собираются без него и выделяют память
+ * стандартными операторами.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+
+#include "MemoryTracker.h"
+#include <new>
+
+void* operator new(size_t size) { return MemoryTracker::allocate(size, 0, false); }
+void* operator new[](size_t size) { return MemoryTracker::allocate(size, 0, false); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return MemoryTracker::allocate(size, 0, true); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return MemoryTracker::allocate(size, 0, true); }
+void* operator new(size_t size, std::align_val_t alignment) {
+    return MemoryTracker::allocate(size, static_cast<size_t>(alignment), false);
+}
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return MemoryTracker::allocate(size, static_cast<size_t>(alignment), false);
+}
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return MemoryTracker::allocate(size, static_cast<size_t>(alignment), true);
+}
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return MemoryTracker::allocate(size, static_cast<size_t>(alignment), true);
+}
+
+void operator delete(void* block) noexcept { MemoryTracker::release(block); }
+void operator delete[](void* block) noexcept { MemoryTracker::release(block); }
+void operator delete(void* block, size_t) noexcept { MemoryTracker::release(block); }
+void operator delete[](void* block, size_t) noexcept { MemoryTracker::release(block); }
+void operator delete(void* block, const std::nothrow_t&) noexcept { MemoryTracker::release(block); }
+void operator delete[](void* block, const std::nothrow_t&) noexcept { MemoryTracker::release(block); }
+void operator delete(void* block, std::align_val_t) noexcept { MemoryTracker::release(block); }
+void operator delete[](void* block, std::align_val_t) noexcept { MemoryTracker::release(block); }
+void operator delete(void* block, size_t, std::align_val_t) noexcept { MemoryTracker::release(block); }
+void operator delete[](void* block, size_t, std::align_val_t) noexcept { MemoryTracker::release(block); }
+void operator delete(void* block, std::align_val_t, const std::nothrow_t&) noexcept { MemoryTracker::release(block); }
+void operator delete[](void* block, std::align_val_t, const std::nothrow_t&) noexcept { MemoryTracker::release(block); }
@@ -0,0 +1,236 @@
+/**
+ * @file MemoryTracker.cpp
+ * @brief Реализация класса MemoryTracker
+ * @details Выделения учитываются только после enable(): до этого
+ * allocate() и release() сводятся к malloc() и free() с одной проверкой
+ * флага. Объем занятой кучи считается от момента включения: блоки,
+ * выделенные раньше и освобожденные после, уменьшают его, поэтому он
+ * хранится со знаком, а отчет показывает его наибольший прирост.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+
+#include "MemoryTracker.h"
+#include "Metrics.h"
+#include "Logger.h"
+#include <new>
+#include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <malloc.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace {
+
+std::atomic<uint64_t> allocationCount{0};  ///< Выделений с включения учета
+std::atomic<uint64_t> allocatedBytes{0};   ///< Байт выделено с включения учета
+std::atomic<int64_t> liveBytes{0};         ///< Прирост занятой кучи с включения учета
+std::atomic<int64_t> peakLiveBytes{0};     ///< Наибольший прирост занятой кучи
+
+/**
+ * @brief Расход памяти одного этапа
+ */
+struct PhaseMemory {
+    std::atomic<uint64_t> entries{0};      ///< Входы в этап
+    std::atomic<uint64_t> allocations{0};  ///< Выделений
+    std::atomic<uint64_t> bytes{0};        ///< Байт выделено
+    std::atomic<uint64_t> rss{0};          ///< VmRSS на последнем выходе, байт
+    std::atomic<uint64_t> hwm{0};          ///< VmHWM на последнем выходе, байт
+};
+
+PhaseMemory phases[Metrics::PHASE_COUNT];
+uint64_t baselineRss = 0;  ///< VmRSS при включении отчета, байт
+
+/**
+ * @brief Учитывает выделенный блок
+ * @param [in] block Блок или nullptr
+ * @return block
+ */
+void* account(void* block) {
+    if (block != nullptr && MemoryTracker::isEnabled()) {
+        const int64_t size = static_cast<int64_t>(malloc_usable_size(block));
+        allocationCount.fetch_add(1, std::memory_order_relaxed);
+        allocatedBytes.fetch_add(static_cast<uint64_t>(size), std::memory_order_relaxed);
+        const int64_t live = liveBytes.fetch_add(size, std::memory_order_relaxed) + size;
+        int64_t peak = peakLiveBytes.load(std::memory_order_relaxed);
+        while (live > peak && !peakLiveBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+        }
+    }
+    return block;
+}
+
+/**
+ * @brief Читает размер резидентной памяти процесса
+ * @param [out] rss Текущий размер (VmRSS), байт
+ * @param [out] hwm Наибольший размер (VmHWM), байт
+ * @details Файл читается без выделений памяти, чтобы не влиять на счетчики.
+ */
+void readStatus(uint64_t& rss, uint64_t& hwm) {
+    rss = 0;
+    hwm = 0;
+    int fd = open("/proc/self/status", O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return;
+    }
+    char buffer[4096];
+    const ssize_t got = read(fd, buffer, sizeof(buffer) - 1);
+    close(fd);
+    if (got <= 0) {
+        return;
+    }
+    buffer[got] = '\0';
+
+    const char* rssLine = strstr(buffer, "VmRSS:");
+    const char* hwmLine = strstr(buffer, "VmHWM:");
+    if (rssLine != nullptr) {
+        rss = strtoull(rssLine + 6, nullptr, 10) * 1024;
+    }
+    if (hwmLine != nullptr) {
+        hwm = strtoull(hwmLine + 6, nullptr, 10) * 1024;
+    }
+}
+
+/**
+ * @brief Переводит байты в мегабайты
+ */
+double megabytes(uint64_t bytes) {
+    return static_cast<double>(bytes) / (1 << 20);
+}
+
+}  // namespace
+
+/**
+ * @brief Выделяет блок по правилам operator new
+ * @param [in] size Размер
+ * @param [in] alignment Выравнивание (0 - как у malloc())
+ * @param [in] nothrow Вернуть nullptr вместо исключения std::bad_alloc
+ * @return Блок или nullptr (только при nothrow)
+ * @details Пока память не выделяется, вызывается обработчик std::new_handler.
+ */
+void* MemoryTracker::allocate(size_t size, size_t alignment, bool nothrow) {
+    if (size == 0) {
+        size = 1;
+    }
+    for (;;) {
+        void* block = nullptr;
+        if (alignment == 0) {
+            block = malloc(size);
+        } else if (posix_memalign(&block, alignment, size) != 0) {
+            block = nullptr;
+        }
+        if (block != nullptr) {
+            return account(block);
+        }
+        std::new_handler handler = std::get_new_handler();
+        if (handler == nullptr) {
+            if (nothrow) {
+                return nullptr;
+            }
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+/**
+ * @brief Освобождает блок по правилам operator delete
+ * @param [in] block Блок или nullptr
+ */
+void MemoryTracker::release(void* block) {
+    if (block != nullptr) {
+        if (isEnabled()) {
+            liveBytes.fetch_sub(static_cast<int64_t>(malloc_usable_size(block)), std::memory_order_relaxed);
+        }
+        free(block);
+    }
+}
+
+/**
+ * @brief Включает учет выделений и запоминает исходный размер процесса
+ */
+void MemoryTracker::enable() {
+    uint64_t hwm;
+    readStatus(baselineRss, hwm);
+    enabled.store(true, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Читает счетчики выделений
+ * @param [out] sample Показания
+ */
+void MemoryTracker::read(Sample& sample) {
+    sample.allocations = allocationCount.load(std::memory_order_relaxed);
+    sample.bytes = allocatedBytes.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Относит выделения к этапу и снимает размер процесса
+ * @param [in] phase Этап
+ * @param [in] start Показания при входе
+ * @param [in] end Показания при выходе
+ */
+void MemoryTracker::record(size_t phase, const Sample& start, const Sample& end) {
+    PhaseMemory& slot = phases[phase];
+    slot.entries.fetch_add(1, std::memory_order_relaxed);
+    slot.allocations.fetch_add(end.allocations - start.allocations, std::memory_order_relaxed);
+    slot.bytes.fetch_add(end.bytes - start.bytes, std::memory_order_relaxed);
+
+    uint64_t rss;
+    uint64_t hwm;
+    readStatus(rss, hwm);
+    slot.rss.store(rss, std::memory_order_relaxed);
+    slot.hwm.store(hwm, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Выводит в журнал расход памяти
+ * @details Прирост на вектор считается по числу отправленных векторов:
+ * для кучи - наибольший прирост с включения учета, для процесса - VmHWM
+ * за вычетом исходного VmRSS.
+ */
+void MemoryTracker::logReport() {
+    if (!isEnabled()) {
+        return;
+    }
+    char line[256];
+    for (size_t phase = 0; phase < Metrics::PHASE_COUNT; ++phase) {
+        const PhaseMemory& slot = phases[phase];
+        if (slot.entries.load() == 0) {
+            continue;
+        }
+        snprintf(line, sizeof(line), "выделений %llu, выделено %.1f МБ, VmRSS %.1f МБ, VmHWM %.1f МБ",
+                 static_cast<unsigned long long>(slot.allocations.load()), megabytes(slot.bytes.load()),
+                 megabytes(slot.rss.load()), megabytes(slot.hwm.load()));
+        LOG_INFO("Память " << Metrics::phaseName(static_cast<Metrics::Phase>(phase)) << ": " << line);
+    }
+
+    uint64_t rss;
+    uint64_t hwm;
+    readStatus(rss, hwm);
+    const uint64_t peakHeap = static_cast<uint64_t>(peakLiveBytes.load());
+    // В сборке без MemoryHooks.o (client_bench, тесты) выделения не видны
+    const bool heapTracked = allocationCount.load() > 0;
+    if (!heapTracked) {
+        snprintf(line, sizeof(line), "VmHWM %.1f МБ (исходно VmRSS %.1f МБ), куча в этой сборке не учитывается",
+                 megabytes(hwm), megabytes(baselineRss));
+    } else {
+        snprintf(line, sizeof(line), "наибольший прирост кучи %.1f МБ, VmHWM %.1f МБ (исходно VmRSS %.1f МБ), "
+                 "выделений всего %llu", megabytes(peakHeap), megabytes(hwm), megabytes(baselineRss),
+                 static_cast<unsigned long long>(allocationCount.load()));
+    }
+    LOG_INFO("Память: " << line);
+
+    const uint64_t vectors = Metrics::get(Metrics::VECTORS);
+    if (vectors > 0) {
+        const uint64_t growth = hwm > baselineRss ? hwm - baselineRss : 0;
+        if (heapTracked) {
+            snprintf(line, sizeof(line), "куча %.1f байт, прирост VmHWM %.1f байт",
+                     static_cast<double>(peakHeap) / vectors, static_cast<double>(growth) / vectors);
+        } else {
+            snprintf(line, sizeof(line), "прирост VmHWM %.1f байт", static_cast<double>(growth) / vectors);
+        }
+        LOG_INFO("Память на вектор: " << line);
+    }
+}
@@ -0,0 +1,123 @@
+#ifndef MEMORY_TRACKER_H
+#define MEMORY_TRACKER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Учет выделений памяти и размера процесса по этапам работы клиента
+ * @details Глобальные operator new и operator delete заменены в
+ * MemoryHooks.cpp и вызывают allocate() и release(). После enable()
+ * каждое выделение увеличивает атомарные счетчики количества и объема,
+ * а прирост занятой кучи (по malloc_usable_size()) отслеживается вместе
+ * с его наибольшим значением; до enable() учет не ведется. Счетчики общие для
+ * процесса; разность их значений на границах этапа (PhaseTimer и
+ * MemoryScope) относится к этапу. На выходе из этапа из /proc/self/status
+ * читаются текущий (VmRSS) и наибольший (VmHWM) размер резидентной памяти.
+ *
+ * Память, отображенная без operator new (mmap() входного файла, буферы
+ * io_uring), в куче не учитывается, но входит в VmRSS. Программы замера
+ * и тесты собираются без MemoryHooks.o: в них учитывается только VmRSS.
+ * @warning Все методы являются статическими, экземпляры класса не создаются.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+class MemoryTracker {
+private:
+    static inline std::atomic<bool> enabled{false};  ///< Отчет включен
+
+public:
+    /**
+     * @brief Показания счетчиков выделений
+     */
+    struct Sample {
+        uint64_t allocations;  ///< Выделений с включения учета
+        uint64_t bytes;        ///< Байт выделено с включения учета
+    };
+
+    /**
+     * @brief Включает учет выделений и запоминает исходный размер процесса
+     */
+    static void enable();
+
+    /**
+     * @brief Выделяет блок по правилам operator new и учитывает его
+     * @param [in] size Размер
+     * @param [in] alignment Выравнивание (0 - как у malloc())
+     * @param [in] nothrow Вернуть nullptr вместо исключения std::bad_alloc
+     * @return Блок или nullptr (только при nothrow)
+     */
+    static void* allocate(size_t size, size_t alignment, bool nothrow);
+
+    /**
+     * @brief Освобождает блок по правилам operator delete
+     * @param [in] block Блок или nullptr
+     */
+    static void release(void* block);
+
+    /**
+     * @brief Проверяет, включен ли учет по этапам
+     */
+    static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Читает счетчики выделений
+     * @param [out] sample Показания
+     */
+    static void read(Sample& sample);
+
+    /**
+     * @brief Относит выделения к этапу и снимает размер процесса
+     * @param [in] phase Этап (Metrics::Phase)
+     * @param [in] start Показания при входе в этап
+     * @param [in] end Показания при выходе из этапа
+     */
+    static void record(size_t phase, const Sample& start, const Sample& end);
+
+    /**
+     * @brief Выводит в журнал расход памяти
+     * @details По этапам: выделения, выделенный объем, VmRSS и VmHWM на
+     * выходе. Итог: наибольший прирост кучи, наибольший VmRSS, исходный
+     * VmRSS и их прирост на один вектор.
+     */
+    static void logReport();
+};
+
+/**
+ * @brief Относит выделения памяти в пределах области видимости к этапу
+ */
+class MemoryScope {
+private:
+    size_t phase;                ///< Этап
+    bool active;                 ///< Учет был включен при создании
+    MemoryTracker::Sample start; ///< Показания при входе
+
+public:
+    /**
+     * @brief Конструктор класса MemoryScope
+     * @param [in] trackedPhase Этап (Metrics::Phase)
+     */
+    explicit MemoryScope(size_t trackedPhase) : phase(trackedPhase), active(MemoryTracker::isEnabled()), start() {
+        if (active) {
+            MemoryTracker::read(start);
+        }
+    }
+
+    /**
+     * @brief Деструктор: относит выделения к этапу
+     */
+    ~MemoryScope() {
+        if (active) {
+            MemoryTracker::Sample end;
+            MemoryTracker::read(end);
+            MemoryTracker::record(phase, start, end);
+        }
+    }
+
+    MemoryScope(const MemoryScope&) = delete;
+    MemoryScope& operator=(const MemoryScope&) = delete;
+};
+
+#endif // MEMORY_TRACKER_H
@@ -0,0 +1,375 @@
+/**
+ * @file Metrics.cpp
+ * @brief Реализация класса Metrics
+ * @details Содержит атомарное хранилище этапов и счетчиков и их вывод в
+ * форматах JSON и Prometheus (text exposition format).
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+
+#include "Metrics.h"
+#include "ErrorHandler.h"
+#include "Logger.h"
+#include "LatencyHistogram.h"
+#include <atomic>
+#include <cstdio>
+#include <time.h>
+
+namespace {
+
+/**
+ * @brief Накопленные данные одного этапа
+ */
+struct PhaseSlot {
+    std::atomic<uint64_t> first{UINT64_MAX};  ///< Первое начало
+    std::atomic<uint64_t> last{0};            ///< Последнее окончание
+    std::atomic<uint64_t> total{0};           ///< Суммарная длительность
+    std::atomic<uint64_t> count{0};           ///< Число входов
+};
+
+/**
+ * @brief Имена этапов в порядке Metrics::Phase
+ */
+const char* const PHASE_NAMES[] = { "config", "parse", "validate", "connect", "authenticate", "send", "receive",
+                                    "save" };
+
+/**
+ * @brief Имена счетчиков в порядке Metrics::Counter
+ */
+const char* const COUNTER_NAMES[] = { "bytes_sent", "bytes_received", "vectors", "results", "syscalls", "retries",
+                                      "bytes_parsed", "bytes_written", "reconnects" };
+
+static_assert(sizeof(PHASE_NAMES) / sizeof(PHASE_NAMES[0]) == Metrics::PHASE_COUNT, "Имена этапов");
+static_assert(sizeof(COUNTER_NAMES) / sizeof(COUNTER_NAMES[0]) == Metrics::COUNTER_COUNT, "Имена счетчиков");
+
+PhaseSlot phases[Metrics::PHASE_COUNT];
+std::atomic<uint64_t> counters[Metrics::COUNTER_COUNT];
+
+/**
+ * @brief Количество классов размерности: floor(log2(размерность)) от 0 до 31
+ */
+const size_t DIMENSION_CLASSES = 32;
+
+/**
+ * @brief Гистограммы задержек ответа по классам размерности
+ */
+LatencyHistogram latency[DIMENSION_CLASSES];
+
+/**
+ * @brief Квантили, выводимые для гистограмм задержек
+ */
+const double QUANTILES[] = { 0.5, 0.9, 0.99, 0.999 };
+const char* const QUANTILE_NAMES[] = { "p50", "p90", "p99", "p99_9" };
+
+/**
+ * @brief Возвращает диапазон размерностей класса в виде "4-7"
+ */
+std::string dimensionRange(size_t dimClass) {
+    const uint64_t low = 1ull << dimClass;
+    return std::to_string(low) + "-" + std::to_string(2 * low - 1);
+}
+
+/**
+ * @brief Складывает гистограммы всех классов размерности
+ */
+void mergeLatency(LatencyHistogram& all) {
+    for (size_t i = 0; i < DIMENSION_CLASSES; ++i) {
+        all.add(latency[i]);
+    }
+}
+
+/**
+ * @brief Читает монотонные часы
+ * @return Наносекунды
+ */
+uint64_t monotonicNs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+/**
+ * @brief Момент запуска программы
+ */
+const uint64_t epoch = monotonicNs();
+
+/**
+ * @brief Переводит наносекунды в секунды
+ */
+double seconds(uint64_t ns) {
+    return static_cast<double>(ns) / 1e9;
+}
+
+/**
+ * @brief Записывает данные в формате JSON
+ */
+void writeJson(FILE* file, bool success, uint64_t wall) {
+    fprintf(file, "{\n  \"success\": %s,\n  \"wall_seconds\": %.9f,\n  \"phases\": {", success ? "true" : "false",
+            seconds(wall));
+    for (int i = 0; i < Metrics::PHASE_COUNT; ++i) {
+        const uint64_t count = phases[i].count.load();
+        const uint64_t first = count > 0 ? phases[i].first.load() : 0;
+        const uint64_t last = count > 0 ? phases[i].last.load() : 0;
+        fprintf(file, "%s\n    \"%s\": {\"count\": %llu, \"duration_seconds\": %.9f, \"start_seconds\": %.9f, "
+                "\"end_seconds\": %.9f}", i == 0 ? "" : ",", PHASE_NAMES[i], static_cast<unsigned long long>(count),
+                seconds(phases[i].total.load()), seconds(first), seconds(last));
+    }
+    fprintf(file, "\n  },\n  \"counters\": {");
+    for (int i = 0; i < Metrics::COUNTER_COUNT; ++i) {
+        fprintf(file, "%s\n    \"%s\": %llu", i == 0 ? "" : ",", COUNTER_NAMES[i],
+                static_cast<unsigned long long>(counters[i].load()));
+    }
+    fprintf(file, "\n  },\n  \"latency_seconds\": [");
+
+    LatencyHistogram all;
+    mergeLatency(all);
+    bool first = true;
+    for (size_t i = 0; i <= DIMENSION_CLASSES; ++i) {
+        const LatencyHistogram& histogram = i < DIMENSION_CLASSES ? latency[i] : all;
+        if (histogram.count() == 0) {
+            continue;
+        }
+        fprintf(file, "%s\n    {\"dimensions\": \"%s\", \"count\": %llu", first ? "" : ",",
+                i < DIMENSION_CLASSES ? dimensionRange(i).c_str() : "all",
+                static_cast<unsigned long long>(histogram.count()));
+        for (size_t q = 0; q < sizeof(QUANTILES) / sizeof(QUANTILES[0]); ++q) {
+            fprintf(file, ", \"%s\": %.9f", QUANTILE_NAMES[q], seconds(histogram.percentile(QUANTILES[q])));
+        }
+        fprintf(file, ", \"max\": %.9f}", seconds(histogram.max()));
+        first = false;
+    }
+    fprintf(file, "%s]\n}\n", first ? "" : "\n  ");
+}
+
+/**
+ * @brief Записывает данные в текстовом формате Prometheus
+ */
+void writePrometheus(FILE* file, bool success, uint64_t wall) {
+    fprintf(file, "# HELP client_success 1 if the run succeeded\n# TYPE client_success gauge\nclient_success %d\n",
+            success ? 1 : 0);
+    fprintf(file, "# HELP client_wall_seconds Run time from start to metrics export\n"
+            "# TYPE client_wall_seconds gauge\nclient_wall_seconds %.9f\n", seconds(wall));
+
+    fprintf(file, "# HELP client_phase_seconds Total time spent in the phase\n# TYPE client_phase_seconds gauge\n");
+    for (int i = 0; i < Metrics::PHASE_COUNT; ++i) {
+        fprintf(file, "client_phase_seconds{phase=\"%s\"} %.9f\n", PHASE_NAMES[i], seconds(phases[i].total.load()));
+    }
+    fprintf(file, "# HELP client_phase_entries Number of times the phase was entered\n"
+            "# TYPE client_phase_entries gauge\n");
+    for (int i = 0; i < Metrics::PHASE_COUNT; ++i) {
+        fprintf(file, "client_phase_entries{phase=\"%s\"} %llu\n", PHASE_NAMES[i],
+                static_cast<unsigned long long>(phases[i].count.load()));
+    }
+    fprintf(file, "# HELP client_phase_start_seconds First start of the phase since program start\n"
+            "# TYPE client_phase_start_seconds gauge\n");
+    for (int i = 0; i < Metrics::PHASE_COUNT; ++i) {
+        if (phases[i].count.load() > 0) {
+            fprintf(file, "client_phase_start_seconds{phase=\"%s\"} %.9f\n", PHASE_NAMES[i],
+                    seconds(phases[i].first.load()));
+        }
+    }
+    fprintf(file, "# HELP client_phase_end_seconds Last end of the phase since program start\n"
+            "# TYPE client_phase_end_seconds gauge\n");
+    for (int i = 0; i < Metrics::PHASE_COUNT; ++i) {
+        if (phases[i].count.load() > 0) {
+            fprintf(file, "client_phase_end_seconds{phase=\"%s\"} %.9f\n", PHASE_NAMES[i],
+                    seconds(phases[i].last.load()));
+        }
+    }
+    for (int i = 0; i < Metrics::COUNTER_COUNT; ++i) {
+        fprintf(file, "# TYPE client_%s_total counter\nclient_%s_total %llu\n", COUNTER_NAMES[i], COUNTER_NAMES[i],
+                static_cast<unsigned long long>(counters[i].load()));
+    }
+
+    fprintf(file, "# HELP client_vector_latency_seconds Time from sending a vector to receiving its result\n"
+            "# TYPE client_vector_latency_seconds summary\n");
+    for (size_t i = 0; i < DIMENSION_CLASSES; ++i) {
+        const LatencyHistogram& histogram = latency[i];
+        if (histogram.count() == 0) {
+            continue;
+        }
+        const std::string range = dimensionRange(i);
+        for (size_t q = 0; q < sizeof(QUANTILES) / sizeof(QUANTILES[0]); ++q) {
+            fprintf(file, "client_vector_latency_seconds{dimensions=\"%s\",quantile=\"%g\"} %.9f\n", range.c_str(),
+                    QUANTILES[q], seconds(histogram.percentile(QUANTILES[q])));
+        }
+        fprintf(file, "client_vector_latency_seconds_sum{dimensions=\"%s\"} %.9f\n", range.c_str(),
+                seconds(histogram.totalSum()));
+        fprintf(file, "client_vector_latency_seconds_count{dimensions=\"%s\"} %llu\n", range.c_str(),
+                static_cast<unsigned long long>(histogram.count()));
+    }
+    fprintf(file, "# HELP client_vector_latency_max_seconds Largest time from sending a vector to its result\n"
+            "# TYPE client_vector_latency_max_seconds gauge\n");
+    for (size_t i = 0; i < DIMENSION_CLASSES; ++i) {
+        if (latency[i].count() > 0) {
+            fprintf(file, "client_vector_latency_max_seconds{dimensions=\"%s\"} %.9f\n", dimensionRange(i).c_str(),
+                    seconds(latency[i].max()));
+        }
+    }
+}
+
+}  // namespace
+
+/**
+ * @brief Возвращает текущее время
+ * @return Наносекунды монотонных часов от запуска программы
+ */
+uint64_t Metrics::now() {
+    return monotonicNs() - epoch;
+}
+
+/**
+ * @brief Возвращает имя этапа
+ * @param [in] phase Этап
+ * @return Имя этапа
+ */
+const char* Metrics::phaseName(Phase phase) {
+    return PHASE_NAMES[phase];
+}
+
+/**
+ * @brief Увеличивает счетчик
+ * @param [in] counter Счетчик
+ * @param [in] value Приращение
+ */
+void Metrics::add(Counter counter, uint64_t value) {
+    counters[counter].fetch_add(value, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Возвращает значение счетчика
+ * @param [in] counter Счетчик
+ * @return Значение
+ */
+uint64_t Metrics::get(Counter counter) {
+    return counters[counter].load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief Учитывает один вход в этап
+ * @param [in] phase Этап
+ * @param [in] start Время начала
+ * @param [in] end Время окончания
+ */
+void Metrics::recordPhase(Phase phase, uint64_t start, uint64_t end) {
+    PhaseSlot& slot = phases[phase];
+    slot.total.fetch_add(end - start, std::memory_order_relaxed);
+    slot.count.fetch_add(1, std::memory_order_relaxed);
+
+    uint64_t first = slot.first.load(std::memory_order_relaxed);
+    while (start < first && !slot.first.compare_exchange_weak(first, start, std::memory_order_relaxed)) {
+    }
+    uint64_t last = slot.last.load(std::memory_order_relaxed);
+    while (end > last && !slot.last.compare_exchange_weak(last, end, std::memory_order_relaxed)) {
+    }
+}
+
+/**
+ * @brief Учитывает одну операцию отправки
+ * @param [in] phase Этап
+ * @param [in] start Время начала операции
+ * @param [in] result Результат операции
+ */
+void Metrics::recordSend(Phase phase, uint64_t start, ssize_t result) {
+    if (result > 0) {
+        add(BYTES_SENT, static_cast<uint64_t>(result));
+    }
+    recordPhase(phase, start, now());
+}
+
+/**
+ * @brief Учитывает одну операцию приема
+ * @param [in] phase Этап
+ * @param [in] start Время начала операции
+ * @param [in] result Результат операции
+ */
+void Metrics::recordReceive(Phase phase, uint64_t start, ssize_t result) {
+    if (result > 0) {
+        add(BYTES_RECEIVED, static_cast<uint64_t>(result));
+    }
+    recordPhase(phase, start, now());
+}
+
+/**
+ * @brief Учитывает задержку ответа на вектор
+ * @param [in] dimension Размерность вектора
+ * @param [in] nanoseconds Время от отправки вектора до получения результата
+ */
+void Metrics::recordLatency(uint32_t dimension, uint64_t nanoseconds) {
+    const size_t dimClass = dimension > 0 ? 31 - static_cast<size_t>(__builtin_clz(dimension)) : 0;
+    latency[dimClass].record(nanoseconds);
+}
+
+/**
+ * @brief Возвращает число учтенных задержек ответа
+ * @return Количество векторов во всех классах размерности
+ */
+uint64_t Metrics::latencyCount() {
+    uint64_t count = 0;
+    for (size_t i = 0; i < DIMENSION_CLASSES; ++i) {
+        count += latency[i].count();
+    }
+    return count;
+}
+
+/**
+ * @brief Выводит в журнал квантили задержек ответа
+ * @details Значения переводятся в микросекунды.
+ */
+void Metrics::logLatency() {
+    LatencyHistogram all;
+    mergeLatency(all);
+    if (all.count() == 0) {
+        return;
+    }
+    size_t classes = 0;
+    for (size_t i = 0; i < DIMENSION_CLASSES; ++i) {
+        classes += latency[i].count() > 0 ? 1 : 0;
+    }
+    // Итог по всем векторам нужен, только если классов размерности несколько
+    for (size_t i = 0; i < (classes > 1 ? DIMENSION_CLASSES + 1 : DIMENSION_CLASSES); ++i) {
+        const LatencyHistogram& histogram = i < DIMENSION_CLASSES ? latency[i] : all;
+        if (histogram.count() == 0) {
+            continue;
+        }
+        char line[256];
+        snprintf(line, sizeof(line), "n=%llu p50=%.1f p90=%.1f p99=%.1f p99.9=%.1f max=%.1f",
+                 static_cast<unsigned long long>(histogram.count()), histogram.percentile(0.5) / 1e3,
+                 histogram.percentile(0.9) / 1e3, histogram.percentile(0.99) / 1e3,
+                 histogram.percentile(0.999) / 1e3, histogram.max() / 1e3);
+        LOG_INFO("Задержка ответа, мкс (" << (i < DIMENSION_CLASSES ? "размерность " + dimensionRange(i)
+                                                                       : std::string("все векторы"))
+                 << "): " << line);
+    }
+}
+
+/**
+ * @brief Записывает собранные данные в файл
+ * @param [in] filename Имя файла
+ * @param [in] success Итог выполнения программы
+ * @return true если файл записан, false в случае ошибки
+ */
+bool Metrics::writeFile(const std::string& filename, bool success) {
+    const uint64_t wall = now();
+    FILE* file = fopen(filename.c_str(), "w");
+    if (file == nullptr) {
+        ErrorHandler::logError("Не удалось открыть файл метрик: " + filename);
+        return false;
+    }
+
+    const std::string suffix = ".prom";
+    const bool prometheus = filename.size() >= suffix.size() &&
+                            filename.compare(filename.size() - suffix.size(), suffix.size(), suffix) == 0;
+    if (prometheus) {
+        writePrometheus(file, success, wall);
+    } else {
+        writeJson(file, success, wall);
+    }
+
+    if (fclose(file) != 0) {
+        ErrorHandler::logError("Ошибка записи в файл: " + filename);
+        return false;
+    }
+    return true;
+}
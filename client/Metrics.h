@@ -0,0 +1,186 @@
+#ifndef METRICS_H
+#define METRICS_H
+
+#include "Tracer.h"
+#include "Profiler.h"
+#include "MemoryTracker.h"
+#include <string>
+#include <cstdint>
+#include <sys/types.h>
+
+/**
+ * @brief Класс для учета времени этапов и счетчиков работы клиента
+ * @details Время берется из монотонных часов (CLOCK_MONOTONIC) и отсчитывается
+ * от запуска программы. Для каждого этапа накапливаются суммарная
+ * длительность, число входов, момент первого начала и последнего окончания.
+ * Этапы отправки и приема состоят из отдельных системных вызовов (или
+ * операций io_uring от постановки в очередь до завершения) и могут
+ * перекрываться между собой и с другими этапами, поэтому их суммарная
+ * длительность может превышать длину интервала от начала до конца.
+ *
+ * Задержки ответа на отдельные векторы (от отправки вектора до получения
+ * его результата) собираются в гистограммы LatencyHistogram по классам
+ * размерности: 1, 2-3, 4-7, ... (степени двойки).
+ *
+ * Все методы безопасны для вызова из нескольких потоков: значения хранятся
+ * в атомарных переменных и обновляются без блокировок.
+ * @warning Все методы являются статическими, экземпляры класса не создаются.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+class Metrics {
+public:
+    /**
+     * @brief Этап работы клиента
+     */
+    enum Phase {
+        CONFIG,        ///< Чтение файла конфигурации
+        PARSE,         ///< Чтение и разбор входного файла
+        VALIDATE,      ///< Проверка векторов
+        CONNECT,       ///< Установка соединения
+        AUTHENTICATE,  ///< Обмен LOGIN/SALT/HASH
+        SEND,          ///< Отправка векторов
+        RECEIVE,       ///< Прием результатов
+        SAVE,          ///< Запись файла результатов
+        PHASE_COUNT    ///< Количество этапов
+    };
+
+    /**
+     * @brief Счетчик
+     */
+    enum Counter {
+        BYTES_SENT,      ///< Байт отправлено серверу
+        BYTES_RECEIVED,  ///< Байт принято от сервера
+        VECTORS,         ///< Векторов отправлено
+        RESULTS,         ///< Результатов получено
+        SYSCALLS,        ///< Системных вызовов ввода-вывода: сеть (io_uring_enter - один вызов) и запись результатов
+        RETRIES,         ///< Повторов после EINTR и частичной передачи
+        BYTES_PARSED,    ///< Байт входного текста разобрано
+        BYTES_WRITTEN,   ///< Байт записано в файл результатов
+        RECONNECTS,      ///< Повторных подключений после разрыва
+        COUNTER_COUNT    ///< Количество счетчиков
+    };
+
+    /**
+     * @brief Возвращает текущее время
+     * @return Наносекунды монотонных часов от запуска программы
+     */
+    static uint64_t now();
+
+    /**
+     * @brief Возвращает имя этапа
+     * @param [in] phase Этап
+     * @return Имя в файле метрик и на шкале трассировки ("parse", "send", ...)
+     */
+    static const char* phaseName(Phase phase);
+
+    /**
+     * @brief Увеличивает счетчик
+     * @param [in] counter Счетчик
+     * @param [in] value Приращение
+     */
+    static void add(Counter counter, uint64_t value = 1);
+
+    /**
+     * @brief Возвращает значение счетчика
+     * @param [in] counter Счетчик
+     */
+    static uint64_t get(Counter counter);
+
+    /**
+     * @brief Учитывает один вход в этап
+     * @param [in] phase Этап
+     * @param [in] start Время начала (now())
+     * @param [in] end Время окончания (now())
+     */
+    static void recordPhase(Phase phase, uint64_t start, uint64_t end);
+
+    /**
+     * @brief Учитывает одну операцию отправки
+     * @param [in] phase Этап, к которому относится операция
+     * @param [in] start Время начала вызова или постановки в очередь io_uring
+     * @param [in] result Результат операции (байты или отрицательное значение)
+     * @details Увеличивает BYTES_SENT и время этапа. Системные вызовы
+     * считаются там, где они выполняются (см. SYSCALLS).
+     */
+    static void recordSend(Phase phase, uint64_t start, ssize_t result);
+
+    /**
+     * @brief Учитывает одну операцию приема
+     * @param [in] phase Этап, к которому относится операция
+     * @param [in] start Время начала вызова или постановки в очередь io_uring
+     * @param [in] result Результат операции (байты или отрицательное значение)
+     * @details Увеличивает BYTES_RECEIVED и время этапа.
+     */
+    static void recordReceive(Phase phase, uint64_t start, ssize_t result);
+
+    /**
+     * @brief Учитывает задержку ответа на вектор
+     * @param [in] dimension Размерность вектора
+     * @param [in] nanoseconds Время от отправки вектора до получения результата
+     */
+    static void recordLatency(uint32_t dimension, uint64_t nanoseconds);
+
+    /**
+     * @brief Возвращает число учтенных задержек ответа
+     * @return Количество векторов во всех классах размерности
+     */
+    static uint64_t latencyCount();
+
+    /**
+     * @brief Выводит в журнал квантили задержек ответа
+     * @details Для каждого класса размерности и для всех векторов вместе -
+     * p50, p90, p99, p99.9 и максимум в микросекундах. Если задержки не
+     * собирались, ничего не выводит.
+     */
+    static void logLatency();
+
+    /**
+     * @brief Записывает собранные данные в файл
+     * @param [in] filename Имя файла; расширение .prom выбирает текстовый
+     * формат Prometheus, иначе JSON
+     * @param [in] success Итог выполнения программы
+     * @return true если файл записан, false в случае ошибки
+     */
+    static bool writeFile(const std::string& filename, bool success);
+};
+
+/**
+ * @brief Учитывает время этапа в пределах области видимости
+ * @details При включенной трассировке этап также попадает на шкалу
+ * отрезком категории "stage", при включенном профиле к этапу относятся
+ * события процессора (ProfileScope), при включенном учете памяти -
+ * выделения и размер процесса (MemoryScope).
+ */
+class PhaseTimer {
+private:
+    Metrics::Phase phase;  ///< Этап
+    uint64_t start;        ///< Время входа
+    ProfileScope profile;  ///< События процессора этапа
+    MemoryScope memory;    ///< Выделения памяти этапа
+
+public:
+    /**
+     * @brief Конструктор класса PhaseTimer
+     * @param [in] timedPhase Этап, время которого отсчитывается с этого момента
+     */
+    explicit PhaseTimer(Metrics::Phase timedPhase) : phase(timedPhase), start(Metrics::now()), profile(timedPhase),
+                                                       memory(timedPhase) {}
+
+    /**
+     * @brief Деструктор: учитывает вход в этап
+     */
+    ~PhaseTimer() {
+        const uint64_t end = Metrics::now();
+        Metrics::recordPhase(phase, start, end);
+        if (Tracer::isEnabled()) {
+            Tracer::span(Metrics::phaseName(phase), "stage", start, end);
+        }
+    }
+
+    PhaseTimer(const PhaseTimer&) = delete;
+    PhaseTimer& operator=(const PhaseTimer&) = delete;
+};
+
+#endif // METRICS_H
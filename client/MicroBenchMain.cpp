@@ -0,0 +1,417 @@
+/**
+ * @file MicroBenchMain.cpp
+ * @brief Микробенчмарки горячих функций клиента
+ * @details Каждая функция замеряется отдельно: чтение текстового и vbin файла
+ * (DataProcessor::readVectorsFromFile), проверка (validateData), перевод в
+ * двоичный вид (convertToBinary), сохранение результатов (saveResults),
+ * функции Authenticator и обмен векторами через ServerConnection по паре
+ * сокетов (socketpair) с ReferenceServer в соседнем потоке, без TCP.
+ * После прогрева число повторов в выборке подбирается так, чтобы выборка
+ * длилась заметное время; по выборкам считаются среднее, медиана,
+ * отклонение, минимум, максимум и 95-й процентиль времени операции.
+ * Результат выводится в формате JSON.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+
+#include "ReferenceServer.h"
+#include "DataProcessor.h"
+#include "ServerConnection.h"
+#include "Authenticator.h"
+#include "ErrorHandler.h"
+#include "Logger.h"
+#include <iostream>
+#include <functional>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief Параметры микробенчмарков
+ */
+struct MicroBenchConfig {
+    size_t count;          ///< Количество векторов
+    std::string dims;      ///< Распределение размеров: fixed:N или uniform:MIN:MAX
+    uint32_t dimMin;       ///< Наименьший размер вектора
+    uint32_t dimMax;       ///< Наибольший размер вектора
+    size_t fileSize;       ///< Желаемый размер входного файла в байтах (0 - по count)
+    size_t window;         ///< Окно конвейера для обмена
+    std::string io;        ///< Механизм ввода-вывода
+    int samples;           ///< Количество выборок
+    double minTimeMs;      ///< Минимальное время одного замера в миллисекундах
+    std::string filter;    ///< Подстрока имени для выбора замеров
+    std::string output;    ///< Файл JSON (пусто - стандартный вывод)
+};
+
+/**
+ * @brief Один замеряемый случай
+ */
+struct MicroBenchCase {
+    std::string name;              ///< Имя замера
+    std::function<bool()> op;      ///< Одна операция
+    double items;                  ///< Элементов за операцию (векторов, хешей)
+    double bytes;                  ///< Байт за операцию
+};
+
+/**
+ * @brief Статистика замера
+ */
+struct MicroBenchStats {
+    size_t iterations;   ///< Операций в одной выборке
+    double mean;         ///< Среднее время операции, нс
+    double median;       ///< Медиана, нс
+    double stddev;       ///< Стандартное отклонение, нс
+    double min;          ///< Минимум, нс
+    double max;          ///< Максимум, нс
+    double p95;          ///< 95-й процентиль, нс
+};
+
+typedef std::chrono::steady_clock Clock;
+
+/**
+ * @brief Разбирает распределение размеров векторов
+ * @param [in,out] config Параметры; заполняются dimMin и dimMax
+ * @return true если описание корректно
+ */
+static bool parseDims(MicroBenchConfig& config) {
+    unsigned long low = 0;
+    unsigned long high = 0;
+    if (sscanf(config.dims.c_str(), "fixed:%lu", &low) == 1) {
+        high = low;
+    } else if (sscanf(config.dims.c_str(), "uniform:%lu:%lu", &low, &high) != 2) {
+        return false;
+    }
+    if (low == 0 || high < low || high > 0xFFFFFFFFul) {
+        return false;
+    }
+    config.dimMin = static_cast<uint32_t>(low);
+    config.dimMax = static_cast<uint32_t>(high);
+    return true;
+}
+
+/**
+ * @brief Создает входной текстовый файл
+ * @param [in] config Параметры (count, dimMin, dimMax, fileSize)
+ * @param [in] filename Имя файла
+ * @return true если файл записан
+ * @details При заданном fileSize векторы добавляются, пока файл не достигнет
+ * нужного размера; количество векторов пишется в начало с запасом пробелов.
+ */
+static bool generateInput(const MicroBenchConfig& config, const std::string& filename) {
+    FILE* file = fopen(filename.c_str(), "w");
+    if (file == nullptr) {
+        ErrorHandler::logError("Не удалось создать файл " + filename);
+        return false;
+    }
+
+    std::mt19937_64 generator(config.count * 131 + config.dimMin * 7 + config.dimMax);
+    std::uniform_real_distribution<double> values(-1000.0, 1000.0);
+    std::uniform_int_distribution<uint32_t> sizes(config.dimMin, config.dimMax);
+
+    // Место под количество: число дописывается в конце поверх пробелов
+    fprintf(file, "%20s\n", "");
+    size_t written = 0;
+    long bytes = ftell(file);
+    while (config.fileSize > 0 ? static_cast<size_t>(bytes) < config.fileSize : written < config.count) {
+        const uint32_t dim = sizes(generator);
+        bytes += fprintf(file, "%u\n", dim);
+        for (uint32_t j = 0; j < dim; ++j) {
+            bytes += fprintf(file, j == 0 ? "%.17g" : " %.17g", values(generator));
+        }
+        fputc('\n', file);
+        ++bytes;
+        ++written;
+    }
+    rewind(file);
+    fprintf(file, "%-20zu", written);
+
+    return fclose(file) == 0;
+}
+
+/**
+ * @brief Возвращает размер файла в байтах
+ */
+static double fileBytes(const std::string& filename) {
+    struct stat info;
+    return stat(filename.c_str(), &info) == 0 ? static_cast<double>(info.st_size) : 0.0;
+}
+
+/**
+ * @brief Выполняет операцию заданное число раз
+ * @param [in] op Операция
+ * @param [in] iterations Количество повторов
+ * @param [out] ns Время в наносекундах
+ * @return true если все операции успешны
+ */
+static bool timeIterations(const std::function<bool()>& op, size_t iterations, double& ns) {
+    const Clock::time_point start = Clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        if (!op()) {
+            return false;
+        }
+    }
+    ns = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+    return true;
+}
+
+/**
+ * @brief Замеряет один случай
+ * @param [in] config Параметры
+ * @param [in] benchCase Случай
+ * @param [out] stats Статистика
+ * @return true если все операции успешны
+ * @details Первый вызов - прогрев. Затем число операций в выборке удваивается,
+ * пока выборка не займет minTimeMs, и снимаются samples выборок.
+ */
+static bool measure(const MicroBenchConfig& config, const MicroBenchCase& benchCase, MicroBenchStats& stats) {
+    double ns = 0.0;
+    if (!timeIterations(benchCase.op, 1, ns)) {
+        return false;
+    }
+
+    const double minNs = config.minTimeMs * 1e6;
+    size_t iterations = 1;
+    while (ns < minNs && iterations < (static_cast<size_t>(1) << 30)) {
+        iterations *= 2;
+        if (!timeIterations(benchCase.op, iterations, ns)) {
+            return false;
+        }
+    }
+
+    std::vector<double> perOp(config.samples);
+    for (int i = 0; i < config.samples; ++i) {
+        if (!timeIterations(benchCase.op, iterations, ns)) {
+            return false;
+        }
+        perOp[i] = ns / iterations;
+    }
+
+    std::sort(perOp.begin(), perOp.end());
+    double sum = 0.0;
+    for (double value : perOp) {
+        sum += value;
+    }
+    stats.iterations = iterations;
+    stats.mean = sum / perOp.size();
+    double squares = 0.0;
+    for (double value : perOp) {
+        squares += (value - stats.mean) * (value - stats.mean);
+    }
+    stats.stddev = perOp.size() > 1 ? std::sqrt(squares / (perOp.size() - 1)) : 0.0;
+    stats.min = perOp.front();
+    stats.max = perOp.back();
+    const size_t middle = perOp.size() / 2;
+    stats.median = perOp.size() % 2 ? perOp[middle] : (perOp[middle - 1] + perOp[middle]) / 2.0;
+    stats.p95 = perOp[std::min(perOp.size() - 1, static_cast<size_t>(std::ceil(0.95 * perOp.size())) - 1)];
+    return true;
+}
+
+/**
+ * @brief Разбирает параметры командной строки
+ * @param [in] argc Количество аргументов
+ * @param [in] argv Аргументы
+ * @param [out] config Параметры
+ * @return true если параметры корректны
+ */
+static bool parseArgs(int argc, char* argv[], MicroBenchConfig& config) {
+    config.count = 10000;
+    config.dims = "uniform:1:64";
+    config.fileSize = 0;
+    config.window = 1024;
+    config.io = "auto";
+    config.samples = 10;
+    config.minTimeMs = 50.0;
+
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (strcmp(argv[i], "--count") == 0 && hasValue) {
+            long long value = std::atoll(argv[++i]);
+            if (value <= 0) {
+                return false;
+            }
+            config.count = static_cast<size_t>(value);
+        } else if (strcmp(argv[i], "--dims") == 0 && hasValue) {
+            config.dims = argv[++i];
+        } else if (strcmp(argv[i], "--file-size") == 0 && hasValue) {
+            long long value = std::atoll(argv[++i]);
+            if (value <= 0) {
+                return false;
+            }
+            config.fileSize = static_cast<size_t>(value);
+        } else if (strcmp(argv[i], "-w") == 0 && hasValue) {
+            long long value = std::atoll(argv[++i]);
+            if (value <= 0) {
+                return false;
+            }
+            config.window = static_cast<size_t>(value);
+        } else if (strcmp(argv[i], "--io") == 0 && hasValue) {
+            config.io = argv[++i];
+            if (!IoBackend::isValidKind(config.io)) {
+                return false;
+            }
+        } else if (strcmp(argv[i], "--samples") == 0 && hasValue) {
+            config.samples = std::atoi(argv[++i]);
+            if (config.samples <= 0) {
+                return false;
+            }
+        } else if (strcmp(argv[i], "--min-time-ms") == 0 && hasValue) {
+            config.minTimeMs = std::atof(argv[++i]);
+            if (config.minTimeMs <= 0) {
+                return false;
+            }
+        } else if (strcmp(argv[i], "--filter") == 0 && hasValue) {
+            config.filter = argv[++i];
+        } else if (strcmp(argv[i], "-o") == 0 && hasValue) {
+            config.output = argv[++i];
+        } else {
+            return false;
+        }
+    }
+    return parseDims(config);
+}
+
+/**
+ * @brief Точка входа программы микробенчмарков
+ * @param [in] argc Количество аргументов командной строки
+ * @param [in] argv Массив аргументов командной строки
+ * @return EXIT_SUCCESS если все замеры успешны, иначе EXIT_FAILURE
+ * @details Параметры:
+ *   --count <N> - количество векторов (по умолчанию: 10000)
+ *   --dims <распределение> - fixed:N или uniform:MIN:MAX (по умолчанию: uniform:1:64)
+ *   --file-size <байт> - размер входного файла вместо --count
+ *   -w <окно> - окно конвейера для обмена (по умолчанию: 1024)
+ *   --io <механизм> - auto, uring или blocking (по умолчанию: auto)
+ *   --samples <N> - количество выборок (по умолчанию: 10)
+ *   --min-time-ms <мс> - минимальная длительность выборки (по умолчанию: 50)
+ *   --filter <подстрока> - выполнять только замеры с подстрокой в имени
+ *   -o <файл> - записать JSON в файл вместо стандартного вывода
+ */
+int main(int argc, char* argv[]) {
+    MicroBenchConfig config;
+    if (!parseArgs(argc, argv, config)) {
+        std::cerr << "Использование: ./client_microbench [--count <N>] [--dims fixed:N|uniform:MIN:MAX]"
+                     " [--file-size <байт>] [-w <окно>] [--io <механизм>] [--samples <N>]"
+                     " [--min-time-ms <мс>] [--filter <подстрока>] [-o <файл>]\n";
+        return EXIT_FAILURE;
+    }
+
+    const std::string prefix = "/tmp/client_microbench_" + std::to_string(getpid());
+    const std::string textInput = prefix + "_in.txt";
+    const std::string vbinInput = prefix + "_in.vbin";
+    const std::string output = prefix + "_out.txt";
+
+    // Журнал клиента не смешивается с результатами замеров: выводятся только ошибки
+    Logger::setLevel(LOG_LEVEL_ERROR);
+
+    DataProcessor data;
+    if (!generateInput(config, textInput) || !data.readVectorsFromFile(textInput) ||
+        !data.saveVectors(vbinInput, true)) {
+        unlink(textInput.c_str());
+        return EXIT_FAILURE;
+    }
+
+    const VectorStore& vectors = data.getVectors();
+    const double count = static_cast<double>(vectors.size());
+    const double wireBytes = static_cast<double>(vectors.wireBytes(0, vectors.size()));
+    std::vector<double> results(vectors.size());
+    for (size_t i = 0; i < vectors.size(); ++i) {
+        VectorView view = vectors[i];
+        results[i] = ReferenceServer::processVector(view.data(), view.size());
+    }
+
+    // Обмен по паре сокетов: сервер обслуживает второй конец в своем потоке
+    ReferenceServer server("bench", "bench");
+    ServerConnection connection;
+    std::thread serverThread;
+    int pair[2];
+    bool framingReady = false;
+    if (socketpair(AF_UNIX, SOCK_STREAM, 0, pair) == 0) {
+        serverThread = std::thread([&server, fd = pair[1]]() { server.serveSocket(fd); });
+        connection.adoptSocket(pair[0]);
+        connection.setPipelineWindow(config.window);
+        connection.setIoBackend(config.io);
+        framingReady = connection.authenticate("bench", "bench");
+    }
+
+    const std::string salt = Authenticator::generateSalt();
+    const std::string hash = Authenticator::computeHash(salt, "P@ssW0rd");
+    std::vector<double> received;
+
+    std::vector<MicroBenchCase> cases = {
+        {"read_text", [&]() { DataProcessor reader; return reader.readVectorsFromFile(textInput); },
+         count, fileBytes(textInput)},
+        {"read_vbin", [&]() { DataProcessor reader; return reader.readVectorsFromFile(vbinInput); },
+         count, fileBytes(vbinInput)},
+        {"validate", [&]() { return data.validateData(); }, count, wireBytes},
+        {"convert_to_binary", [&]() { return !data.convertToBinary().empty(); }, count, wireBytes},
+        {"save_results", [&]() { return data.saveResults(output, results); }, count,
+         count * sizeof(double)},
+        {"compute_hash", [&]() { return Authenticator::computeHash(salt, "P@ssW0rd").size() == 40; }, 1.0,
+         static_cast<double>(salt.size() + 8)},
+        {"generate_salt", []() { return Authenticator::generateSalt().size() == 16; }, 1.0, 8.0},
+        {"hex_to_string", [&]() { return Authenticator::hexToString(hash).size() == 20; }, 1.0,
+         static_cast<double>(hash.size())},
+        {"framing_socketpair", [&]() {
+             return framingReady && connection.sendVectors(vectors, received) && received == results;
+         }, count, wireBytes + count * sizeof(double)},
+    };
+
+    FILE* json = config.output.empty() ? stdout : fopen(config.output.c_str(), "w");
+    if (json == nullptr) {
+        ErrorHandler::logError("Не удалось создать файл " + config.output);
+        return EXIT_FAILURE;
+    }
+
+    fprintf(json, "{\n  \"parameters\": {\"vectors\": %zu, \"dims\": \"%s\", \"file_bytes\": %.0f, "
+            "\"window\": %zu, \"io\": \"%s\", \"samples\": %d, \"min_time_ms\": %g},\n  \"benchmarks\": [",
+            vectors.size(), config.dims.c_str(), fileBytes(textInput), config.window, config.io.c_str(),
+            config.samples, config.minTimeMs);
+
+    bool allOk = true;
+    bool first = true;
+    for (const MicroBenchCase& benchCase : cases) {
+        if (benchCase.name.find(config.filter) == std::string::npos) {
+            continue;
+        }
+        MicroBenchStats stats;
+        if (!measure(config, benchCase, stats)) {
+            ErrorHandler::logError("Замер " + benchCase.name + " завершился ошибкой");
+            allOk = false;
+            continue;
+        }
+        const double seconds = stats.median / 1e9;
+        fprintf(json, "%s\n    {\"name\": \"%s\", \"iterations\": %zu, \"ns_per_op\": {\"mean\": %.1f, "
+                "\"median\": %.1f, \"stddev\": %.1f, \"min\": %.1f, \"max\": %.1f, \"p95\": %.1f}, "
+                "\"items_per_second\": %.1f, \"bytes_per_second\": %.1f}",
+                first ? "" : ",", benchCase.name.c_str(), stats.iterations, stats.mean, stats.median,
+                stats.stddev, stats.min, stats.max, stats.p95, benchCase.items / seconds,
+                benchCase.bytes / seconds);
+        fflush(json);
+        first = false;
+    }
+    fprintf(json, "\n  ]\n}\n");
+    if (json != stdout) {
+        fclose(json);
+    }
+
+    connection.closeConnection();
+    if (serverThread.joinable()) {
+        serverThread.join();
+    }
+
+    unlink(textInput.c_str());
+    unlink(vbinInput.c_str());
+    unlink(output.c_str());
+    return allOk ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,264 @@
+/**
+ * @file Profiler.cpp
+ * @brief Реализация класса Profiler
+ * @details Счетчики perf_event_open() открываются по одному, без группы:
+ * недоступное событие не мешает остальным. При мультиплексировании
+ * значения масштабируются по времени работы счетчика.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+
+#include "Profiler.h"
+#include "Metrics.h"
+#include "Logger.h"
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/resource.h>
+#include <unistd.h>
+#include <errno.h>
+#include <cstring>
+#include <cstdio>
+#include <string>
+
+namespace {
+
+/**
+ * @brief Описание события perf_event_open()
+ */
+struct EventSpec {
+    uint32_t type;    ///< PERF_TYPE_HARDWARE или PERF_TYPE_SOFTWARE
+    uint64_t config;  ///< Номер события
+};
+
+/**
+ * @brief События в порядке Profiler::Event
+ */
+const EventSpec EVENTS[] = {
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+    { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_TASK_CLOCK },
+    { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES },
+    { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS },
+};
+
+static_assert(sizeof(EVENTS) / sizeof(EVENTS[0]) == Profiler::EVENT_COUNT, "События профиля");
+
+int fds[Profiler::EVENT_COUNT] = { -1, -1, -1, -1, -1, -1, -1 };  ///< Дескрипторы счетчиков
+bool useRusage = false;  ///< Программные события берутся из getrusage()
+
+std::atomic<uint64_t> totals[Metrics::PHASE_COUNT][Profiler::EVENT_COUNT];  ///< События по этапам
+std::atomic<uint64_t> entries[Metrics::PHASE_COUNT];                        ///< Входы в этапы
+
+/**
+ * @brief Открывает счетчик события для процесса
+ * @param [in] spec Событие
+ * @return Дескриптор или -1 с кодом ошибки в errno
+ * @details Сначала с учетом режима ядра; если это запрещено
+ * perf_event_paranoid - только пользовательский режим.
+ */
+int openCounter(const EventSpec& spec) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = spec.type;
+    attr.config = spec.config;
+    attr.inherit = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+    int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+    if (fd < 0 && (errno == EACCES || errno == EPERM)) {
+        attr.exclude_kernel = 1;
+        fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+    }
+    return fd;
+}
+
+/**
+ * @brief Читает счетчик
+ * @param [in] fd Дескриптор
+ * @return Значение, приведенное к полному времени работы, или 0
+ */
+uint64_t readCounter(int fd) {
+    uint64_t data[3];  // Значение, время включения, время счета
+    if (::read(fd, data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)) || data[2] == 0) {
+        return 0;
+    }
+    if (data[2] >= data[1]) {
+        return data[0];
+    }
+    return static_cast<uint64_t>(static_cast<double>(data[0]) * static_cast<double>(data[1]) /
+                                 static_cast<double>(data[2]));
+}
+
+/**
+ * @brief Проверяет, доступно ли событие
+ */
+bool available(Profiler::Event event) {
+    return fds[event] >= 0 || (useRusage && event >= Profiler::TASK_CLOCK);
+}
+
+/**
+ * @brief Добавляет к строке отчета количество промахов и их долю на вектор и на МБ
+ * @param [in,out] line Строка отчета
+ * @param [in] name Название величины
+ * @param [in] value Количество
+ * @param [in] vectors Векторов обработано (0 - доля не выводится)
+ * @param [in] bytes Байт данных этапа (0 - доля не выводится)
+ */
+void appendMisses(std::string& line, const char* name, uint64_t value, uint64_t vectors, uint64_t bytes) {
+    char buffer[160];
+    snprintf(buffer, sizeof(buffer), ", %s %llu", name, static_cast<unsigned long long>(value));
+    line += buffer;
+    if (vectors > 0 || bytes > 0) {
+        line += " (";
+        if (vectors > 0) {
+            snprintf(buffer, sizeof(buffer), "%.3g на вектор", static_cast<double>(value) / vectors);
+            line += buffer;
+        }
+        if (bytes > 0) {
+            snprintf(buffer, sizeof(buffer), "%s%.4g на МБ", vectors > 0 ? ", " : "",
+                     static_cast<double>(value) * (1 << 20) / bytes);
+            line += buffer;
+        }
+        line += ")";
+    }
+}
+
+/**
+ * @brief Возвращает объем данных этапа
+ * @param [in] phase Этап
+ * @return Байт входного текста для разбора, отправленных для отправки,
+ * записанных для сохранения; 0 для остальных этапов
+ */
+uint64_t phaseBytes(size_t phase) {
+    switch (phase) {
+        case Metrics::PARSE:
+            return Metrics::get(Metrics::BYTES_PARSED);
+        case Metrics::SEND:
+            return Metrics::get(Metrics::BYTES_SENT);
+        case Metrics::SAVE:
+            return Metrics::get(Metrics::BYTES_WRITTEN);
+        default:
+            return 0;
+    }
+}
+
+}  // namespace
+
+/**
+ * @brief Открывает счетчики
+ */
+void Profiler::enable() {
+    if (isEnabled()) {
+        return;
+    }
+    int hardwareError = 0;
+    int softwareError = 0;
+    for (int i = 0; i < EVENT_COUNT; ++i) {
+        fds[i] = openCounter(EVENTS[i]);
+        if (fds[i] < 0) {
+            (EVENTS[i].type == PERF_TYPE_HARDWARE ? hardwareError : softwareError) = errno;
+        }
+    }
+
+    if (fds[TASK_CLOCK] < 0 && fds[CONTEXT_SWITCHES] < 0 && fds[PAGE_FAULTS] < 0) {
+        useRusage = true;
+        LOG_WARNING("perf_event_open недоступен (" << strerror(softwareError)
+                    << "): процессорное время, переключения и страничные ошибки берутся из getrusage()");
+    }
+    if (fds[CYCLES] < 0 && fds[INSTRUCTIONS] < 0 && fds[CACHE_MISSES] < 0 && fds[BRANCH_MISSES] < 0) {
+        LOG_WARNING("Аппаратные счетчики процессора недоступны (" << strerror(hardwareError)
+                    << "): профиль только по программным событиям");
+    }
+    enabled.store(true, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Читает счетчики
+ * @param [out] sample Показания
+ */
+void Profiler::read(Sample& sample) {
+    for (int i = 0; i < EVENT_COUNT; ++i) {
+        sample.values[i] = fds[i] >= 0 ? readCounter(fds[i]) : 0;
+    }
+    if (useRusage) {
+        struct rusage usage;
+        if (getrusage(RUSAGE_SELF, &usage) == 0) {
+            const uint64_t user = static_cast<uint64_t>(usage.ru_utime.tv_sec) * 1000000 + usage.ru_utime.tv_usec;
+            const uint64_t system = static_cast<uint64_t>(usage.ru_stime.tv_sec) * 1000000 + usage.ru_stime.tv_usec;
+            sample.values[TASK_CLOCK] = (user + system) * 1000;
+            sample.values[CONTEXT_SWITCHES] = static_cast<uint64_t>(usage.ru_nvcsw + usage.ru_nivcsw);
+            sample.values[PAGE_FAULTS] = static_cast<uint64_t>(usage.ru_minflt + usage.ru_majflt);
+        }
+    }
+}
+
+/**
+ * @brief Относит разность показаний к этапу
+ * @param [in] phase Этап
+ * @param [in] start Показания при входе
+ * @param [in] end Показания при выходе
+ */
+void Profiler::record(size_t phase, const Sample& start, const Sample& end) {
+    for (int i = 0; i < EVENT_COUNT; ++i) {
+        if (end.values[i] > start.values[i]) {
+            totals[phase][i].fetch_add(end.values[i] - start.values[i], std::memory_order_relaxed);
+        }
+    }
+    entries[phase].fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Выводит в журнал профиль этапов
+ * @details Доли на вектор считаются по числу отправленных векторов, доли
+ * на МБ - по объему данных этапа (phaseBytes()).
+ */
+void Profiler::logReport() {
+    if (!isEnabled()) {
+        return;
+    }
+    const uint64_t vectors = Metrics::get(Metrics::VECTORS);
+    for (size_t phase = 0; phase < Metrics::PHASE_COUNT; ++phase) {
+        if (entries[phase].load() == 0) {
+            continue;
+        }
+        uint64_t value[EVENT_COUNT];
+        for (int i = 0; i < EVENT_COUNT; ++i) {
+            value[i] = totals[phase][i].load();
+        }
+
+        char buffer[160];
+        std::string line;
+        snprintf(buffer, sizeof(buffer), "процессорное время %.6f с", static_cast<double>(value[TASK_CLOCK]) / 1e9);
+        line += buffer;
+        if (available(CYCLES)) {
+            snprintf(buffer, sizeof(buffer), ", тактов %llu", static_cast<unsigned long long>(value[CYCLES]));
+            line += buffer;
+        }
+        if (available(INSTRUCTIONS)) {
+            snprintf(buffer, sizeof(buffer), ", инструкций %llu", static_cast<unsigned long long>(value[INSTRUCTIONS]));
+            line += buffer;
+        }
+        if (available(CYCLES) && available(INSTRUCTIONS) && value[CYCLES] > 0) {
+            snprintf(buffer, sizeof(buffer), ", IPC %.2f",
+                     static_cast<double>(value[INSTRUCTIONS]) / static_cast<double>(value[CYCLES]));
+            line += buffer;
+        }
+        const uint64_t bytes = phaseBytes(phase);
+        if (available(CACHE_MISSES)) {
+            appendMisses(line, "промахов кэша", value[CACHE_MISSES], vectors, bytes);
+        }
+        if (available(BRANCH_MISSES)) {
+            appendMisses(line, "ошибок предсказания", value[BRANCH_MISSES], vectors, bytes);
+        }
+        appendMisses(line, "страничных ошибок", value[PAGE_FAULTS], vectors, bytes);
+        snprintf(buffer, sizeof(buffer), ", переключений контекста %llu",
+                 static_cast<unsigned long long>(value[CONTEXT_SWITCHES]));
+        line += buffer;
+        LOG_INFO("Профиль " << Metrics::phaseName(static_cast<Metrics::Phase>(phase)) << ": " << line);
+    }
+}
@@ -0,0 +1,122 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Счетчики производительности процессора по этапам работы клиента
+ * @details Счетчики открываются perf_event_open() для всего процесса с
+ * наследованием потоками, созданными позже, и читаются на границах этапов
+ * (PhaseTimer и ProfileScope). Разность показаний относится к этапу.
+ *
+ * Если аппаратные события недоступны (нет PMU в виртуальной машине,
+ * ограничение perf_event_paranoid), используются программные события ядра:
+ * процессорное время, переключения контекста и страничные ошибки. Если
+ * недоступен и perf_event_open(), те же величины берутся из getrusage().
+ *
+ * Счетчики общие для процесса, поэтому этапы, выполняемые одновременно
+ * (потоковый режим, несколько соединений), получают и чужие события.
+ * @warning Все методы являются статическими, экземпляры класса не создаются.
+ * enable() вызывается до создания рабочих потоков.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+class Profiler {
+private:
+    static inline std::atomic<bool> enabled{false};  ///< Счетчики открыты
+
+public:
+    /**
+     * @brief Событие
+     */
+    enum Event {
+        CYCLES,            ///< Такты процессора
+        INSTRUCTIONS,      ///< Выполненные инструкции
+        CACHE_MISSES,      ///< Промахи последнего уровня кэша
+        BRANCH_MISSES,     ///< Ошибки предсказания ветвлений
+        TASK_CLOCK,        ///< Процессорное время, нс
+        CONTEXT_SWITCHES,  ///< Переключения контекста
+        PAGE_FAULTS,       ///< Страничные ошибки
+        EVENT_COUNT        ///< Количество событий
+    };
+
+    /**
+     * @brief Показания всех счетчиков
+     */
+    struct Sample {
+        uint64_t values[EVENT_COUNT];  ///< Значения в порядке Event
+    };
+
+    /**
+     * @brief Открывает счетчики
+     * @details Недоступные аппаратные события пропускаются с предупреждением.
+     */
+    static void enable();
+
+    /**
+     * @brief Проверяет, включен ли профиль
+     */
+    static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Читает счетчики
+     * @param [out] sample Показания; недоступные события равны 0
+     */
+    static void read(Sample& sample);
+
+    /**
+     * @brief Относит разность показаний к этапу
+     * @param [in] phase Этап (Metrics::Phase)
+     * @param [in] start Показания при входе в этап
+     * @param [in] end Показания при выходе из этапа
+     */
+    static void record(size_t phase, const Sample& start, const Sample& end);
+
+    /**
+     * @brief Выводит в журнал профиль этапов
+     * @details Для каждого этапа: такты, инструкции, IPC, промахи кэша и
+     * ошибки предсказания (в том числе на вектор и на МБ данных этапа),
+     * процессорное время, переключения контекста и страничные ошибки.
+     */
+    static void logReport();
+};
+
+/**
+ * @brief Относит события процессора в пределах области видимости к этапу
+ */
+class ProfileScope {
+private:
+    size_t phase;             ///< Этап
+    bool active;              ///< Профиль был включен при создании
+    Profiler::Sample start;   ///< Показания при входе
+
+public:
+    /**
+     * @brief Конструктор класса ProfileScope
+     * @param [in] profiledPhase Этап (Metrics::Phase)
+     */
+    explicit ProfileScope(size_t profiledPhase) : phase(profiledPhase), active(Profiler::isEnabled()) {
+        if (active) {
+            Profiler::read(start);
+        }
+    }
+
+    /**
+     * @brief Деструктор: относит события к этапу
+     */
+    ~ProfileScope() {
+        if (active) {
+            Profiler::Sample end;
+            Profiler::read(end);
+            Profiler::record(phase, start, end);
+        }
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+};
+
+#endif // PROFILER_H
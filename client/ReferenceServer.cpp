@@ -0,0 +1,322 @@
+/**
+ * @file ReferenceServer.cpp
+ * @brief Реализация класса ReferenceServer
+ * @details Чтение из сокета буферизуется. Результаты копятся в выходном
+ * буфере и отправляются перед каждым ожиданием новых данных, поэтому
+ * клиент в режиме "отправил - дождался ответа" получает ответ сразу,
+ * а при конвейерной отправке результаты уходят пачками.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+
+#include "ReferenceServer.h"
+#include "Authenticator.h"
+#include "ErrorHandler.h"
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <cstring>
+#include <vector>
+#include <errno.h>
+#include <algorithm>
+
+namespace {
+
+/**
+ * @brief Буферизованный обмен с клиентом
+ */
+class SessionIo {
+private:
+    int fd;                    ///< Сокет клиента
+    std::vector<char> input;   ///< Буфер чтения
+    size_t inputPos;           ///< Первый непрочитанный байт
+    size_t inputEnd;           ///< Конец данных в буфере
+    std::vector<char> output;  ///< Неотправленные данные
+    
+public:
+    explicit SessionIo(int socketFD) : fd(socketFD), input(64 * 1024), inputPos(0), inputEnd(0) {}
+    
+    /**
+     * @brief Отправляет накопленные данные
+     * @return true если отправка успешна
+     */
+    bool flush() {
+        size_t sent = 0;
+        while (sent < output.size()) {
+            ssize_t written = send(fd, output.data() + sent, output.size() - sent, MSG_NOSIGNAL);
+            if (written < 0 && errno == EINTR) continue;
+            if (written <= 0) return false;
+            sent += static_cast<size_t>(written);
+        }
+        output.clear();
+        return true;
+    }
+    
+    /**
+     * @brief Добавляет данные в выходной буфер
+     */
+    void write(const void* data, size_t size) {
+        const char* bytes = static_cast<const char*>(data);
+        output.insert(output.end(), bytes, bytes + size);
+    }
+    
+    /**
+     * @brief Дочитывает данные из сокета, предварительно отправив ответы
+     * @return false при закрытии соединения или ошибке
+     */
+    bool fill() {
+        if (!flush()) return false;
+        if (inputPos == inputEnd) {
+            inputPos = inputEnd = 0;
+        }
+        for (;;) {
+            ssize_t got = recv(fd, input.data() + inputEnd, input.size() - inputEnd, 0);
+            if (got < 0 && errno == EINTR) continue;
+            if (got <= 0) return false;
+            inputEnd += static_cast<size_t>(got);
+            return true;
+        }
+    }
+    
+    /**
+     * @brief Читает ровно size байтов
+     */
+    bool read(void* data, size_t size) {
+        char* out = static_cast<char*>(data);
+        while (size > 0) {
+            if (inputPos == inputEnd && !fill()) return false;
+            size_t chunk = std::min(size, inputEnd - inputPos);
+            memcpy(out, input.data() + inputPos, chunk);
+            inputPos += chunk;
+            out += chunk;
+            size -= chunk;
+        }
+        return true;
+    }
+    
+    /**
+     * @brief Читает строку до перевода строки (без него)
+     */
+    bool readLine(std::string& line) {
+        line.clear();
+        for (;;) {
+            if (inputPos == inputEnd && !fill()) return false;
+            const char* start = input.data() + inputPos;
+            const char* newline = static_cast<const char*>(memchr(start, '\n', inputEnd - inputPos));
+            if (newline != nullptr) {
+                line.append(start, newline);
+                inputPos += static_cast<size_t>(newline - start) + 1;
+                if (!line.empty() && line.back() == '\r') line.pop_back();
+                return true;
+            }
+            line.append(start, inputEnd - inputPos);
+            inputPos = inputEnd;
+            if (line.size() > 1024) return false;
+        }
+    }
+    
+    /**
+     * @brief Суммирует count значений double из потока
+     * @details Значения обрабатываются прямо в буфере чтения без выделения памяти.
+     */
+    bool sumValues(uint32_t count, double& sum) {
+        double values[512];
+        sum = 0.0;
+        while (count > 0) {
+            uint32_t chunk = std::min<uint32_t>(count, 512);
+            if (!read(values, chunk * sizeof(double))) return false;
+            sum += ReferenceServer::processVector(values, chunk);
+            count -= chunk;
+        }
+        return true;
+    }
+};
+
+}
+
+/**
+ * @brief Конструктор класса ReferenceServer
+ * @param [in] userLogin Допустимый логин
+ * @param [in] userPassword Пароль пользователя
+ */
+ReferenceServer::ReferenceServer(const std::string& userLogin, const std::string& userPassword)
+    : login(userLogin), password(userPassword), listenFD(-1), port(0), running(false), vectorsServed(0),
+      dropAfter(0) {}
+
+/**
+ * @brief Деструктор класса ReferenceServer
+ */
+ReferenceServer::~ReferenceServer() {
+    stop();
+}
+
+/**
+ * @brief Вычисляет результат для вектора
+ * @param [in] values Значения вектора
+ * @param [in] count Количество значений
+ * @return Сумма значений
+ */
+double ReferenceServer::processVector(const double* values, uint32_t count) {
+    double sum = 0.0;
+    for (uint32_t i = 0; i < count; ++i) {
+        sum += values[i];
+    }
+    return sum;
+}
+
+/**
+ * @brief Запускает сервер на 127.0.0.1
+ * @param [in] listenPort Порт (0 - выбрать свободный)
+ * @return true если сервер запущен
+ */
+bool ReferenceServer::start(int listenPort) {
+    listenFD = socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listenFD < 0) {
+        ErrorHandler::logError("Ошибка создания слушающего сокета");
+        return false;
+    }
+    
+    int enable = 1;
+    setsockopt(listenFD, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+    
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(listenPort);
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    socklen_t length = sizeof(addr);
+    if (bind(listenFD, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(listenFD, SOMAXCONN) < 0 ||
+        getsockname(listenFD, (struct sockaddr*)&addr, &length) < 0) {
+        ErrorHandler::logError("Не удалось занять порт " + std::to_string(listenPort));
+        close(listenFD);
+        listenFD = -1;
+        return false;
+    }
+    
+    port = ntohs(addr.sin_port);
+    running = true;
+    acceptor = std::thread(&ReferenceServer::acceptLoop, this);
+    return true;
+}
+
+/**
+ * @brief Принимает соединения, пока сервер работает
+ */
+void ReferenceServer::acceptLoop() {
+    while (running) {
+        int clientFD = accept4(listenFD, nullptr, nullptr, SOCK_CLOEXEC);
+        if (clientFD < 0) {
+            if (errno == EINTR || errno == ECONNABORTED) continue;
+            break;
+        }
+        
+        int enable = 1;
+        setsockopt(clientFD, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable));
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            sessions.insert(clientFD);
+        }
+        std::thread(&ReferenceServer::serve, this, clientFD).detach();
+    }
+}
+
+/**
+ * @brief Обслуживает одно соединение
+ * @param [in] clientFD Сокет клиента
+ * @details После аутентификации принимает задания, пока клиент не закроет
+ * соединение или оно не будет разорвано по dropAfterVectors().
+ */
+void ReferenceServer::serve(int clientFD) {
+    SessionIo io(clientFD);
+    std::string line;
+    
+    if (io.readLine(line)) {
+        if (line != login) {
+            io.write("ERR\n", 4);
+            io.flush();
+        } else {
+            const std::string salt = Authenticator::generateSalt();
+            io.write(salt.data(), salt.size());
+            io.write("\n", 1);
+            
+            if (io.readLine(line) && line == Authenticator::computeHash(salt, password)) {
+                io.write("OK\n", 3);
+                uint32_t count;
+                while (io.read(&count, sizeof(count))) {
+                    bool ok = true;
+                    for (uint32_t i = 0; ok && i < count; ++i) {
+                        uint32_t size;
+                        double sum;
+                        ok = io.read(&size, sizeof(size)) && io.sumValues(size, sum);
+                        if (ok) {
+                            io.write(&sum, sizeof(sum));
+                            uint64_t limit = dropAfter;
+                            if (++vectorsServed == limit && dropAfter.compare_exchange_strong(limit, 0)) {
+                                io.flush();
+                                ok = false;
+                            }
+                        }
+                    }
+                    if (!ok || !io.flush()) {
+                        break;
+                    }
+                }
+            } else {
+                io.write("ERR\n", 4);
+                io.flush();
+            }
+        }
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    sessions.erase(clientFD);
+    close(clientFD);
+    finished.notify_all();
+}
+
+/**
+ * @brief Обслуживает готовый сокет в вызывающем потоке
+ * @param [in] clientFD Подключенный сокет
+ */
+void ReferenceServer::serveSocket(int clientFD) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        sessions.insert(clientFD);
+    }
+    serve(clientFD);
+}
+
+/**
+ * @brief Ждет остановки сервера
+ */
+void ReferenceServer::wait() {
+    if (acceptor.joinable()) {
+        acceptor.join();
+    }
+}
+
+/**
+ * @brief Останавливает сервер и закрывает все соединения
+ * @details Закрывает слушающий сокет и сокеты сессий на чтение и запись,
+ * затем ждет завершения потоков сессий.
+ */
+void ReferenceServer::stop() {
+    if (listenFD < 0) {
+        return;
+    }
+    
+    running = false;
+    shutdown(listenFD, SHUT_RDWR);
+    wait();
+    close(listenFD);
+    listenFD = -1;
+    
+    std::unique_lock<std::mutex> lock(mutex);
+    for (int fd : sessions) {
+        shutdown(fd, SHUT_RDWR);
+    }
+    finished.wait(lock, [this]() { return sessions.empty(); });
+}
@@ -0,0 +1,124 @@
+#ifndef REFERENCESERVER_H
+#define REFERENCESERVER_H
+
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <set>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Локальный эталонный сервер протокола клиента
+ * @details Реализует протокол, на котором работает ServerConnection:
+ * текстовый LOGIN, соль SALT из 16 шестнадцатеричных символов, проверка
+ * HASH = SHA1(SALT + пароль) из 40 символов в верхнем регистре, ответ OK
+ * или ERR, затем задания: количество векторов (uint32_t), для каждого
+ * вектора размер (uint32_t) и значения double; на каждый вектор отправляется
+ * один double. В одном соединении может быть несколько заданий. Каждое
+ * соединение обслуживается отдельным потоком. Результат вектора - сумма
+ * его элементов.
+ * @warning Объекты класса не копируются.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+class ReferenceServer {
+private:
+    std::string login;                  ///< Допустимый логин
+    std::string password;               ///< Пароль пользователя
+    int listenFD;                       ///< Слушающий сокет
+    int port;                           ///< Фактический порт
+    std::thread acceptor;               ///< Поток приема соединений
+    std::atomic<bool> running;          ///< Сервер принимает соединения
+    std::mutex mutex;                   ///< Защищает sessions
+    std::condition_variable finished;   ///< Сигнал завершения сессии
+    std::set<int> sessions;             ///< Сокеты активных сессий
+    std::atomic<uint64_t> vectorsServed;  ///< Векторы, результаты которых отправлены
+    std::atomic<uint64_t> dropAfter;    ///< Номер вектора, после которого разорвать соединение (0 - нет)
+    
+    /**
+     * @brief Принимает соединения, пока сервер работает
+     */
+    void acceptLoop();
+    
+    /**
+     * @brief Обслуживает одно соединение
+     * @param [in] clientFD Сокет клиента
+     */
+    void serve(int clientFD);
+    
+public:
+    /**
+     * @brief Конструктор класса ReferenceServer
+     * @param [in] userLogin Допустимый логин
+     * @param [in] userPassword Пароль пользователя
+     */
+    ReferenceServer(const std::string& userLogin, const std::string& userPassword);
+    
+    /**
+     * @brief Деструктор класса ReferenceServer
+     * @details Останавливает сервер
+     */
+    ~ReferenceServer();
+    
+    ReferenceServer(const ReferenceServer&) = delete;
+    ReferenceServer& operator=(const ReferenceServer&) = delete;
+    
+    /**
+     * @brief Запускает сервер на 127.0.0.1
+     * @param [in] listenPort Порт (0 - выбрать свободный)
+     * @return true если сервер запущен
+     */
+    bool start(int listenPort);
+    
+    /**
+     * @brief Возвращает порт, на котором работает сервер
+     * @return Номер порта
+     */
+    int getPort() const { return port; }
+    
+    /**
+     * @brief Обслуживает готовый сокет в вызывающем потоке
+     * @param [in] clientFD Подключенный сокет (например, из socketpair)
+     * @details Возвращает управление, когда клиент закроет соединение;
+     * сокет закрывается. Сервер для этого не нужно запускать.
+     */
+    void serveSocket(int clientFD);
+    
+    /**
+     * @brief Ждет остановки сервера
+     */
+    void wait();
+    
+    /**
+     * @brief Останавливает сервер и закрывает все соединения
+     */
+    void stop();
+    
+    /**
+     * @brief Разрывает соединение после заданного количества векторов
+     * @param [in] count Общее число обслуженных векторов, после результата
+     * последнего из которых соединение закрывается (один раз)
+     * @details Для проверки повторного подключения клиента: результаты
+     * до разрыва доходят до клиента, следующие векторы не обрабатываются.
+     */
+    void dropAfterVectors(uint64_t count) { dropAfter = count; }
+    
+    /**
+     * @brief Возвращает количество обслуженных векторов во всех соединениях
+     * @return Векторы, результаты которых отправлены
+     */
+    uint64_t getVectorsServed() const { return vectorsServed; }
+    
+    /**
+     * @brief Вычисляет результат для вектора
+     * @param [in] values Значения вектора
+     * @param [in] count Количество значений
+     * @return Сумма значений
+     */
+    static double processVector(const double* values, uint32_t count);
+};
+
+#endif // REFERENCESERVER_H
@@ -0,0 +1,403 @@
+/**
+ * @file ResultWriter.cpp
+ * @brief Реализация класса ResultWriter
+ * @details Содержит форматирование результатов кратчайшим точным
+ * представлением, параллельное форматирование больших наборов, двоичный и
+ * столбцовый форматы и публикацию файла через временный файл и переименование.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+
+#include "ResultWriter.h"
+#include "ErrorHandler.h"
+#include "VectorStore.h"
+#include "Metrics.h"
+#include "Tracer.h"
+#include <charconv>
+#include <cstring>
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/uio.h>
+
+/**
+ * @brief Наименьшее количество результатов на один поток форматирования
+ */
+static const size_t FORMAT_CHUNK_MIN = 64 * 1024;
+
+/**
+ * @brief Сигнатура двоичного файла результатов
+ */
+static const char RESULT_MAGIC[4] = { 'V', 'R', 'E', 'S' };
+
+/**
+ * @brief Версия формата двоичного файла результатов
+ */
+static const uint32_t RESULT_VERSION = 1;
+
+/**
+ * @brief Записывает все буферы одним или несколькими вызовами writev()
+ * @param [in] fd Дескриптор файла
+ * @param [in,out] iov Буферы; при частичной записи изменяются
+ * @return true если записано все
+ */
+static bool writeBuffers(int fd, std::vector<struct iovec>& iov) {
+    TraceSpan span("write", "file");
+    struct iovec* pending = iov.data();
+    size_t pendingCount = iov.size();
+    while (pendingCount > 0) {
+        ssize_t written = writev(fd, pending, static_cast<int>(std::min<size_t>(pendingCount, IOV_MAX)));
+        Metrics::add(Metrics::SYSCALLS);
+        if (written < 0 && errno == EINTR) {
+            Metrics::add(Metrics::RETRIES);
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        Metrics::add(Metrics::BYTES_WRITTEN, static_cast<uint64_t>(written));
+        size_t done = static_cast<size_t>(written);
+        while (pendingCount > 0 && done >= pending->iov_len) {
+            done -= pending->iov_len;
+            ++pending;
+            --pendingCount;
+        }
+        if (pendingCount > 0) {
+            pending->iov_base = static_cast<char*>(pending->iov_base) + done;
+            pending->iov_len -= done;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Записывает двоичный или столбцовый файл результатов
+ * @param [in] filename Имя файла
+ * @param [in] format ResultWriter::BINARY или ResultWriter::COLUMNAR
+ * @param [in] vectors Входные векторы
+ * @param [in] results Результаты
+ * @param [in] count Количество результатов
+ * @return true если файл записан и опубликован, false в случае ошибки
+ * @details Результаты записываются прямо из массива без копирования.
+ */
+static bool writeBinary(const std::string& filename, ResultWriter::Format format, const VectorStore& vectors,
+                        const double* results, size_t count) {
+    uint64_t checksum = ResultWriter::CHECKSUM_SEED;
+    for (size_t i = 0; i < vectors.size(); ++i) {
+        checksum = ResultWriter::updateChecksum(checksum, vectors[i]);
+    }
+    const ResultHeader header = ResultWriter::makeHeader(format, count, checksum);
+
+    std::vector<struct iovec> iov;
+    iov.push_back({const_cast<ResultHeader*>(&header), sizeof(header)});
+    iov.push_back({const_cast<double*>(results), count * sizeof(double)});
+
+    std::vector<uint32_t> dims;
+    std::vector<uint32_t> index;
+    if (format == ResultWriter::COLUMNAR) {
+        dims.resize(count);
+        index.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            dims[i] = vectors[i].size();
+            index[i] = static_cast<uint32_t>(i);
+        }
+        iov.push_back({dims.data(), count * sizeof(uint32_t)});
+        iov.push_back({index.data(), count * sizeof(uint32_t)});
+    }
+
+    std::string tempName;
+    int fd = ResultWriter::openTemporary(filename, tempName);
+    if (fd < 0) {
+        return false;
+    }
+    if (!writeBuffers(fd, iov)) {
+        ErrorHandler::logError("Ошибка записи в файл: " + filename);
+        ResultWriter::discard(fd, tempName);
+        return false;
+    }
+    return ResultWriter::publish(fd, tempName, filename);
+}
+
+/**
+ * @brief Форматирует значение кратчайшим точным представлением
+ * @param [in] value Значение
+ * @param [out] out Буфер не менее MAX_VALUE_CHARS байт
+ * @return Количество записанных символов
+ */
+size_t ResultWriter::formatValue(double value, char* out) {
+    return static_cast<size_t>(std::to_chars(out, out + MAX_VALUE_CHARS, value).ptr - out);
+}
+
+/**
+ * @brief Определяет формат по имени
+ * @param [in] name Имя формата: text, binary или columnar
+ * @param [out] format Формат
+ * @return true если имя известно
+ */
+bool ResultWriter::parseFormat(const std::string& name, Format& format) {
+    if (name == "text") {
+        format = TEXT;
+    } else if (name == "binary") {
+        format = BINARY;
+    } else if (name == "columnar") {
+        format = COLUMNAR;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Добавляет вектор к контрольной сумме входных векторов
+ * @param [in] hash Текущее значение
+ * @param [in] vector Вектор
+ * @return Новое значение
+ */
+uint64_t ResultWriter::updateChecksum(uint64_t hash, const VectorView& vector) {
+    const uint64_t prime = 0x100000001b3ull;
+    const uint32_t size = vector.size();
+    hash = (hash ^ size) * prime;
+    // Значения отображенного .vbin могут быть не выровнены на 8 байт
+    const char* values = reinterpret_cast<const char*>(vector.data());
+    for (uint32_t j = 0; j < size; ++j) {
+        uint64_t bits;
+        memcpy(&bits, values + j * sizeof(double), sizeof(bits));
+        hash = (hash ^ bits) * prime;
+    }
+    return hash;
+}
+
+/**
+ * @brief Заполняет заголовок двоичного файла результатов
+ * @param [in] format BINARY или COLUMNAR
+ * @param [in] count Количество результатов
+ * @param [in] checksum Контрольная сумма входных векторов
+ * @return Заголовок со смещениями столбцов
+ */
+ResultHeader ResultWriter::makeHeader(Format format, uint64_t count, uint64_t checksum) {
+    ResultHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, RESULT_MAGIC, sizeof(RESULT_MAGIC));
+    header.version = RESULT_VERSION;
+    header.format = static_cast<uint32_t>(format);
+    header.count = count;
+    header.sourceChecksum = checksum;
+    header.resultsOffset = sizeof(header);
+    if (format == COLUMNAR) {
+        header.dimsOffset = header.resultsOffset + count * sizeof(double);
+        header.indexOffset = header.dimsOffset + count * sizeof(uint32_t);
+    }
+    return header;
+}
+
+/**
+ * @brief Записывает файл результатов в заданном формате
+ * @param [in] filename Имя файла
+ * @param [in] format Формат
+ * @param [in] vectors Входные векторы
+ * @param [in] results Результаты для первых count векторов
+ * @param [in] count Количество результатов
+ * @param [in] threads Наибольшее количество потоков форматирования текста
+ * @return true если файл записан и опубликован, false в случае ошибки
+ */
+bool ResultWriter::write(const std::string& filename, Format format, const VectorStore& vectors,
+                         const double* results, size_t count, size_t threads) {
+    if (format == TEXT) {
+        return writeText(filename, results, count, threads);
+    }
+    if (count > vectors.size()) {
+        ErrorHandler::logError("Результатов больше, чем входных векторов: " + filename);
+        return false;
+    }
+    return writeBinary(filename, format, vectors, results, count);
+}
+
+/**
+ * @brief Форматирует участок результатов в буфер
+ * @param [in] results Начало участка
+ * @param [in] count Количество результатов участка
+ * @param [out] buffer Буфер: каждое значение с пробелом перед ним
+ */
+static void formatChunk(const double* results, size_t count, std::vector<char>& buffer) {
+    buffer.resize(count * (ResultWriter::MAX_VALUE_CHARS + 1));
+    char* out = buffer.data();
+    for (size_t i = 0; i < count; ++i) {
+        *out++ = ' ';
+        out += ResultWriter::formatValue(results[i], out);
+    }
+    buffer.resize(static_cast<size_t>(out - buffer.data()));
+}
+
+/**
+ * @brief Записывает текстовый файл результатов
+ * @param [in] filename Имя файла
+ * @param [in] results Результаты
+ * @param [in] count Количество результатов
+ * @param [in] threads Наибольшее количество потоков форматирования
+ * @return true если файл записан и опубликован, false в случае ошибки
+ */
+bool ResultWriter::writeText(const std::string& filename, const double* results, size_t count, size_t threads) {
+    size_t chunks = count / FORMAT_CHUNK_MIN;
+    if (chunks > threads) {
+        chunks = threads;
+    }
+    if (chunks == 0) {
+        chunks = 1;
+    }
+
+    std::vector<std::vector<char>> buffers(chunks);
+    const size_t perChunk = count / chunks;
+    auto formatPart = [&](size_t part) {
+        const size_t begin = part * perChunk;
+        const size_t end = part + 1 == chunks ? count : begin + perChunk;
+        TraceSpan span("format_chunk", "cpu", begin, end - begin);
+        formatChunk(results + begin, end - begin, buffers[part]);
+    };
+
+    std::vector<std::thread> pool;
+    for (size_t part = 1; part < chunks; ++part) {
+        pool.emplace_back([&formatPart, part]() {
+            Tracer::nameThread("format");
+            formatPart(part);
+        });
+    }
+    formatPart(0);
+    for (auto& thread : pool) {
+        thread.join();
+    }
+
+    char header[32];
+    const int headerLength = snprintf(header, sizeof(header), "%zu", count);
+    char newline = '\n';
+
+    std::vector<struct iovec> iov;
+    iov.push_back({header, static_cast<size_t>(headerLength)});
+    for (auto& buffer : buffers) {
+        iov.push_back({buffer.data(), buffer.size()});
+    }
+    iov.push_back({&newline, 1});
+
+    std::string tempName;
+    int fd = openTemporary(filename, tempName);
+    if (fd < 0) {
+        return false;
+    }
+
+    if (!writeBuffers(fd, iov)) {
+        ErrorHandler::logError("Ошибка записи в файл: " + filename);
+        discard(fd, tempName);
+        return false;
+    }
+
+    return publish(fd, tempName, filename);
+}
+
+/**
+ * @brief Записывает данные в файл по заданному смещению
+ * @param [in] fd Дескриптор файла
+ * @param [in] data Данные
+ * @param [in] size Размер данных
+ * @param [in] offset Смещение от начала файла
+ * @return true если записано все
+ */
+bool ResultWriter::writeAt(int fd, const void* data, size_t size, uint64_t offset) {
+    TraceSpan span("write", "file");
+    const char* bytes = static_cast<const char*>(data);
+    while (size > 0) {
+        ssize_t written = pwrite(fd, bytes, size, static_cast<off_t>(offset));
+        Metrics::add(Metrics::SYSCALLS);
+        if (written < 0 && errno == EINTR) {
+            Metrics::add(Metrics::RETRIES);
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        Metrics::add(Metrics::BYTES_WRITTEN, static_cast<uint64_t>(written));
+        bytes += written;
+        size -= static_cast<size_t>(written);
+        offset += static_cast<uint64_t>(written);
+    }
+    return true;
+}
+
+/**
+ * @brief Создает временный файл для последующей публикации
+ * @param [in] filename Имя целевого файла
+ * @param [out] tempName Имя временного файла
+ * @return Дескриптор открытого на запись файла или -1 в случае ошибки
+ * @details Временный файл создается в том же каталоге, чтобы rename()
+ * заменял целевой файл атомарно.
+ */
+int ResultWriter::openTemporary(const std::string& filename, std::string& tempName) {
+    tempName = filename + ".tmp." + std::to_string(getpid());
+    int fd = open(tempName.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0666);
+    if (fd < 0) {
+        ErrorHandler::logError("Не удалось открыть файл для записи результатов: " + filename);
+    }
+    return fd;
+}
+
+/**
+ * @brief Сбрасывает на диск запись каталога, содержащего файл
+ * @param [in] filename Имя файла
+ * @return true если каталог сброшен
+ */
+static bool syncParentDirectory(const std::string& filename) {
+    const size_t slash = filename.rfind('/');
+    const std::string directory = slash == std::string::npos ? "." : (slash == 0 ? "/" : filename.substr(0, slash));
+    int dirFD = open(directory.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFD < 0) {
+        return false;
+    }
+    const bool synced = fsync(dirFD) == 0;
+    close(dirFD);
+    return synced;
+}
+
+/**
+ * @brief Закрывает временный файл и переименовывает его в целевой
+ * @param [in] fd Дескриптор из openTemporary()
+ * @param [in] tempName Имя временного файла
+ * @param [in] filename Имя целевого файла
+ * @return true если файл опубликован; при ошибке временный файл удаляется
+ * @details Данные сбрасываются на диск до rename(), а каталог - после него:
+ * иначе при сбое питания под новым именем мог оказаться пустой файл или
+ * прежний файл мог вернуться. Журнал возобновления удаляется только после
+ * успешной публикации, поэтому ошибка сброса каталога тоже считается ошибкой.
+ */
+bool ResultWriter::publish(int fd, const std::string& tempName, const std::string& filename) {
+    TraceSpan span("publish", "file");
+    const bool synced = fsync(fd) == 0;
+    if (close(fd) != 0 || !synced) {
+        ErrorHandler::logError("Ошибка записи в файл: " + filename);
+        unlink(tempName.c_str());
+        return false;
+    }
+    if (rename(tempName.c_str(), filename.c_str()) != 0) {
+        ErrorHandler::logError("Не удалось переименовать " + tempName + " в " + filename);
+        unlink(tempName.c_str());
+        return false;
+    }
+    if (!syncParentDirectory(filename)) {
+        ErrorHandler::logError("Не удалось сбросить на диск каталог файла " + filename);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Закрывает и удаляет временный файл
+ * @param [in] fd Дескриптор из openTemporary()
+ * @param [in] tempName Имя временного файла
+ */
+void ResultWriter::discard(int fd, const std::string& tempName) {
+    close(fd);
+    unlink(tempName.c_str());
+}
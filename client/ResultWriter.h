@@ -0,0 +1,179 @@
+#ifndef RESULTWRITER_H
+#define RESULTWRITER_H
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+class VectorStore;
+class VectorView;
+
+/**
+ * @brief Заголовок двоичного файла результатов
+ * @details Все поля хранятся в порядке байтов little-endian, размер
+ * заголовка 64 байта. Столбцы начинаются с границ своих типов, поэтому файл
+ * можно отобразить в память и читать как массивы без разбора.
+ * 
+ * Структура файла:
+ * 1. Заголовок ResultHeader (64 байта)
+ * 2. double[count] - результаты (resultsOffset)
+ * 3. Только в столбцовом формате: uint32_t[count] - размеры векторов
+ *    (dimsOffset), затем uint32_t[count] - номера векторов во входном
+ *    файле (indexOffset)
+ */
+struct ResultHeader {
+    char magic[4];           ///< Сигнатура "VRES"
+    uint32_t version;        ///< Версия формата (1)
+    uint32_t format;         ///< ResultWriter::BINARY или ResultWriter::COLUMNAR
+    uint32_t reserved;       ///< Зарезервировано (0)
+    uint64_t count;          ///< Количество результатов
+    uint64_t sourceChecksum; ///< Контрольная сумма входных векторов (ResultWriter::updateChecksum)
+    uint64_t resultsOffset;  ///< Смещение результатов от начала файла
+    uint64_t dimsOffset;     ///< Смещение столбца размеров (0 - столбца нет)
+    uint64_t indexOffset;    ///< Смещение столбца номеров (0 - столбца нет)
+    uint64_t reserved2;      ///< Зарезервировано (0)
+};
+
+static_assert(sizeof(ResultHeader) == 64, "Размер заголовка файла результатов должен быть 64 байта");
+
+/**
+ * @brief Класс для записи файла результатов
+ * @details Значения форматируются кратчайшим представлением, которое при
+ * обратном разборе дает то же самое число double (std::to_chars), поэтому
+ * результаты читаются обратно без потери точности. Файл пишется во
+ * временный файл рядом с целевым и публикуется переименованием: читатель
+ * видит либо старый файл, либо полностью записанный новый.
+ *
+ * Форматы файла результатов (Format):
+ * - TEXT: количество результатов, затем значения через пробел, в конце
+ *   перевод строки;
+ * - BINARY: заголовок ResultHeader и результаты double;
+ * - COLUMNAR: как BINARY, плюс столбцы размеров и номеров входных векторов.
+ * @warning Все методы являются статическими, экземпляры класса не создаются.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+class ResultWriter {
+public:
+    /**
+     * @brief Формат файла результатов
+     */
+    enum Format {
+        TEXT,      ///< Текст: количество и значения через пробел
+        BINARY,    ///< Заголовок и массив double
+        COLUMNAR   ///< Заголовок, результаты, размеры и номера векторов
+    };
+    
+    /**
+     * @brief Начальное значение контрольной суммы входных векторов
+     */
+    static const uint64_t CHECKSUM_SEED = 0xcbf29ce484222325ull;
+    
+    /**
+     * @brief Наибольшая длина значения, записываемого formatValue()
+     */
+    static const size_t MAX_VALUE_CHARS = 32;
+
+    /**
+     * @brief Форматирует значение кратчайшим точным представлением
+     * @param [in] value Значение
+     * @param [out] out Буфер не менее MAX_VALUE_CHARS байт
+     * @return Количество записанных символов
+     */
+    static size_t formatValue(double value, char* out);
+
+    /**
+     * @brief Определяет формат по имени
+     * @param [in] name Имя формата: text, binary или columnar
+     * @param [out] format Формат
+     * @return true если имя известно
+     */
+    static bool parseFormat(const std::string& name, Format& format);
+    
+    /**
+     * @brief Добавляет вектор к контрольной сумме входных векторов
+     * @param [in] hash Текущее значение (начальное - CHECKSUM_SEED)
+     * @param [in] vector Вектор
+     * @return Новое значение
+     * @details FNV-1a по 64-битным словам: размер вектора, затем двоичные
+     * представления значений. Сумма не зависит от того, был ли вход
+     * текстовым или .vbin.
+     */
+    static uint64_t updateChecksum(uint64_t hash, const VectorView& vector);
+    
+    /**
+     * @brief Заполняет заголовок двоичного файла результатов
+     * @param [in] format BINARY или COLUMNAR
+     * @param [in] count Количество результатов
+     * @param [in] checksum Контрольная сумма входных векторов
+     * @return Заголовок со смещениями столбцов
+     */
+    static ResultHeader makeHeader(Format format, uint64_t count, uint64_t checksum);
+    
+    /**
+     * @brief Записывает файл результатов в заданном формате
+     * @param [in] filename Имя файла
+     * @param [in] format Формат
+     * @param [in] vectors Входные векторы (для контрольной суммы и размеров)
+     * @param [in] results Результаты для первых count векторов
+     * @param [in] count Количество результатов
+     * @param [in] threads Наибольшее количество потоков форматирования текста
+     * @return true если файл записан и опубликован, false в случае ошибки
+     */
+    static bool write(const std::string& filename, Format format, const VectorStore& vectors,
+                      const double* results, size_t count, size_t threads);
+    
+    /**
+     * @brief Записывает текстовый файл результатов
+     * @param [in] filename Имя файла
+     * @param [in] results Результаты
+     * @param [in] count Количество результатов
+     * @param [in] threads Наибольшее количество потоков форматирования
+     * @return true если файл записан и опубликован, false в случае ошибки
+     * @details Большие наборы результатов делятся на участки, которые
+     * форматируются параллельно в отдельные буферы; буферы записываются
+     * одним вызовом writev().
+     */
+    static bool writeText(const std::string& filename, const double* results, size_t count, size_t threads);
+
+    /**
+     * @brief Записывает данные в файл по заданному смещению
+     * @param [in] fd Дескриптор файла
+     * @param [in] data Данные
+     * @param [in] size Размер данных
+     * @param [in] offset Смещение от начала файла
+     * @return true если записано все
+     * @details Не меняет текущую позицию файла, поэтому безопасна при
+     * одновременной последовательной записи из другого потока.
+     */
+    static bool writeAt(int fd, const void* data, size_t size, uint64_t offset);
+    
+    /**
+     * @brief Создает временный файл для последующей публикации
+     * @param [in] filename Имя целевого файла
+     * @param [out] tempName Имя временного файла
+     * @return Дескриптор открытого на запись файла или -1 в случае ошибки
+     */
+    static int openTemporary(const std::string& filename, std::string& tempName);
+
+    /**
+     * @brief Закрывает временный файл и переименовывает его в целевой
+     * @param [in] fd Дескриптор из openTemporary()
+     * @param [in] tempName Имя временного файла
+     * @param [in] filename Имя целевого файла
+     * @return true если файл опубликован; при ошибке временный файл удаляется
+     * @details Перед переименованием файл, а после него - каталог сбрасываются
+     * на диск fsync(), чтобы опубликованный файл пережил сбой питания.
+     */
+    static bool publish(int fd, const std::string& tempName, const std::string& filename);
+
+    /**
+     * @brief Закрывает и удаляет временный файл
+     * @param [in] fd Дескриптор из openTemporary()
+     * @param [in] tempName Имя временного файла
+     */
+    static void discard(int fd, const std::string& tempName);
+};
+
+#endif // RESULTWRITER_H
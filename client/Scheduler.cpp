@@ -0,0 +1,80 @@
+/**
+ * @file Scheduler.cpp
+ * @brief Реализация класса Scheduler
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+
+#include "Scheduler.h"
+#include "ErrorHandler.h"
+
+/**
+ * @brief Ставит сопрограмму в очередь на продолжение
+ * @param [in] handle Приостановленная сопрограмма
+ */
+void Scheduler::schedule(std::coroutine_handle<> handle) {
+    ready.push_back(handle);
+}
+
+/**
+ * @brief Запускает задачу верхнего уровня
+ * @param [in] task Задача; планировщик владеет ею до завершения
+ */
+void Scheduler::spawn(Task<void> task) {
+    schedule(task.coroutine());
+    spawned.push_back(std::move(task));
+}
+
+/**
+ * @brief Продолжает готовые сопрограммы и удаляет завершенные задачи
+ * @details Сопрограммы продолжаются после возврата из EventLoop::runOnce(),
+ * поэтому завершившаяся задача может освободить свой сокет, не затрагивая
+ * события других сокетов из той же пачки.
+ */
+void Scheduler::drainReady() {
+    while (!ready.empty()) {
+        std::coroutine_handle<> handle = ready.front();
+        ready.pop_front();
+        handle.resume();
+    }
+    
+    for (std::list<Task<void>>::iterator it = spawned.begin(); it != spawned.end();) {
+        if (it->coroutine().done()) {
+            it = spawned.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+/**
+ * @brief Ждет событий сокетов и ставит разбуженные сопрограммы в очередь
+ * @return true если событие обработано, false в случае ошибки
+ */
+bool Scheduler::waitForEvents() {
+    if (loop.size() == 0) {
+        ErrorHandler::logError("Задачи ожидают событий без зарегистрированных сокетов");
+        return false;
+    }
+    if (loop.runOnce(-1) < 0) {
+        ErrorHandler::logError("Ошибка ожидания событий сокетов");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Выполняет задачи, пока все запущенные не завершатся
+ * @return true если все задачи завершены, false в случае ошибки
+ */
+bool Scheduler::run() {
+    drainReady();
+    while (!spawned.empty()) {
+        if (!waitForEvents()) {
+            return false;
+        }
+        drainReady();
+    }
+    return true;
+}
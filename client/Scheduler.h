@@ -0,0 +1,92 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+
+#include "EventLoop.h"
+#include "Task.h"
+#include <coroutine>
+#include <deque>
+#include <list>
+
+/**
+ * @brief Минимальный планировщик сопрограмм поверх EventLoop
+ * @details Хранит очередь готовых к продолжению сопрограмм и запущенные
+ * задачи верхнего уровня. run() продолжает готовые сопрограммы, а когда
+ * их нет - ждет событий сокетов в EventLoop. Все выполняется в одном потоке.
+ * @warning Объекты класса не копируются.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+class Scheduler {
+private:
+    EventLoop loop;                                 ///< Цикл событий сокетов
+    std::deque<std::coroutine_handle<>> ready;      ///< Сопрограммы, готовые к продолжению
+    std::list<Task<void>> spawned;                  ///< Запущенные задачи верхнего уровня
+    
+    /**
+     * @brief Продолжает готовые сопрограммы и удаляет завершенные задачи
+     */
+    void drainReady();
+    
+    /**
+     * @brief Ждет событий сокетов и ставит разбуженные сопрограммы в очередь
+     * @return true если событие обработано, false при ошибке цикла событий
+     * или если ждать нечего (причина - в журнале ошибок)
+     */
+    bool waitForEvents();
+    
+public:
+    Scheduler() = default;
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+    
+    /**
+     * @brief Возвращает цикл событий планировщика
+     * @return Цикл событий
+     */
+    EventLoop& eventLoop() { return loop; }
+    
+    /**
+     * @brief Ставит сопрограмму в очередь на продолжение
+     * @param [in] handle Приостановленная сопрограмма
+     */
+    void schedule(std::coroutine_handle<> handle);
+    
+    /**
+     * @brief Запускает задачу верхнего уровня
+     * @param [in] task Задача; планировщик владеет ею до завершения
+     */
+    void spawn(Task<void> task);
+    
+    /**
+     * @brief Выполняет задачи, пока все запущенные не завершатся
+     * @return true если все задачи завершены, false при ошибке цикла событий
+     * или если задачи ждут событий, которые не могут наступить
+     */
+    bool run();
+    
+    /**
+     * @brief Выполняет задачу до завершения и возвращает ее результат
+     * @param [in] task Задача
+     * @param [out] result Результат задачи; не меняется, если задача не завершилась
+     * @return true если задача завершилась, false если цикл событий
+     * завершился ошибкой или задаче нечего ждать
+     * @details Основа синхронных оберток: вызывающий поток блокируется,
+     * пока задача (и другие запущенные задачи) выполняются планировщиком.
+     */
+    template <typename T>
+    bool runUntilComplete(Task<T> task, T& result) {
+        schedule(task.coroutine());
+        drainReady();
+        while (!task.coroutine().done()) {
+            if (!waitForEvents()) {
+                return false;
+            }
+            drainReady();
+        }
+        result = task.result();
+        return true;
+    }
+};
+
+#endif // SCHEDULER_H
@@ -0,0 +1,44 @@
+/**
+ * @file SendTimeRing.cpp
+ * @brief Реализация класса SendTimeRing
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+
+#include "SendTimeRing.h"
+#include "VectorStore.h"
+#include "Metrics.h"
+
+/**
+ * @brief Конструктор класса SendTimeRing
+ * @param [in] window Окно конвейера
+ */
+SendTimeRing::SendTimeRing(size_t window) : sentAt(window > 0 ? window : 1) {}
+
+/**
+ * @brief Запоминает текущее время как время отправки векторов
+ * @param [in] from Номер первого вектора в задании
+ * @param [in] to Номер, следующий за последним вектором
+ */
+void SendTimeRing::stamp(size_t from, size_t to) {
+    const uint64_t now = Metrics::now();
+    for (size_t i = from; i < to; ++i) {
+        sentAt[i % sentAt.size()].store(now, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * @brief Учитывает задержки ответа на векторы, результаты которых получены
+ * @param [in] vectors Хранилище векторов
+ * @param [in] begin Индекс первого вектора задания в хранилище
+ * @param [in] from Номер первого вектора с новым результатом
+ * @param [in] to Номер, следующий за последним вектором с новым результатом
+ */
+void SendTimeRing::record(const VectorStore& vectors, size_t begin, size_t from, size_t to) const {
+    const uint64_t now = Metrics::now();
+    for (size_t i = from; i < to; ++i) {
+        Metrics::recordLatency(vectors.dimension(begin + i),
+                               now - sentAt[i % sentAt.size()].load(std::memory_order_relaxed));
+    }
+}
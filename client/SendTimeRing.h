@@ -0,0 +1,50 @@
+#ifndef SENDTIMERING_H
+#define SENDTIMERING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class VectorStore;
+
+/**
+ * @brief Кольцо времен отправки векторов окна конвейера
+ * @details Вектор i задания занимает ячейку i % размер кольца: векторов
+ * без ответа не больше окна, поэтому ячейка освобождается раньше, чем
+ * понадобится снова. Ячейки атомарны, так как отправитель и получатель
+ * могут работать в разных потоках.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+class SendTimeRing {
+private:
+    std::vector<std::atomic<uint64_t>> sentAt;  ///< Время отправки по ячейкам
+    
+public:
+    /**
+     * @brief Конструктор класса SendTimeRing
+     * @param [in] window Окно конвейера (не меньше 1)
+     */
+    explicit SendTimeRing(size_t window);
+    
+    /**
+     * @brief Запоминает текущее время как время отправки векторов
+     * @param [in] from Номер первого вектора в задании
+     * @param [in] to Номер, следующий за последним вектором
+     */
+    void stamp(size_t from, size_t to);
+    
+    /**
+     * @brief Учитывает задержки ответа на векторы, результаты которых получены
+     * @param [in] vectors Хранилище векторов
+     * @param [in] begin Индекс первого вектора задания в хранилище
+     * @param [in] from Номер первого вектора с новым результатом
+     * @param [in] to Номер, следующий за последним вектором с новым результатом
+     * @details Ячейки векторов освобождаются только после вызова.
+     */
+    void record(const VectorStore& vectors, size_t begin, size_t from, size_t to) const;
+};
+
+#endif // SENDTIMERING_H
@@ -1,15 +1,42 @@
 #include "ServerConnection.h"
 #include "ErrorHandler.h"
+#include "Logger.h"
 #include "Authenticator.h"
+#include "MappedFile.h"
+#include "BlockingIoBackend.h"
+#include "Metrics.h"
+#include "Tracer.h"
+#include "SendTimeRing.h"
 #include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/sendfile.h>
+#include <climits>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <arpa/inet.h>
 #include <unistd.h>
 #include <netdb.h>
 #include <cstring>
-#include <iostream>
 #include <cstdint>
 #include <errno.h>
+#include <signal.h>
+#include <pthread.h>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+
+/**
+ * @brief Максимальное число описателей буферов в одном вызове sendmsg
+ */
+static const size_t MAX_IOV = IOV_MAX;
+
+/**
+ * @brief Метки операций отправки и приема в механизме ввода-вывода
+ */
+static const uint64_t IO_TAG_SEND = 1;
+static const uint64_t IO_TAG_RECV = 2;
 
 /**
  * @brief Вспомогательные функции для преобразования порядка байтов для 64-битных значений
@@ -50,9 +77,11 @@ uint64_t ntohll(uint64_t value) { return value; }
 
 /**
  * @brief Конструктор класса ServerConnection
- * @details Инициализирует дескриптор сокета значением -1
+ * @details Инициализирует дескриптор сокета значением -1,
+ * окно конвейера - значением 1 (без конвейера)
  */
-ServerConnection::ServerConnection() : socketFD(-1) {}
+ServerConnection::ServerConnection()
+    : socketFD(-1), pipelineWindow(1), resultsReceived(0), io(new BlockingIoBackend()) {}
 
 /**
  * @brief Деструктор класса ServerConnection
@@ -67,8 +96,13 @@ ServerConnection::~ServerConnection() {
  * @param [in] address Адрес сервера (IP или доменное имя)
  * @param [in] port Порт сервера
  * @return true если соединение установлено, false в случае ошибки
+ * @details Для сокета отключается алгоритм Нейгла (TCP_NODELAY): иначе
+ * вместе с отложенным подтверждением сервера он задерживает первую пачку
+ * каждого задания примерно на 40 мс. При ошибке сокет закрывается, поэтому
+ * повторные попытки подключения (Client::reconnect()) не оставляют дескрипторов.
  */
 bool ServerConnection::establishConnection(const std::string& address, int port) {
+    PhaseTimer timer(Metrics::CONNECT);
     socketFD = socket(AF_INET, SOCK_STREAM, 0);
     if (socketFD < 0) {
         ErrorHandler::logError("Ошибка создания сокета");
@@ -82,18 +116,162 @@ bool ServerConnection::establishConnection(const std::string& address, int port)
     
     if (inet_pton(AF_INET, address.c_str(), &serverAddr.sin_addr) <= 0) {
         ErrorHandler::logError("Неверный адрес сервера: " + address);
+        close(socketFD);
+        socketFD = -1;
         return false;
     }
     
     if (connect(socketFD, (struct sockaddr*)&serverAddr, sizeof(serverAddr)) < 0) {
         ErrorHandler::logError("Не удалось подключиться к серверу " + address + ":" + std::to_string(port));
+        close(socketFD);
+        socketFD = -1;
         return false;
     }
     
-    std::cout << "Лог: Установлено соединение с " << address << ":" << port << std::endl;
+    int enable = 1;
+    if (setsockopt(socketFD, IPPROTO_TCP, TCP_NODELAY, &enable, sizeof(enable)) < 0) {
+        LOG_WARNING("Не удалось отключить алгоритм Нейгла: " << strerror(errno));
+    }
+    
+    LOG_INFO("Установлено соединение с " << address << ":" << port);
     return true;
 }
 
+/**
+ * @brief Выбирает механизм ввода-вывода соединения
+ * @param [in] kind "blocking", "uring" или "auto"
+ * @details Недоступный io_uring заменяется блокирующим механизмом.
+ */
+void ServerConnection::setIoBackend(const std::string& kind) {
+    io = IoBackend::create(kind);
+    LOG_INFO("Механизм ввода-вывода: " << io->name());
+}
+
+/**
+ * @brief Преобразует завершение операции в результат системного вызова
+ * @param [in] completion Завершение операции
+ * @return Число переданных байтов или -1 с кодом ошибки в errno
+ */
+static ssize_t completionResult(const IoCompletion& completion) {
+    if (completion.result < 0) {
+        errno = static_cast<int>(-completion.result);
+        return -1;
+    }
+    return completion.result;
+}
+
+/**
+ * @brief Отправляет буферы одним вызовом sendmsg через механизм ввода-вывода
+ * @param [in] msg Описание буферов
+ * @param [in] flags Флаги sendmsg
+ * @return Число отправленных байтов или -1 с кодом ошибки в errno
+ */
+ssize_t ServerConnection::ioSendmsg(const struct msghdr* msg, int flags) {
+    IoCompletion completion;
+    if (!io->queueSendmsg(socketFD, msg, flags, 0) || io->wait(&completion, 1) != 1) {
+        drainIo();
+        errno = EIO;
+        return -1;
+    }
+    return completionResult(completion);
+}
+
+/**
+ * @brief Принимает данные вызовом recv через механизм ввода-вывода
+ * @param [out] buffer Буфер приема
+ * @param [in] size Размер буфера
+ * @param [in] flags Флаги recv
+ * @return Число принятых байтов или -1 с кодом ошибки в errno
+ */
+ssize_t ServerConnection::ioRecv(void* buffer, size_t size, int flags) {
+    IoCompletion completion;
+    if (!io->queueRecv(socketFD, buffer, size, flags, 0) || io->wait(&completion, 1) != 1) {
+        drainIo();
+        errno = EIO;
+        return -1;
+    }
+    return completionResult(completion);
+}
+
+/**
+ * @brief Прерывает обмен и дожидается всех операций механизма ввода-вывода
+ * @return Байт, принятых завершившимися операциями приема
+ * @details Операции в кольце io_uring ссылаются на буферы вызывающего
+ * метода, часто локальные, поэтому выйти из него можно только после их
+ * завершения: иначе ядро запишет в освобожденный стек, а следующий вызов
+ * заберет чужие завершения. Сокет закрывается на чтение и запись, и
+ * ожидающие операции завершаются сразу. Если механизм сам перестал
+ * работать, он заменяется блокирующим: закрытие кольца отменяет
+ * оставшиеся в нем операции.
+ */
+size_t ServerConnection::drainIo() {
+    abortTransfer();
+    size_t receivedBytes = 0;
+    for (;;) {
+        IoCompletion completions[2];
+        const int done = io->wait(completions, 2);
+        if (done == 0) {
+            break;
+        }
+        if (done < 0) {
+            LOG_WARNING("Ошибка механизма ввода-вывода " << io->name() << ", дальше используется блокирующий");
+            io.reset(new BlockingIoBackend());
+            break;
+        }
+        for (int k = 0; k < done; ++k) {
+            if (completions[k].tag == IO_TAG_RECV && completions[k].result > 0) {
+                receivedBytes += static_cast<size_t>(completions[k].result);
+            }
+        }
+    }
+    return receivedBytes;
+}
+
+/**
+ * @brief Продвигает описатели буферов после частичной отправки
+ * @param [in,out] iov Первый неотправленный описатель
+ * @param [in,out] count Количество неотправленных описателей
+ * @param [in] sent Количество отправленных байтов
+ */
+void ServerConnection::advanceIov(struct iovec*& iov, size_t& count, size_t sent) {
+    while (count > 0 && sent >= iov->iov_len) {
+        sent -= iov->iov_len;
+        ++iov;
+        --count;
+    }
+    if (count > 0) {
+        iov->iov_base = static_cast<char*>(iov->iov_base) + sent;
+        iov->iov_len -= sent;
+    }
+}
+
+/**
+ * @brief Представляет байты значения в шестнадцатеричном виде
+ * @param [in] data Начало значения
+ * @param [in] size Размер в байтах
+ * @return Строка вида "0A 00 00 00 " в порядке байтов в памяти
+ */
+static std::string hexBytes(const void* data, size_t size) {
+    static const char digits[] = "0123456789ABCDEF";
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    std::string text;
+    for (size_t i = 0; i < size; ++i) {
+        text += digits[bytes[i] >> 4];
+        text += digits[bytes[i] & 0x0F];
+        text += ' ';
+    }
+    return text;
+}
+
+/**
+ * @brief Использует уже подключенный сокет
+ * @param [in] fd Подключенный потоковый сокет (например, из socketpair)
+ */
+void ServerConnection::adoptSocket(int fd) {
+    closeConnection();
+    socketFD = fd;
+}
+
 /**
  * @brief Отправляет текстовые данные через сокет
  * @param [in] text Текст для отправки
@@ -101,7 +279,17 @@ bool ServerConnection::establishConnection(const std::string& address, int port)
  */
 bool ServerConnection::sendText(const std::string& text) {
     std::string message = text + "\n";
-    ssize_t bytesSent = send(socketFD, message.c_str(), message.length(), 0);
+    struct iovec iov;
+    iov.iov_base = const_cast<char*>(message.c_str());
+    iov.iov_len = message.length();
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    ssize_t bytesSent = ioSendmsg(&msg, 0);
+    if (bytesSent > 0) {
+        Metrics::add(Metrics::BYTES_SENT, static_cast<uint64_t>(bytesSent));
+    }
     
     if (bytesSent != static_cast<ssize_t>(message.length())) {
         ErrorHandler::logError("Ошибка отправки текста: " + text);
@@ -118,13 +306,14 @@ bool ServerConnection::sendText(const std::string& text) {
  */
 bool ServerConnection::receiveText(std::string& text) {
     char buffer[1024];
-    ssize_t bytesReceived = recv(socketFD, buffer, sizeof(buffer) - 1, 0);
+    ssize_t bytesReceived = ioRecv(buffer, sizeof(buffer) - 1, 0);
     
     if (bytesReceived <= 0) {
         ErrorHandler::logError("Ошибка получения текста от сервера");
         return false;
     }
     
+    Metrics::add(Metrics::BYTES_RECEIVED, static_cast<uint64_t>(bytesReceived));
     buffer[bytesReceived] = '\0';
     text = buffer;
     
@@ -149,11 +338,12 @@ bool ServerConnection::receiveText(std::string& text) {
  * 5. Получение подтверждения аутентификации
  */
 bool ServerConnection::authenticate(const std::string& userLogin, const std::string& userPassword) {
+    PhaseTimer timer(Metrics::AUTHENTICATE);
     login = userLogin;
     password = userPassword;
     
     // Отправка LOGIN
-    std::cout << "Лог: Отправка LOGIN: " << login << std::endl;
+    LOG_INFO("Отправка LOGIN: " << login);
     if (!sendText(login)) {
         ErrorHandler::logError("Ошибка отправки LOGIN");
         return false;
@@ -178,7 +368,7 @@ bool ServerConnection::authenticate(const std::string& userLogin, const std::str
     
     // Вычисление и отправка HASH
     std::string hash = Authenticator::computeHash(saltResponse, password);
-    std::cout << "Лог: Отправка HASH: " << hash << std::endl;
+    LOG_INFO("Отправка HASH: " << hash);
     
     if (!sendText(hash)) {
         ErrorHandler::logError("Ошибка отправки HASH");
@@ -197,10 +387,19 @@ bool ServerConnection::authenticate(const std::string& userLogin, const std::str
         return false;
     }
     
-    std::cout << "Лог: Аутентификация успешна" << std::endl;
+    LOG_INFO("Аутентификация успешна");
     return true;
 }
 
+/**
+ * @brief Задает размер окна конвейерной отправки
+ * @param [in] window Число векторов, которые могут ожидать ответа одновременно
+ * @details Нулевое значение приводится к 1.
+ */
+void ServerConnection::setPipelineWindow(size_t window) {
+    pipelineWindow = window > 0 ? window : 1;
+}
+
 /**
  * @brief Отправляет бинарные данные через сокет
  * @param [in] data Указатель на данные
@@ -208,19 +407,10 @@ bool ServerConnection::authenticate(const std::string& userLogin, const std::str
  * @return true если отправка успешна, false в случае ошибки
  */
 bool ServerConnection::sendBinaryData(const void* data, size_t size) {
-    ssize_t totalSent = 0;
-    const char* dataPtr = static_cast<const char*>(data);
-    
-    while (totalSent < static_cast<ssize_t>(size)) {
-        ssize_t sent = send(socketFD, dataPtr + totalSent, size - totalSent, 0);
-        if (sent <= 0) {
-            ErrorHandler::logError("Ошибка отправки бинарных данных");
-            return false;
-        }
-        totalSent += sent;
-    }
-    
-    return true;
+    struct iovec iov;
+    iov.iov_base = const_cast<void*>(data);
+    iov.iov_len = size;
+    return sendIov(&iov, 1);
 }
 
 /**
@@ -234,7 +424,13 @@ bool ServerConnection::receiveBinaryData(void* data, size_t size) {
     char* dataPtr = static_cast<char*>(data);
     
     while (totalReceived < static_cast<ssize_t>(size)) {
-        ssize_t received = recv(socketFD, dataPtr + totalReceived, size - totalReceived, 0);
+        const uint64_t start = Metrics::now();
+        ssize_t received = ioRecv(dataPtr + totalReceived, size - totalReceived, 0);
+        Metrics::recordReceive(Metrics::RECEIVE, start, received);
+        if (received < 0 && errno == EINTR) {
+            Metrics::add(Metrics::RETRIES);
+            continue;
+        }
         if (received <= 0) {
             ErrorHandler::logError("Ошибка получения бинарных данных");
             return false;
@@ -245,104 +441,715 @@ bool ServerConnection::receiveBinaryData(void* data, size_t size) {
     return true;
 }
 
+/**
+ * @brief Отправляет набор буферов одним системным вызовом sendmsg
+ * @param [in,out] iov Массив описателей буферов (изменяется при частичной отправке)
+ * @param [in] count Количество описателей
+ * @param [in] flags Флаги sendmsg
+ * @return true если отправлены все буферы, false в случае ошибки
+ * @details При частичной отправке пропускает полностью отправленные буферы,
+ * сдвигает начало частично отправленного и повторяет вызов с остатком.
+ */
+bool ServerConnection::sendIov(struct iovec* iov, size_t count, int flags) {
+    while (count > 0) {
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = iov;
+        msg.msg_iovlen = std::min(count, MAX_IOV);
+        
+        const uint64_t start = Metrics::now();
+        ssize_t sent = ioSendmsg(&msg, flags);
+        Metrics::recordSend(Metrics::SEND, start, sent);
+        if (sent < 0 && errno == EINTR) {
+            Metrics::add(Metrics::RETRIES);
+            continue;
+        }
+        if (sent <= 0) {
+            ErrorHandler::logError("Ошибка отправки бинарных данных");
+            return false;
+        }
+        
+        const size_t before = count;
+        advanceIov(iov, count, static_cast<size_t>(sent));
+        if (before - count < msg.msg_iovlen) {
+            Metrics::add(Metrics::RETRIES);  // Частичная отправка: повтор с остатком
+        }
+    }
+    
+    return true;
+}
+
+/**
+ * @brief Отправляет группу векторов пакетами scatter-gather
+ * @param [in] vectors Векторы для отправки
+ * @param [in] begin Индекс первого отправляемого вектора
+ * @param [in] end Индекс, следующий за последним отправляемым вектором
+ * @param [in] idOffset Сдвиг номеров векторов на шкале трассировки
+ * @return true если отправка успешна, false в случае ошибки
+ * @details Для каждого вектора формируются два описателя: поле размера и данные.
+ * Описатели отправляются группами по MAX_IOV, поэтому на миллион векторов
+ * приходится несколько тысяч системных вызовов вместо миллионов.
+ */
+bool ServerConnection::sendVectorBatch(const VectorStore& vectors, size_t begin, size_t end, size_t idOffset) {
+    struct iovec iov[MAX_IOV];
+    
+    while (begin < end) {
+        const size_t groupBegin = begin;
+        size_t count = 0;
+        while (begin < end && count + 2 <= MAX_IOV) {
+            VectorView vec = vectors[begin];
+            iov[count].iov_base = const_cast<uint32_t*>(vec.sizeField());
+            iov[count].iov_len = sizeof(uint32_t);
+            ++count;
+            if (vec.size() > 0) {
+                iov[count].iov_base = const_cast<double*>(vec.data());
+                iov[count].iov_len = vec.byteSize();
+                ++count;
+            }
+            ++begin;
+        }
+        
+        TraceSpan span("send", "net", idOffset + groupBegin, begin - groupBegin);
+        if (!sendIov(iov, count)) {
+            return false;
+        }
+    }
+    
+    return true;
+}
+
 /**
  * @brief Отправляет векторы на сервер для обработки и получает результаты
  * @param [in] vectors Векторы для обработки
  * @param [out] results Результаты обработки от сервера
  * @return true если операция успешна, false в случае ошибки
+ * @details Отправляет все векторы одним заданием через sendVectorRange().
+ * При ошибке results содержит только полученные результаты.
+ */
+bool ServerConnection::sendVectors(const VectorStore& vectors, std::vector<double>& results) {
+    ProfileScope profile(Metrics::SEND);  // Сериализация, отправка и прием
+    MemoryScope memory(Metrics::SEND);
+    results.assign(vectors.size(), 0.0);
+    bool ok = sendVectorRange(vectors, 0, vectors.size(), results.data());
+    results.resize(resultsReceived);
+    Metrics::add(Metrics::VECTORS, vectors.size());
+    Metrics::add(Metrics::RESULTS, resultsReceived);
+    return ok;
+}
+
+/**
+ * @brief Отправляет часть векторов отдельным заданием и получает результаты
+ * @param [in] vectors Хранилище векторов
+ * @param [in] begin Индекс первого вектора
+ * @param [in] end Индекс, следующий за последним вектором
+ * @param [out] results Буфер для end - begin результатов
+ * @return true если получены все результаты, false в случае ошибки
  * @details Процесс отправки:
  * 1. Отправка количества векторов (uint32_t)
- * 2. Для каждого вектора:
- *    a. Отправка размера вектора (uint32_t)
- *    b. Отправка данных вектора (double[])
- *    c. Получение результата обработки (double)
+ * 2. Для каждого вектора - exchangeVector(): отправка размера вектора
+ *    (uint32_t) и данных (double[]) одним вызовом sendmsg и получение
+ *    результата обработки (double)
+ * 
+ * Векторы файла .vbin отправляются sendVectorsZeroCopy(), при окне конвейера
+ * больше 1 используется sendVectorsAsync() для асинхронного механизма
+ * ввода-вывода и sendVectorsPipelined() для блокирующего.
+ * 
+ * Время от отправки вектора до получения его результата учитывается
+ * Metrics::recordLatency(). При конвейере временем отправки считается начало
+ * отправки группы, в которую попал вектор. Для sendfile время отправки
+ * отдельного вектора неизвестно, и задержки не учитываются.
  */
-bool ServerConnection::sendVectors(const std::vector<std::vector<double>>& vectors, std::vector<double>& results) {
-    results.clear();
-    results.reserve(vectors.size());
-    uint32_t numVectors = static_cast<uint32_t>(vectors.size());
+bool ServerConnection::sendVectorRange(const VectorStore& vectors, size_t begin, size_t end, double* results) {
+    resultsReceived = 0;
+    if (vectors.isMapped() && vectors.mappedFile()->descriptor() >= 0) {
+        return sendVectorsZeroCopy(vectors, begin, end, results);
+    }
+    if (pipelineWindow > 1) {
+        return io->isAsync() ? sendVectorsAsync(vectors, begin, end, results)
+                             : sendVectorsPipelined(vectors, begin, end, results);
+    }
+    
+    uint32_t numVectors = static_cast<uint32_t>(end - begin);
     
     // Отладка: показываем что отправляем
-    std::cout << "Отладка: Отправляем " << numVectors << " векторов" << std::endl;
-    std::cout << "Отладка: Байты количества векторов (hex): ";
-    unsigned char* bytes = reinterpret_cast<unsigned char*>(&numVectors);
-    for (size_t i = 0; i < sizeof(numVectors); i++) {
-        printf("%02X ", bytes[i]);
-    }
-    std::cout << std::endl;
+    LOG_DEBUG("Отправляем " << numVectors << " векторов");
+    LOG_DEBUG("Байты количества векторов (hex): " << hexBytes(&numVectors, sizeof(numVectors)));
     
-    if (!sendBinaryData(&numVectors, sizeof(numVectors))) {
-        ErrorHandler::logError("Ошибка отправки количества векторов");
+    if (!sendVectorHeader(numVectors)) {
         return false;
     }
     
     // 2. Для каждого вектора
-    for (size_t i = 0; i < vectors.size(); ++i) {
-        const auto& vec = vectors[i];
-        uint32_t vecSize = static_cast<uint32_t>(vec.size());
+    for (size_t i = begin; i < end; ++i) {
+        VectorView vec = vectors[i];
+        uint32_t vecSize = vec.size();
+        
+        LOG_DEBUG("Размер вектора " << i << ": " << vecSize);
+        LOG_DEBUG("Байты размера вектора (hex): " << hexBytes(&vecSize, sizeof(vecSize)));
         
-        std::cout << "Отладка: Размер вектора " << i << ": " << vecSize << std::endl;
-        std::cout << "Отладка: Байты размера вектора (hex): ";
-        bytes = reinterpret_cast<unsigned char*>(&vecSize);
-        for (size_t j = 0; j < sizeof(vecSize); j++) {
-            printf("%02X ", bytes[j]);
+        // Выводим первые значения для отладки
+        if (i == begin && vecSize > 0) {
+            LOG_DEBUG("Первые 2 значения вектора " << i << ": " << vec[0] << " " << (vecSize > 1 ? vec[1] : 0.0));
         }
-        std::cout << std::endl;
         
-        if (!sendBinaryData(&vecSize, sizeof(vecSize))) {
-            ErrorHandler::logError("Ошибка отправки размера вектора " + std::to_string(i));
+        // Размер и значения (little-endian, как есть) уходят одним вызовом,
+        // результат принимается в том же обмене
+        struct iovec iov[2];
+        iov[0].iov_base = &vecSize;
+        iov[0].iov_len = sizeof(vecSize);
+        iov[1].iov_base = const_cast<double*>(vec.data());
+        iov[1].iov_len = vecSize * sizeof(double);
+        
+        double result;
+        const uint64_t sentAt = Metrics::now();
+        if (!exchangeVector(iov, vecSize > 0 ? 2 : 1, result, i)) {
+            ErrorHandler::logError("Ошибка обмена с сервером для вектора " + std::to_string(i));
             return false;
         }
+        Metrics::recordLatency(vecSize, Metrics::now() - sentAt);
+        LOG_DEBUG("Получен результат для вектора " << i << ": " << result);
+        results[resultsReceived++] = result;
+    }
+    
+    LOG_INFO("Успешно отправлено " << numVectors << " векторов и получено " << resultsReceived << " результатов");
+    return true;
+}
+
+/**
+ * @brief Отправляет векторы в конвейерном режиме со скользящим окном
+ * @param [in] vectors Векторы для обработки
+ * @param [in] begin Индекс первого вектора
+ * @param [in] end Индекс, следующий за последним вектором
+ * @param [out] results Буфер для end - begin результатов
+ * @return true если операция успешна, false в случае ошибки
+ * @details Текущий поток выступает отправителем: передает количество векторов,
+ * затем, не дожидаясь ответов, отправляет векторы пакетами sendVectorBatch(),
+ * каждый раз заполняя все свободное место в окне pipelineWindow. Поток-получатель читает результаты
+ * в порядке отправки прямо в results, освобождая место в окне.
+ * 
+ * При ошибке одной из сторон сокет закрывается на чтение и запись, чтобы
+ * разблокировать другую сторону; resultsReceived содержит число полученных результатов.
+ */
+bool ServerConnection::sendVectorsPipelined(const VectorStore& vectors, size_t begin, size_t end, double* results) {
+    const size_t total = end - begin;
+    
+    std::mutex mutex;
+    std::condition_variable windowChanged;
+    size_t received = 0;        // Количество полученных результатов
+    bool failed = false;        // Признак ошибки любой из сторон
+    SendTimeRing sentAt(pipelineWindow);  // Время отправки векторов окна
+    
+    // Поток-получатель: читает результаты пачками, сколько пришло
+    std::thread receiver([&]() {
+        Tracer::nameThread("receiver");
+        char* out = reinterpret_cast<char*>(results);
+        const size_t totalBytes = total * sizeof(double);
+        const size_t chunkBytes = pipelineWindow * sizeof(double);
+        size_t receivedBytes = 0;
         
-        if (vecSize > 0) {
-            // Выводим первые значения для отладки
-            if (i == 0 && vecSize > 0) {
-                std::cout << "Отладка: Первые 2 значения вектора 0: ";
-                for (size_t j = 0; j < std::min(vecSize, (uint32_t)2); ++j) {
-                    std::cout << vec[j] << " ";
+        while (receivedBytes < totalBytes) {
+            const uint64_t start = Metrics::now();
+            ssize_t got = recv(socketFD, out + receivedBytes,
+                               std::min(chunkBytes, totalBytes - receivedBytes), 0);
+            Metrics::add(Metrics::SYSCALLS);
+            Metrics::recordReceive(Metrics::RECEIVE, start, got);
+            if (got <= 0) {
+                if (got < 0 && errno == EINTR) {
+                    Metrics::add(Metrics::RETRIES);
+                    continue;
+                }
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!failed) {
+                    ErrorHandler::logError("Ошибка получения результата для вектора " +
+                                           std::to_string(begin + receivedBytes / sizeof(double)));
+                    failed = true;
                 }
-                std::cout << std::endl;
+                windowChanged.notify_all();
+                return;
             }
+            const size_t completedBefore = receivedBytes / sizeof(double);
+            receivedBytes += got;
+            Tracer::span("receive", "net", start, Metrics::now(), begin + completedBefore,
+                         receivedBytes / sizeof(double) - completedBefore);
+            // Ячейки окна освобождаются только после учета задержек
+            sentAt.record(vectors, begin, completedBefore, receivedBytes / sizeof(double));
             
-            // Отправляем значения как есть (little-endian)
-            if (!sendBinaryData(vec.data(), vecSize * sizeof(double))) {
-                ErrorHandler::logError("Ошибка отправки значений вектора " + std::to_string(i));
+            std::lock_guard<std::mutex> lock(mutex);
+            received = receivedBytes / sizeof(double);
+            windowChanged.notify_all();
+        }
+    });
+    
+    bool sendOk = sendVectorHeader(static_cast<uint32_t>(total));
+    
+    size_t sent = 0;
+    while (sendOk && sent < total) {
+        size_t batchEnd;
+        {
+            // Ждем свободного места в окне и занимаем его целиком
+            std::unique_lock<std::mutex> lock(mutex);
+            windowChanged.wait(lock, [&]() { return failed || sent - received < pipelineWindow; });
+            if (failed) {
+                sendOk = false;
+                break;
+            }
+            batchEnd = std::min(total, received + pipelineWindow);
+        }
+        
+        sentAt.stamp(sent, batchEnd);
+        if (!sendVectorBatch(vectors, begin + sent, begin + batchEnd)) {
+            ErrorHandler::logError("Ошибка отправки векторов " + std::to_string(begin + sent) +
+                                   "-" + std::to_string(begin + batchEnd - 1));
+            sendOk = false;
+        }
+        sent = batchEnd;
+    }
+    
+    if (!sendOk) {
+        // Будим получателя, заблокированного в recv()
+        std::lock_guard<std::mutex> lock(mutex);
+        failed = true;
+        shutdown(socketFD, SHUT_RDWR);
+    }
+    
+    receiver.join();
+    resultsReceived = received;
+    
+    if (failed) {
+        return false;
+    }
+    
+    LOG_INFO("Успешно отправлено " << total << " векторов и получено " << resultsReceived
+             << " результатов (окно " << pipelineWindow << ")");
+    return true;
+}
+
+/**
+ * @brief Отправляет один вектор и принимает его результат
+ * @param [in,out] iov Описатели поля размера и данных вектора
+ * @param [in] count Количество описателей
+ * @param [out] result Результат обработки вектора
+ * @param [in] vectorId Номер вектора на шкале трассировки
+ * @return true если обмен успешен, false в случае ошибки
+ * @details Асинхронный механизм получает отправку и прием одним вызовом
+ * io_uring_enter; прием с MSG_WAITALL завершается, когда придет весь
+ * результат. Блокирующий механизм отправляет вектор и затем ждет ответа.
+ */
+bool ServerConnection::exchangeVector(struct iovec* iov, size_t count, double& result, size_t vectorId) {
+    if (!io->isAsync()) {
+        {
+            TraceSpan span("send", "net", vectorId, 1);
+            if (!sendIov(iov, count)) {
                 return false;
             }
         }
+        TraceSpan span("receive", "net", vectorId, 1);
+        return receiveBinaryData(&result, sizeof(result));
+    }
+    
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = count;
+    // Время операции в кольце отсчитывается от постановки в очередь
+    uint64_t sendQueued = Metrics::now();
+    uint64_t recvQueued = sendQueued;
+    if (!io->queueSendmsg(socketFD, &msg, 0, IO_TAG_SEND) ||
+        !io->queueRecv(socketFD, &result, sizeof(result), MSG_WAITALL, IO_TAG_RECV)) {
+        drainIo();
+        return false;
+    }
+    
+    size_t receivedBytes = 0;
+    bool sendPending = true;
+    bool recvPending = true;
+    bool ok = true;
+    while (sendPending || recvPending) {
+        IoCompletion completions[2];
+        int done = io->wait(completions, 2);
+        if (done <= 0) {
+            // msg, iov и result принадлежат вызывающему: операции не должны их пережить
+            drainIo();
+            return false;
+        }
+        for (int k = 0; k < done; ++k) {
+            const ssize_t got = completions[k].result;
+            if (completions[k].tag == IO_TAG_SEND) {
+                sendPending = false;
+                Metrics::recordSend(Metrics::SEND, sendQueued, got);
+                Tracer::span("send", "net", sendQueued, Metrics::now(), vectorId, 1);
+                if (got <= 0) {
+                    ok = false;
+                    abortTransfer();
+                    continue;
+                }
+                advanceIov(iov, count, static_cast<size_t>(got));
+                msg.msg_iov = iov;
+                msg.msg_iovlen = count;
+                if (ok && count > 0) {
+                    Metrics::add(Metrics::RETRIES);
+                    sendQueued = Metrics::now();
+                    sendPending = io->queueSendmsg(socketFD, &msg, 0, IO_TAG_SEND);
+                    ok = sendPending;
+                }
+            } else {
+                recvPending = false;
+                Metrics::recordReceive(Metrics::RECEIVE, recvQueued, got);
+                Tracer::span("receive", "net", recvQueued, Metrics::now(), vectorId, 1);
+                if (got <= 0) {
+                    ok = false;
+                    abortTransfer();
+                    continue;
+                }
+                receivedBytes += static_cast<size_t>(got);
+                if (ok && receivedBytes < sizeof(result)) {
+                    Metrics::add(Metrics::RETRIES);
+                    recvQueued = Metrics::now();
+                    recvPending = io->queueRecv(socketFD, reinterpret_cast<char*>(&result) + receivedBytes,
+                                                sizeof(result) - receivedBytes, MSG_WAITALL, IO_TAG_RECV);
+                    ok = recvPending;
+                }
+            }
+        }
+    }
+    
+    return ok;
+}
+
+/**
+ * @brief Отправляет векторы со скользящим окном в одном потоке через io_uring
+ * @param [in] vectors Векторы для обработки
+ * @param [in] begin Индекс первого вектора
+ * @param [in] end Индекс, следующий за последним вектором
+ * @param [out] results Буфер для end - begin результатов
+ * @return true если операция успешна, false в случае ошибки
+ * @details В кольце одновременно находятся отправка очередной группы
+ * векторов и прием результатов; новая операция ставится в очередь сразу после
+ * завершения предыдущей, и io_uring_enter отправляет ее вместе с ожиданием
+ * завершений. Поток-получатель не нужен. Буфер результатов на время задания
+ * регистрируется в ядре, если позволяет RLIMIT_MEMLOCK.
+ * 
+ * При ошибке сокет закрывается на чтение и запись, и метод дожидается
+ * завершения операций в кольце, прежде чем освободить их буферы.
+ */
+bool ServerConnection::sendVectorsAsync(const VectorStore& vectors, size_t begin, size_t end, double* results) {
+    const size_t total = end - begin;
+    if (!sendVectorHeader(static_cast<uint32_t>(total))) {
+        return false;
+    }
+    
+    char* out = reinterpret_cast<char*>(results);
+    const size_t totalBytes = total * sizeof(double);
+    const size_t chunkBytes = pipelineWindow * sizeof(double);
+    const bool registered = io->registerBuffer(results, totalBytes);
+    
+    std::vector<struct iovec> iovStorage(MAX_IOV);
+    struct iovec* iov = nullptr;
+    size_t iovCount = 0;
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    
+    size_t sent = 0;            // Векторы, отправка которых поставлена в очередь
+    size_t receivedBytes = 0;
+    bool sendPending = false;
+    bool recvPending = false;
+    bool failed = false;
+    uint64_t sendQueued = 0;    // Время постановки отправки в очередь
+    uint64_t recvQueued = 0;    // Время постановки приема в очередь
+    SendTimeRing sentAt(pipelineWindow);  // Время отправки векторов окна
+    size_t batchBegin = 0;      // Первый вектор группы в кольце
+    
+    while (!failed && receivedBytes < totalBytes) {
+        const size_t received = receivedBytes / sizeof(double);
         
-        // 3. Получаем результат для этого вектора
-        // Ждем некоторое время, чтобы сервер успел обработать
-        usleep(1000);
+        // Новая группа: все свободное место в окне, но не больше MAX_IOV описателей
+        if (!sendPending && sent < total && sent - received < pipelineWindow) {
+            const size_t batchEnd = std::min(total, received + pipelineWindow);
+            batchBegin = sent;
+            iovCount = 0;
+            while (sent < batchEnd && iovCount + 2 <= MAX_IOV) {
+                VectorView vec = vectors[begin + sent];
+                iovStorage[iovCount].iov_base = const_cast<uint32_t*>(vec.sizeField());
+                iovStorage[iovCount].iov_len = sizeof(uint32_t);
+                ++iovCount;
+                if (vec.size() > 0) {
+                    iovStorage[iovCount].iov_base = const_cast<double*>(vec.data());
+                    iovStorage[iovCount].iov_len = vec.byteSize();
+                    ++iovCount;
+                }
+                ++sent;
+            }
+            iov = iovStorage.data();
+            msg.msg_iov = iov;
+            msg.msg_iovlen = std::min(iovCount, MAX_IOV);
+            sentAt.stamp(batchBegin, sent);
+            sendQueued = Metrics::now();
+            sendPending = io->queueSendmsg(socketFD, &msg, 0, IO_TAG_SEND);
+            failed = !sendPending;
+        }
         
-        double result;
-        ssize_t bytesReceived = recv(socketFD, &result, sizeof(result), MSG_DONTWAIT);
+        if (!recvPending && !failed) {
+            recvQueued = Metrics::now();
+            recvPending = io->queueRecv(socketFD, out + receivedBytes,
+                                        std::min(chunkBytes, totalBytes - receivedBytes), 0, IO_TAG_RECV);
+            failed = !recvPending;
+        }
+        if (failed) {
+            break;
+        }
         
-        if (bytesReceived == sizeof(result)) {
-            // Успешно получили результат
-            std::cout << "Отладка: Получен результат для вектора " << i << ": " << result << std::endl;
-            results.push_back(result);
-        } else if (bytesReceived == 0) {
-            // Сервер закрыл соединение
-            ErrorHandler::logError("Сервер закрыл соединение после вектора " + std::to_string(i));
-            return false;
-        } else if (bytesReceived == -1 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
-            // Нет данных, пробуем снова с ожиданием
-            bytesReceived = recv(socketFD, &result, sizeof(result), MSG_WAITALL);
-            if (bytesReceived == sizeof(result)) {
-                std::cout << "Отладка: Получен результат для вектора " << i << " (с ожиданием): " << result << std::endl;
-                results.push_back(result);
+        IoCompletion completions[2];
+        const int done = io->wait(completions, 2);
+        if (done < 0) {
+            failed = true;
+            break;
+        }
+        for (int k = 0; k < done; ++k) {
+            const ssize_t got = completions[k].result;
+            if (completions[k].tag == IO_TAG_SEND) {
+                sendPending = false;
+                Metrics::recordSend(Metrics::SEND, sendQueued, got);
+                Tracer::span("send", "net", sendQueued, Metrics::now(), begin + batchBegin, sent - batchBegin);
+                if (got <= 0) {
+                    ErrorHandler::logError("Ошибка отправки векторов до " + std::to_string(begin + sent - 1));
+                    failed = true;
+                    continue;
+                }
+                advanceIov(iov, iovCount, static_cast<size_t>(got));
+                if (iovCount > 0 && !failed) {
+                    // Остаток группы после частичной отправки
+                    msg.msg_iov = iov;
+                    msg.msg_iovlen = iovCount;
+                    Metrics::add(Metrics::RETRIES);
+                    sendQueued = Metrics::now();
+                    sendPending = io->queueSendmsg(socketFD, &msg, 0, IO_TAG_SEND);
+                    failed = !sendPending;
+                }
             } else {
-                ErrorHandler::logError("Ошибка получения результата для вектора " + std::to_string(i));
-                return false;
+                recvPending = false;
+                Metrics::recordReceive(Metrics::RECEIVE, recvQueued, got);
+                if (got <= 0) {
+                    ErrorHandler::logError("Ошибка получения результата для вектора " +
+                                           std::to_string(begin + receivedBytes / sizeof(double)));
+                    failed = true;
+                    continue;
+                }
+                const size_t completedBefore = receivedBytes / sizeof(double);
+                receivedBytes += static_cast<size_t>(got);
+                Tracer::span("receive", "net", recvQueued, Metrics::now(), begin + completedBefore,
+                             receivedBytes / sizeof(double) - completedBefore);
+                sentAt.record(vectors, begin, completedBefore, receivedBytes / sizeof(double));
             }
+        }
+    }
+    
+    if (failed) {
+        // Операции в кольце ссылаются на локальные буферы: будим и дожидаемся их
+        receivedBytes += drainIo();
+    }
+    
+    if (registered) {
+        io->unregisterBuffer();
+    }
+    resultsReceived = receivedBytes / sizeof(double);
+    
+    if (failed) {
+        return false;
+    }
+    
+    LOG_INFO("Успешно отправлено " << total << " векторов и получено " << resultsReceived
+             << " результатов (окно " << pipelineWindow << ", " << io->name() << ")");
+    return true;
+}
+
+/**
+ * @brief Отправляет заголовок задания - количество векторов
+ * @param [in] count Количество векторов, которые будут отправлены
+ * @return true если отправка успешна, false в случае ошибки
+ * @details При TCP_NODELAY отдельные 4 байта ушли бы своим сегментом.
+ * С MSG_MORE ядро придерживает их до следующей отправки (векторов или
+ * sendfile()), и заголовок уходит вместе с первыми векторами. Пустое
+ * задание продолжения не имеет и отправляется без флага.
+ */
+bool ServerConnection::sendVectorHeader(uint32_t count) {
+    struct iovec iov;
+    iov.iov_base = &count;
+    iov.iov_len = sizeof(count);
+    if (!sendIov(&iov, 1, count > 0 ? MSG_MORE : 0)) {
+        ErrorHandler::logError("Ошибка отправки количества векторов");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Принимает результаты обработки векторов
+ * @param [out] results Буфер для результатов
+ * @param [in] count Количество ожидаемых результатов
+ * @param [in] firstVector Номер вектора первого результата на шкале трассировки
+ * @return true если получены все результаты, false в случае ошибки
+ * @details Вызывается из отдельного потока-получателя, поэтому читает сокет
+ * напрямую, не через механизм ввода-вывода потока-отправителя.
+ */
+bool ServerConnection::receiveResults(double* results, size_t count, size_t firstVector) {
+    if (receiveResultStream(results, count, firstVector) != count) {
+        ErrorHandler::logError("Ошибка получения бинарных данных");
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Прерывает обмен данными
+ * @details Закрывает сокет на чтение и запись, не освобождая дескриптор,
+ * чтобы разбудить потоки, заблокированные в send() или recv().
+ */
+void ServerConnection::abortTransfer() {
+    if (socketFD >= 0) {
+        shutdown(socketFD, SHUT_RDWR);
+    }
+}
+
+/**
+ * @brief Отправляет участок файла в сокет без копирования в память процесса
+ * @param [in] fileFD Дескриптор файла
+ * @param [in] offset Смещение участка в файле
+ * @param [in] length Длина участка в байтах
+ * @return true если участок отправлен целиком, false в случае ошибки
+ * @details Использует sendfile(): данные идут из страничного кэша прямо
+ * в сокет. Вызов повторяется, пока не отправлен весь участок.
+ * sendfile() не принимает MSG_NOSIGNAL, поэтому на время отправки SIGPIPE
+ * блокируется в вызывающем потоке, а сигнал, порожденный разрывом
+ * соединения, снимается sigtimedwait() до восстановления маски.
+ */
+bool ServerConnection::sendFileRegion(int fileFD, size_t offset, size_t length) {
+    off_t position = static_cast<off_t>(offset);
+    size_t remaining = length;
+    
+    sigset_t pipeSet;
+    sigset_t oldSet;
+    sigset_t pendingSet;
+    sigemptyset(&pipeSet);
+    sigaddset(&pipeSet, SIGPIPE);
+    pthread_sigmask(SIG_BLOCK, &pipeSet, &oldSet);
+    sigpending(&pendingSet);
+    const bool pipePending = sigismember(&pendingSet, SIGPIPE) == 1;  // Чужой сигнал не снимается
+    
+    bool ok = true;
+    while (remaining > 0) {
+        const size_t chunk = std::min(remaining, static_cast<size_t>(1) << 30);
+        const uint64_t start = Metrics::now();
+        ssize_t sent = sendfile(socketFD, fileFD, &position, chunk);
+        Metrics::add(Metrics::SYSCALLS);
+        Metrics::recordSend(Metrics::SEND, start, sent);
+        if (sent < 0 && errno == EINTR) {
+            Metrics::add(Metrics::RETRIES);
+            continue;
+        }
+        if (sent <= 0) {
+            if (sent < 0 && errno == EPIPE && !pipePending) {
+                const struct timespec noWait = {0, 0};
+                while (sigtimedwait(&pipeSet, nullptr, &noWait) == SIGPIPE) {
+                }
+            }
+            ErrorHandler::logError("Ошибка отправки файла в сокет (sendfile)");
+            ok = false;
+            break;
+        }
+        if (static_cast<size_t>(sent) < chunk) {
+            Metrics::add(Metrics::RETRIES);  // Частичная отправка: повтор с остатком
+        }
+        remaining -= static_cast<size_t>(sent);
+    }
+    
+    pthread_sigmask(SIG_SETMASK, &oldSet, nullptr);
+    return ok;
+}
+
+/**
+ * @brief Принимает поток результатов до первой ошибки
+ * @param [out] results Буфер для результатов
+ * @param [in] count Количество ожидаемых результатов
+ * @param [in] firstVector Номер вектора первого результата на шкале трассировки
+ * @return Количество полностью полученных результатов
+ * @details Читает столько данных, сколько пришло (до 64 КБ за вызов), прямо
+ * в буфер результатов.
+ */
+size_t ServerConnection::receiveResultStream(double* results, size_t count, size_t firstVector) {
+    char* out = reinterpret_cast<char*>(results);
+    const size_t totalBytes = count * sizeof(double);
+    size_t receivedBytes = 0;
+    
+    while (receivedBytes < totalBytes) {
+        const uint64_t start = Metrics::now();
+        ssize_t got = recv(socketFD, out + receivedBytes,
+                           std::min<size_t>(64 * 1024, totalBytes - receivedBytes), 0);
+        Metrics::add(Metrics::SYSCALLS);
+        Metrics::recordReceive(Metrics::RECEIVE, start, got);
+        if (got < 0 && errno == EINTR) {
+            Metrics::add(Metrics::RETRIES);
+            continue;
+        }
+        if (got <= 0) break;
+        const size_t completedBefore = receivedBytes / sizeof(double);
+        receivedBytes += static_cast<size_t>(got);
+        Tracer::span("receive", "net", start, Metrics::now(), firstVector + completedBefore,
+                     receivedBytes / sizeof(double) - completedBefore);
+    }
+    
+    return receivedBytes / sizeof(double);
+}
+
+/**
+ * @brief Отправляет векторы файла .vbin через sendfile и принимает результаты
+ * @param [in] vectors Хранилище, отображенное из файла .vbin
+ * @param [in] begin Индекс первого вектора
+ * @param [in] end Индекс, следующий за последним вектором
+ * @param [out] results Буфер для end - begin результатов
+ * @return true если операция успешна, false в случае ошибки
+ * @details Полезная нагрузка .vbin начинается с количества векторов и
+ * полностью совпадает с потоком, который ожидает сервер, поэтому все векторы
+ * отправляются одним участком файла. Для части векторов сначала отправляется
+ * собственный заголовок, затем участок файла с векторами диапазона. Поток-получатель параллельно читает результаты,
+ * не давая буферам сокета заполниться. Данные векторов не проходят через
+ * память процесса.
+ */
+bool ServerConnection::sendVectorsZeroCopy(const VectorStore& vectors, size_t begin, size_t end, double* results) {
+    const size_t total = end - begin;
+    
+    size_t received = 0;
+    std::thread receiver([&]() {
+        Tracer::nameThread("receiver");
+        received = receiveResultStream(results, total, begin);
+    });
+    
+    const int fileFD = vectors.mappedFile()->descriptor();
+    const size_t payloadOffset = vectors.mappedPayloadOffset();
+    bool sendOk;
+    {
+        TraceSpan span("sendfile", "net", begin, total);
+        if (begin == 0 && end == vectors.size()) {
+            sendOk = sendFileRegion(fileFD, payloadOffset, vectors.wireOffset(end));
         } else {
-            ErrorHandler::logError("Ошибка получения результата для вектора " + std::to_string(i));
-            return false;
+            sendOk = sendVectorHeader(static_cast<uint32_t>(total)) &&
+                     sendFileRegion(fileFD, payloadOffset + vectors.wireOffset(begin), vectors.wireBytes(begin, end));
         }
     }
+    if (!sendOk) {
+        abortTransfer();
+    }
+    receiver.join();
+    resultsReceived = received;
+    
+    if (!sendOk || received != total) {
+        if (sendOk) {
+            ErrorHandler::logError("Ошибка получения результата для вектора " + std::to_string(begin + received));
+        }
+        return false;
+    }
     
-    std::cout << "Лог: Успешно отправлено " << vectors.size() << " векторов и получено " << results.size() << " результатов" << std::endl;
+    LOG_INFO("Отправлено через sendfile " << total << " векторов, получено "
+             << received << " результатов");
     return true;
 }
 
@@ -351,7 +1158,7 @@ bool ServerConnection::sendVectors(const std::vector<std::vector<double>>& vecto
  */
 void ServerConnection::closeConnection() {
     if (socketFD >= 0) {
-        std::cout << "Лог: Закрытие соединения" << std::endl;
+        LOG_INFO("Закрытие соединения");
         close(socketFD);
         socketFD = -1;
     }
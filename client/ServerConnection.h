@@ -1,8 +1,13 @@
 #ifndef SERVERCONNECTION_H
 #define SERVERCONNECTION_H
 
+#include "VectorStore.h"
+#include "IoBackend.h"
 #include <string>
 #include <vector>
+#include <cstdint>
+#include <memory>
+#include <sys/uio.h>
 
 /**
  * @brief Класс для управления подключением к серверу
@@ -18,6 +23,34 @@ private:
     int socketFD;              ///< Дескриптор сокета
     std::string login;         ///< Логин пользователя
     std::string password;      ///< Пароль пользователя
+    size_t pipelineWindow;     ///< Максимальное число векторов, ожидающих результата
+    size_t resultsReceived;    ///< Количество результатов, полученных последним заданием
+    std::unique_ptr<IoBackend> io; ///< Механизм ввода-вывода потока, владеющего соединением
+    
+    /**
+     * @brief Отправляет буферы одним вызовом sendmsg через механизм ввода-вывода
+     * @param [in] msg Описание буферов
+     * @param [in] flags Флаги sendmsg
+     * @return Число отправленных байтов или -1 с кодом ошибки в errno
+     */
+    ssize_t ioSendmsg(const struct msghdr* msg, int flags);
+    
+    /**
+     * @brief Принимает данные вызовом recv через механизм ввода-вывода
+     * @param [out] buffer Буфер приема
+     * @param [in] size Размер буфера
+     * @param [in] flags Флаги recv
+     * @return Число принятых байтов или -1 с кодом ошибки в errno
+     */
+    ssize_t ioRecv(void* buffer, size_t size, int flags);
+    
+    /**
+     * @brief Прерывает обмен и дожидается всех операций механизма ввода-вывода
+     * @return Байт, принятых завершившимися операциями приема
+     * @details Вызывается перед выходом из метода, поставившего операции
+     * с локальными буферами, если обмен прерван.
+     */
+    size_t drainIo();
     
     /**
      * @brief Отправляет текстовые данные через сокет
@@ -49,6 +82,80 @@ private:
      */
     bool receiveBinaryData(void* data, size_t size);
     
+    /**
+     * @brief Отправляет набор буферов одним системным вызовом sendmsg
+     * @param [in,out] iov Массив описателей буферов (изменяется при частичной отправке)
+     * @param [in] count Количество описателей
+     * @param [in] flags Флаги sendmsg (MSG_MORE - данные будут дополнены следующей отправкой)
+     * @return true если отправлены все буферы, false в случае ошибки
+     */
+    bool sendIov(struct iovec* iov, size_t count, int flags = 0);
+    
+    /**
+     * @brief Отправляет векторы в конвейерном режиме со скользящим окном
+     * @param [in] vectors Векторы для обработки
+     * @param [in] begin Индекс первого вектора
+     * @param [in] end Индекс, следующий за последним вектором
+     * @param [out] results Буфер для end - begin результатов
+     * @return true если операция успешна, false в случае ошибки
+     * @details Текущий поток отправляет векторы пакетами scatter-gather,
+     * отдельный поток принимает результаты по порядку. Одновременно без ответа находится не более
+     * pipelineWindow векторов.
+     */
+    bool sendVectorsPipelined(const VectorStore& vectors, size_t begin, size_t end, double* results);
+    
+    /**
+     * @brief Отправляет векторы со скользящим окном в одном потоке через io_uring
+     * @param [in] vectors Векторы для обработки
+     * @param [in] begin Индекс первого вектора
+     * @param [in] end Индекс, следующий за последним вектором
+     * @param [out] results Буфер для end - begin результатов
+     * @return true если операция успешна, false в случае ошибки
+     * @details Отправка групп векторов и прием результатов одновременно
+     * находятся в кольце io_uring, поток-получатель не нужен.
+     */
+    bool sendVectorsAsync(const VectorStore& vectors, size_t begin, size_t end, double* results);
+    
+    /**
+     * @brief Отправляет один вектор и принимает его результат
+     * @param [in,out] iov Описатели поля размера и данных вектора
+     * @param [in] count Количество описателей
+     * @param [out] result Результат обработки вектора
+     * @param [in] vectorId Номер вектора на шкале трассировки
+     * @return true если обмен успешен, false в случае ошибки
+     */
+    bool exchangeVector(struct iovec* iov, size_t count, double& result, size_t vectorId);
+    
+    /**
+     * @brief Отправляет участок файла в сокет без копирования в память процесса
+     * @param [in] fileFD Дескриптор файла
+     * @param [in] offset Смещение участка в файле
+     * @param [in] length Длина участка в байтах
+     * @return true если участок отправлен целиком, false в случае ошибки
+     */
+    bool sendFileRegion(int fileFD, size_t offset, size_t length);
+    
+    /**
+     * @brief Принимает поток результатов до первой ошибки
+     * @param [out] results Буфер для результатов
+     * @param [in] count Количество ожидаемых результатов
+     * @param [in] firstVector Номер вектора первого результата на шкале трассировки
+     * @return Количество полностью полученных результатов
+     */
+    size_t receiveResultStream(double* results, size_t count, size_t firstVector);
+    
+    /**
+     * @brief Отправляет векторы файла .vbin через sendfile и принимает результаты
+     * @param [in] vectors Хранилище, отображенное из файла .vbin
+     * @param [in] begin Индекс первого вектора
+     * @param [in] end Индекс, следующий за последним вектором
+     * @param [out] results Буфер для end - begin результатов
+     * @return true если операция успешна, false в случае ошибки
+     * @details Полезная нагрузка файла уже имеет формат протокола и передается
+     * ядром напрямую из файла в сокет; результаты читаются параллельно.
+     */
+    bool sendVectorsZeroCopy(const VectorStore& vectors, size_t begin, size_t end, double* results);
+    
 public:
     /**
      * @brief Конструктор класса ServerConnection
@@ -69,6 +176,14 @@ public:
      */
     bool establishConnection(const std::string& address, int port);
     
+    /**
+     * @brief Использует уже подключенный сокет
+     * @param [in] fd Подключенный потоковый сокет (например, из socketpair)
+     * @details Соединение становится владельцем дескриптора и закроет его
+     * в closeConnection(). Дальше работа идет как после establishConnection().
+     */
+    void adoptSocket(int fd);
+    
     /**
      * @brief Выполняет аутентификацию на сервере
      * @param [in] login Логин пользователя
@@ -77,18 +192,102 @@ public:
      */
     bool authenticate(const std::string& login, const std::string& password);
     
+    /**
+     * @brief Задает размер окна конвейерной отправки
+     * @param [in] window Число векторов, которые могут ожидать ответа одновременно
+     * @details Значение 1 соответствует режиму "отправил - дождался ответа".
+     */
+    void setPipelineWindow(size_t window);
+    
+    /**
+     * @brief Выбирает механизм ввода-вывода соединения
+     * @param [in] kind "blocking", "uring" или "auto"
+     * @details По умолчанию используется блокирующий механизм. Недоступный
+     * io_uring заменяется блокирующим. Механизм используется потоком,
+     * вызывающим методы соединения; receiveResults() читает сокет напрямую,
+     * так как вызывается из отдельного потока.
+     */
+    void setIoBackend(const std::string& kind);
+    
     /**
      * @brief Отправляет векторы на сервер для обработки и получает результаты
      * @param [in] vectors Векторы для обработки
      * @param [out] results Результаты обработки от сервера
      * @return true если операция успешна, false в случае ошибки
      */
-    bool sendVectors(const std::vector<std::vector<double>>& vectors, std::vector<double>& results);
+    bool sendVectors(const VectorStore& vectors, std::vector<double>& results);
+    
+    /**
+     * @brief Отправляет часть векторов отдельным заданием и получает результаты
+     * @param [in] vectors Хранилище векторов
+     * @param [in] begin Индекс первого вектора
+     * @param [in] end Индекс, следующий за последним вектором
+     * @param [out] results Буфер для end - begin результатов
+     * @return true если получены все результаты, false в случае ошибки
+     * @details Серверу отправляется количество end - begin и векторы диапазона.
+     * После ошибки getResultsReceived() сообщает, сколько результатов успело
+     * прийти в начало буфера.
+     */
+    bool sendVectorRange(const VectorStore& vectors, size_t begin, size_t end, double* results);
+    
+    /**
+     * @brief Возвращает количество результатов, полученных последним заданием
+     * @return Количество результатов, записанных в начало буфера
+     */
+    size_t getResultsReceived() const { return resultsReceived; }
+    
+    /**
+     * @brief Отправляет заголовок задания - количество векторов
+     * @param [in] count Количество векторов, которые будут отправлены
+     * @return true если отправка успешна, false в случае ошибки
+     * @details Заголовок отправляется с MSG_MORE и уходит в сеть в одном
+     * сегменте с первыми векторами задания.
+     */
+    bool sendVectorHeader(uint32_t count);
+    
+    /**
+     * @brief Отправляет группу векторов пакетами scatter-gather
+     * @param [in] vectors Векторы для отправки
+     * @param [in] begin Индекс первого отправляемого вектора
+     * @param [in] end Индекс, следующий за последним отправляемым вектором
+     * @param [in] idOffset Сдвиг номеров векторов на шкале трассировки
+     * (для пачек, вырезанных из большого задания)
+     * @return true если отправка успешна, false в случае ошибки
+     * @details Описатели указывают прямо на поля размеров и значения векторов
+     * в хранилище, данные векторов не копируются.
+     */
+    bool sendVectorBatch(const VectorStore& vectors, size_t begin, size_t end, size_t idOffset = 0);
+    
+    /**
+     * @brief Принимает результаты обработки векторов
+     * @param [out] results Буфер для результатов
+     * @param [in] count Количество ожидаемых результатов
+     * @param [in] firstVector Номер вектора первого результата на шкале трассировки
+     * @return true если получены все результаты, false в случае ошибки
+     */
+    bool receiveResults(double* results, size_t count, size_t firstVector = 0);
+    
+    /**
+     * @brief Прерывает обмен данными
+     * @details Закрывает сокет на чтение и запись, не освобождая дескриптор,
+     * чтобы разбудить потоки, заблокированные в отправке или приеме.
+     */
+    void abortTransfer();
     
     /**
      * @brief Закрывает соединение с сервером
      */
     void closeConnection();
+    
+    /**
+     * @brief Продвигает описатели буферов после частичной отправки
+     * @param [in,out] iov Первый неотправленный описатель
+     * @param [in,out] count Количество неотправленных описателей
+     * @param [in] sent Количество отправленных байтов
+     * @details Полностью отправленные описатели пропускаются, у частично
+     * отправленного сдвигаются начало и длина.
+     */
+    static void advanceIov(struct iovec*& iov, size_t& count, size_t sent);
 };
 
 #endif // SERVERCONNECTION_H
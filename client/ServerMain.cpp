@@ -0,0 +1,55 @@
+/**
+ * @file ServerMain.cpp
+ * @brief Точка входа эталонного сервера
+ * @details Запускает ReferenceServer на 127.0.0.1 для проверки и замеров
+ * клиента без настоящего сервера.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+
+#include "ReferenceServer.h"
+#include "ErrorHandler.h"
+#include "Logger.h"
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <string>
+
+/**
+ * @brief Точка входа эталонного сервера
+ * @param [in] argc Количество аргументов командной строки
+ * @param [in] argv Массив аргументов командной строки
+ * @return EXIT_SUCCESS после остановки, EXIT_FAILURE при ошибке запуска
+ * @details Параметры:
+ *   -p <порт> - порт (по умолчанию: 33333)
+ *   -l <логин> - допустимый логин (по умолчанию: user)
+ *   -k <пароль> - пароль (по умолчанию: P@ssW0rd)
+ */
+int main(int argc, char* argv[]) {
+    int port = 33333;
+    std::string login = "user";
+    std::string password = "P@ssW0rd";
+    
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "-p") == 0 && i + 1 < argc) {
+            port = std::atoi(argv[++i]);
+        } else if (strcmp(argv[i], "-l") == 0 && i + 1 < argc) {
+            login = argv[++i];
+        } else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc) {
+            password = argv[++i];
+        } else {
+            std::cout << "Использование: ./refserver [-p <порт>] [-l <логин>] [-k <пароль>]\n";
+            return strcmp(argv[i], "-h") == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+    }
+    
+    ReferenceServer server(login, password);
+    if (!server.start(port)) {
+        return EXIT_FAILURE;
+    }
+    
+    LOG_INFO("Эталонный сервер слушает 127.0.0.1:" << server.getPort());
+    server.wait();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,142 @@
+/**
+ * @file ShardedProcessor.cpp
+ * @brief Реализация класса ShardedProcessor
+ * @details Содержит разделение векторов между соединениями и параллельную
+ * обработку участков в отдельных сессиях.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+
+#include "ShardedProcessor.h"
+#include "Client.h"
+#include "AsyncConnection.h"
+#include "Scheduler.h"
+#include "VectorStore.h"
+#include "ErrorHandler.h"
+#include "Logger.h"
+#include "Metrics.h"
+#include <algorithm>
+
+/**
+ * @brief Конструктор класса ShardedProcessor
+ * @param [in] clientConfig Конфигурация клиента (адрес, учетные данные, -j, -w)
+ */
+ShardedProcessor::ShardedProcessor(const ClientConfig& clientConfig) : config(clientConfig) {}
+
+/**
+ * @brief Делит векторы на участки примерно равного объема
+ * @param [in] vectors Векторы для разделения
+ * @param [in] parts Желаемое количество участков
+ * @return Границы участков: parts + 1 индексов от 0 до vectors.size()
+ * @details Граница k-го участка - первый вектор, смещение которого
+ * в формате протокола не меньше k/parts от общего объема. Смещения
+ * возрастают, поэтому граница ищется двоичным поиском.
+ */
+std::vector<size_t> ShardedProcessor::splitByBytes(const VectorStore& vectors, size_t parts) {
+    const size_t count = vectors.size();
+    const size_t totalBytes = vectors.wireBytes(0, count);
+    
+    std::vector<size_t> bounds(parts + 1, count);
+    bounds[0] = 0;
+    for (size_t k = 1; k < parts; ++k) {
+        const size_t target = totalBytes / parts * k;
+        size_t low = bounds[k - 1];
+        size_t high = count;
+        while (low < high) {
+            size_t middle = low + (high - low) / 2;
+            if (vectors.wireBytes(0, middle) < target) {
+                low = middle + 1;
+            } else {
+                high = middle;
+            }
+        }
+        bounds[k] = low;
+    }
+    
+    return bounds;
+}
+
+namespace {
+
+/**
+ * @brief Итог обработки одного участка
+ */
+struct ShardState {
+    size_t received;  ///< Полученные результаты участка
+    bool done;        ///< Участок обработан целиком
+};
+
+/**
+ * @brief Сопрограмма соединения одного участка
+ * @param [in] scheduler Планировщик
+ * @param [in] config Параметры подключения
+ * @param [in] vectors Векторы
+ * @param [in] begin Индекс первого вектора участка
+ * @param [in] end Индекс, следующий за последним вектором участка
+ * @param [out] results Общий массив результатов
+ * @param [in] shardId Номер соединения для сообщений
+ * @param [out] state Итог обработки участка
+ */
+Task<void> shardWorker(Scheduler& scheduler, const ClientConfig& config, const VectorStore& vectors, size_t begin,
+                       size_t end, std::vector<double>& results, size_t shardId, ShardState& state) {
+    AsyncConnection connection(scheduler);
+    connection.setPipelineWindow(config.pipelineWindow);
+    if (!co_await connection.connect(config.serverAddress, config.serverPort) ||
+        !co_await connection.authenticate(config.login, config.password)) {
+        ErrorHandler::logError("Соединение " + std::to_string(shardId) + ": ошибка подключения");
+        co_return;
+    }
+    state.done = co_await connection.process(vectors, begin, end, results.data() + begin);
+    state.received = connection.getResultsReceived();
+    connection.closeConnection();
+}
+
+}
+
+/**
+ * @brief Обрабатывает векторы в нескольких соединениях
+ * @param [in] vectors Векторы для обработки
+ * @param [out] results Результаты в порядке векторов
+ * @return true если все соединения завершились успешно, false в случае ошибки
+ * @details Каждый участок обрабатывает сопрограмма со своим AsyncConnection;
+ * подключение, аутентификация и обмен векторами всех соединений выполняются
+ * одним потоком планировщика Scheduler. Количество соединений не превышает
+ * количество векторов; пустые участки не отправляются.
+ */
+bool ShardedProcessor::run(const VectorStore& vectors, std::vector<double>& results) {
+    ProfileScope profile(Metrics::SEND);
+    MemoryScope memory(Metrics::SEND);
+    const size_t parts = std::max<size_t>(1, std::min(config.connections, vectors.size()));
+    const std::vector<size_t> bounds = splitByBytes(vectors, parts);
+    
+    results.assign(vectors.size(), 0.0);
+    
+    Scheduler scheduler;
+    if (!scheduler.eventLoop().isValid()) {
+        return false;
+    }
+    
+    std::vector<ShardState> shards(parts, ShardState{0, false});
+    size_t connections = 0;
+    for (size_t k = 0; k < parts; ++k) {
+        if (bounds[k] == bounds[k + 1]) {
+            shards[k].done = true;
+            continue;
+        }
+        scheduler.spawn(shardWorker(scheduler, config, vectors, bounds[k], bounds[k + 1], results, k + 1, shards[k]));
+        ++connections;
+    }
+    bool ok = scheduler.run();
+    
+    Metrics::add(Metrics::VECTORS, vectors.size());
+    for (size_t k = 0; k < parts; ++k) {
+        ok = ok && shards[k].done;
+        Metrics::add(Metrics::RESULTS, shards[k].received);
+    }
+    
+    if (ok) {
+        LOG_INFO("Векторы обработаны в " << connections << " соединениях");
+    }
+    return ok;
+}
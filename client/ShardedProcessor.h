@@ -0,0 +1,51 @@
+#ifndef SHARDEDPROCESSOR_H
+#define SHARDEDPROCESSOR_H
+
+#include <vector>
+#include <cstddef>
+
+struct ClientConfig;
+class VectorStore;
+
+/**
+ * @brief Класс для обработки векторов через несколько соединений с сервером
+ * @details Делит векторы на непрерывные участки примерно равного объема
+ * и обрабатывает каждый участок в отдельном аутентифицированном соединении
+ * AsyncConnection; все соединения обслуживает один поток планировщика Scheduler.
+ * Результаты каждой сессии записываются на свое место в общем массиве,
+ * поэтому порядок результатов совпадает с порядком векторов.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+class ShardedProcessor {
+private:
+    const ClientConfig& config;  ///< Параметры подключения и количество соединений
+    
+public:
+    /**
+     * @brief Конструктор класса ShardedProcessor
+     * @param [in] clientConfig Конфигурация клиента (адрес, учетные данные, -j, -w)
+     */
+    explicit ShardedProcessor(const ClientConfig& clientConfig);
+    
+    /**
+     * @brief Обрабатывает векторы в нескольких соединениях
+     * @param [in] vectors Векторы для обработки
+     * @param [out] results Результаты в порядке векторов
+     * @return true если все соединения завершились успешно, false в случае ошибки
+     */
+    bool run(const VectorStore& vectors, std::vector<double>& results);
+    
+    /**
+     * @brief Делит векторы на участки примерно равного объема
+     * @param [in] vectors Векторы для разделения
+     * @param [in] parts Желаемое количество участков
+     * @return Границы участков: parts + 1 индексов от 0 до vectors.size()
+     * @details Объем участка считается в байтах формата протокола, поэтому
+     * длинные векторы не скапливаются в одном соединении.
+     */
+    static std::vector<size_t> splitByBytes(const VectorStore& vectors, size_t parts);
+};
+
+#endif // SHARDEDPROCESSOR_H
@@ -0,0 +1,544 @@
+/**
+ * @file StreamProcessor.cpp
+ * @brief Реализация класса StreamProcessor
+ * @details Содержит потоковый конвейер чтение -> отправка -> прием -> запись
+ * с очередями ограниченной емкости между стадиями.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+
+#include "StreamProcessor.h"
+#include "ServerConnection.h"
+#include "ErrorHandler.h"
+#include "Logger.h"
+#include "BoundedQueue.h"
+#include "TextParser.h"
+#include "VectorStore.h"
+#include "VbinFormat.h"
+#include "ResultWriter.h"
+#include "Metrics.h"
+#include "Tracer.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <deque>
+#include <vector>
+#include <algorithm>
+
+namespace {
+
+/**
+ * @brief Чтение лексем из файла блоками фиксированного размера
+ * @details Держит в памяти один блок файла. Лексема, разрезанная границей
+ * блока, переносится в начало буфера перед дочитыванием. Для сообщений
+ * об ошибках отслеживаются номер строки и столбец отброшенной части файла.
+ */
+class TokenReader {
+private:
+    int fileFD;                ///< Дескриптор входного файла
+    std::vector<char> buffer;  ///< Текущий блок файла
+    size_t pos;                ///< Позиция разбора в буфере
+    size_t length;             ///< Количество данных в буфере
+    bool eof;                  ///< Файл прочитан до конца
+    size_t tokenStart;         ///< Начало последней лексемы в буфере
+    uint64_t line;             ///< Номер строки начала буфера
+    uint64_t column;           ///< Столбец начала буфера (с нуля)
+    
+    /**
+     * @brief Отбрасывает разобранную часть буфера и дочитывает файл
+     * @return true если чтение успешно, false в случае ошибки
+     */
+    bool refill() {
+        // Учитываем строки отбрасываемой части
+        for (size_t i = 0; i < pos; ++i) {
+            const char* nl = static_cast<const char*>(memchr(buffer.data() + i, '\n', pos - i));
+            if (!nl) {
+                column += pos - i;
+                break;
+            }
+            ++line;
+            column = 0;
+            i = static_cast<size_t>(nl - buffer.data());
+        }
+        
+        memmove(buffer.data(), buffer.data() + pos, length - pos);
+        length -= pos;
+        pos = 0;
+        if (length == buffer.size()) {
+            buffer.resize(buffer.size() * 2);  // Лексема длиннее блока
+        }
+        
+        while (true) {
+            ssize_t got = read(fileFD, buffer.data() + length, buffer.size() - length);
+            Metrics::add(Metrics::SYSCALLS);
+            if (got < 0 && errno == EINTR) {
+                Metrics::add(Metrics::RETRIES);
+                continue;
+            }
+            if (got < 0) return false;
+            if (got == 0) eof = true;
+            Metrics::add(Metrics::BYTES_PARSED, static_cast<uint64_t>(got));
+            length += static_cast<size_t>(got);
+            return true;
+        }
+    }
+    
+public:
+    TokenReader() : fileFD(-1), buffer(1 << 20), pos(0), length(0), eof(false),
+                    tokenStart(0), line(1), column(0) {}
+    
+    ~TokenReader() {
+        if (fileFD >= 0) {
+            close(fileFD);
+        }
+    }
+    
+    bool open(const std::string& filename) {
+        fileFD = ::open(filename.c_str(), O_RDONLY);
+        if (fileFD < 0) {
+            return false;
+        }
+        posix_fadvise(fileFD, 0, 0, POSIX_FADV_SEQUENTIAL);
+        return true;
+    }
+    
+    /**
+     * @brief Возвращает следующую лексему
+     * @param [out] begin Начало лексемы
+     * @param [out] end Конец лексемы
+     * @return 1 - лексема найдена, 0 - конец файла, -1 - ошибка чтения
+     */
+    int next(const char*& begin, const char*& end) {
+        while (true) {
+            while (pos < length && TextParser::isSpace(buffer[pos])) {
+                ++pos;
+            }
+            tokenStart = pos;
+            if (pos == length) {
+                if (eof) return 0;
+                if (!refill()) return -1;
+                continue;
+            }
+            
+            size_t p = pos;
+            while (p < length && !TextParser::isSpace(buffer[p])) {
+                ++p;
+            }
+            if (p == length && !eof) {
+                if (!refill()) return -1;
+                continue;
+            }
+            
+            begin = buffer.data() + pos;
+            end = buffer.data() + p;
+            pos = p;
+            return 1;
+        }
+    }
+    
+    /**
+     * @brief Описывает позицию последней лексемы для сообщений об ошибках
+     * @return Строка вида "строка N, столбец M"
+     */
+    std::string describePosition() const {
+        uint64_t tokenLine = line;
+        uint64_t tokenColumn = column + tokenStart;
+        for (size_t i = 0; i < tokenStart; ++i) {
+            if (buffer[i] == '\n') {
+                ++tokenLine;
+                tokenColumn = tokenStart - i - 1;
+            }
+        }
+        return "строка " + std::to_string(tokenLine) + ", столбец " + std::to_string(tokenColumn + 1);
+    }
+};
+
+/**
+ * @brief Буферизованная запись в файловый дескриптор
+ */
+class OutputBuffer {
+private:
+    int fileFD;                ///< Дескриптор выходного файла
+    std::vector<char> buffer;  ///< Накопленные данные
+    size_t length;             ///< Заполненная часть буфера
+    
+public:
+    explicit OutputBuffer(int fd) : fileFD(fd), buffer(1 << 20), length(0) {}
+    
+    bool flush() {
+        TraceSpan span("write", "file");
+        size_t written = 0;
+        while (written < length) {
+            ssize_t n = write(fileFD, buffer.data() + written, length - written);
+            Metrics::add(Metrics::SYSCALLS);
+            if (n < 0 && errno == EINTR) {
+                Metrics::add(Metrics::RETRIES);
+                continue;
+            }
+            if (n <= 0) return false;
+            Metrics::add(Metrics::BYTES_WRITTEN, static_cast<uint64_t>(n));
+            written += static_cast<size_t>(n);
+        }
+        length = 0;
+        return true;
+    }
+    
+    /**
+     * @brief Возвращает место для записи не менее reserve байт
+     */
+    char* reserve(size_t bytes) {
+        if (buffer.size() - length < bytes && !flush()) {
+            return nullptr;
+        }
+        return buffer.data() + length;
+    }
+    
+    void commit(size_t bytes) { length += bytes; }
+};
+
+/**
+ * @brief Отправленные пачки, ожидающие результатов
+ * @details Стадия отправки запоминает время отправки пачки и размерности
+ * ее векторов, стадия приема снимает их в том же порядке и учитывает
+ * задержки ответа. Значения векторов не хранятся, поэтому память на
+ * вектор без ответа - одна размерность.
+ */
+class SentBatches {
+private:
+    /**
+     * @brief Пачка без полученных результатов
+     */
+    struct Batch {
+        uint64_t sentAt;                   ///< Начало отправки пачки
+        std::vector<uint32_t> dimensions;  ///< Размерности векторов пачки
+    };
+    
+    std::mutex mutex;
+    std::deque<Batch> batches;  ///< Пачки в порядке отправки
+    size_t answered;            ///< Векторы первой пачки с учтенным ответом
+    
+public:
+    SentBatches() : answered(0) {}
+    
+    /**
+     * @brief Запоминает пачку перед отправкой
+     */
+    void add(const VectorStore& batch) {
+        Batch entry;
+        entry.sentAt = Metrics::now();
+        entry.dimensions.resize(batch.size());
+        for (size_t i = 0; i < batch.size(); ++i) {
+            entry.dimensions[i] = batch.dimension(i);
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        batches.push_back(std::move(entry));
+    }
+    
+    /**
+     * @brief Учитывает задержки ответа на следующие count векторов
+     */
+    void recordReceived(size_t count) {
+        const uint64_t now = Metrics::now();
+        std::lock_guard<std::mutex> lock(mutex);
+        while (count > 0 && !batches.empty()) {
+            const Batch& front = batches.front();
+            const size_t take = std::min(count, front.dimensions.size() - answered);
+            for (size_t i = answered; i < answered + take; ++i) {
+                Metrics::recordLatency(front.dimensions[i], now - front.sentAt);
+            }
+            answered += take;
+            count -= take;
+            if (answered == front.dimensions.size()) {
+                batches.pop_front();
+                answered = 0;
+            }
+        }
+    }
+};
+
+}  // namespace
+
+/**
+ * @brief Конструктор класса StreamProcessor
+ * @param [in] conn Соединение, на котором уже выполнена аутентификация
+ * @details Пачки до 4096 векторов или 128K значений (1 МБ), по 8 пачек
+ * в каждой очереди
+ */
+StreamProcessor::StreamProcessor(ServerConnection& conn)
+    : connection(conn), batchVectors(4096), batchValues(128 * 1024), queueDepth(8), transferStarted(false),
+      resultFormat(ResultWriter::TEXT) {}
+
+/**
+ * @brief Задает формат файла результатов
+ * @param [in] format Формат
+ */
+void StreamProcessor::setResultFormat(ResultWriter::Format format) {
+    resultFormat = format;
+}
+
+/**
+ * @brief Проверяет, начался ли обмен с сервером в последнем вызове run()
+ * @return true если на сервер отправлен заголовок задания
+ */
+bool StreamProcessor::hasStartedTransfer() const {
+    return transferStarted;
+}
+
+/**
+ * @brief Обрабатывает входной файл и записывает результаты
+ * @param [in] inputFileName Имя входного файла (текстовый формат)
+ * @param [in] outputFileName Имя выходного файла
+ * @return true если задание выполнено, false в случае ошибки
+ * @details Текущий поток читает заголовок файла и отправляет серверу
+ * количество векторов, затем запускает стадии:
+ * 1. Чтение: разбирает файл блоками и формирует пачки векторов
+ * 2. Отправка: передает пачки через sendVectorBatch()
+ * 3. Прием: читает результаты пачками по batchVectors
+ * 4. Запись (текущий поток): форматирует результаты во временный файл,
+ *    который после успешного обмена переименовывается в выходной (ResultWriter)
+ * 
+ * Ошибка любой стадии закрывает очереди и прерывает обмен с сервером,
+ * чтобы остальные стадии завершились. Задержка ответа на вектор считается
+ * от начала отправки его пачки до приема пачки результатов с ним.
+ */
+bool StreamProcessor::run(const std::string& inputFileName, const std::string& outputFileName) {
+    transferStarted = false;
+    if (VbinFormat::isVbinFile(inputFileName)) {
+        ErrorHandler::logError("Потоковый режим поддерживает только текстовые входные файлы: " + inputFileName);
+        return false;
+    }
+    
+    TokenReader reader;
+    if (!reader.open(inputFileName)) {
+        ErrorHandler::logError("Не удалось открыть файл: " + inputFileName);
+        return false;
+    }
+    
+    const char* token;
+    const char* tokenEnd;
+    uint64_t numVectors;
+    if (reader.next(token, tokenEnd) != 1 || !TextParser::parseCountToken(token, tokenEnd, numVectors) ||
+        numVectors == 0 || numVectors > UINT32_MAX) {
+        ErrorHandler::logError("Ошибка чтения количества векторов из файла " + inputFileName +
+                               " (" + reader.describePosition() + ")");
+        return false;
+    }
+    
+    std::string tempName;
+    int outFD = ResultWriter::openTemporary(outputFileName, tempName);
+    if (outFD < 0) {
+        return false;
+    }
+    
+    transferStarted = true;
+    if (!connection.sendVectorHeader(static_cast<uint32_t>(numVectors))) {
+        ResultWriter::discard(outFD, tempName);
+        return false;
+    }
+    
+    BoundedQueue<VectorStore> toSend(queueDepth);
+    BoundedQueue<std::vector<double>> toWrite(queueDepth);
+    std::atomic<bool> failed(false);
+    
+    auto fail = [&]() {
+        failed = true;
+        toSend.close();
+        toWrite.close();
+        connection.abortTransfer();
+    };
+    
+    // Двоичные форматы: столбцы размеров и номеров пишет стадия чтения,
+    // контрольная сумма попадает в заголовок после чтения всего файла
+    ResultHeader header = ResultWriter::makeHeader(resultFormat, numVectors, 0);
+    uint64_t checksum = ResultWriter::CHECKSUM_SEED;
+    
+    // 1. Чтение и разбор
+    std::thread readerThread([&]() {
+        Tracer::nameThread("reader");
+        uint64_t index = 0;
+        std::vector<uint32_t> columns;
+        while (index < numVectors) {
+            const uint64_t parseStart = Metrics::now();
+            const uint64_t first = index;
+            VectorStore batch;
+            batch.reserve(batchVectors, batchValues);
+            
+            while (index < numVectors && batch.size() < batchVectors && batch.valueCount() < batchValues) {
+                uint64_t vectorSize;
+                if (reader.next(token, tokenEnd) != 1 ||
+                    !TextParser::parseCountToken(token, tokenEnd, vectorSize) ||
+                    vectorSize == 0 || vectorSize > UINT32_MAX) {
+                    ErrorHandler::logError("Ошибка чтения размера вектора " + std::to_string(index + 1) +
+                                           " (" + reader.describePosition() + ")");
+                    fail();
+                    return;
+                }
+                
+                double* values = batch.append(static_cast<uint32_t>(vectorSize));
+                for (uint64_t j = 0; j < vectorSize; ++j) {
+                    if (reader.next(token, tokenEnd) != 1 ||
+                        !TextParser::parseDoubleToken(token, tokenEnd, values[j])) {
+                        ErrorHandler::logError("Ошибка чтения значения вектора " + std::to_string(index + 1) +
+                                               " (" + reader.describePosition() + ")");
+                        fail();
+                        return;
+                    }
+                }
+                ++index;
+            }
+            const uint64_t parseEnd = Metrics::now();
+            Metrics::recordPhase(Metrics::PARSE, parseStart, parseEnd);
+            Tracer::span("parse_batch", "file", parseStart, parseEnd, first, index - first);
+            
+            if (resultFormat != ResultWriter::TEXT) {
+                for (size_t i = 0; i < batch.size(); ++i) {
+                    checksum = ResultWriter::updateChecksum(checksum, batch[i]);
+                }
+            }
+            if (resultFormat == ResultWriter::COLUMNAR) {
+                const size_t count = batch.size();
+                columns.resize(count * 2);
+                for (size_t i = 0; i < count; ++i) {
+                    columns[i] = batch[i].size();
+                    columns[count + i] = static_cast<uint32_t>(first + i);
+                }
+                if (!ResultWriter::writeAt(outFD, columns.data(), count * sizeof(uint32_t),
+                                           header.dimsOffset + first * sizeof(uint32_t)) ||
+                    !ResultWriter::writeAt(outFD, columns.data() + count, count * sizeof(uint32_t),
+                                           header.indexOffset + first * sizeof(uint32_t))) {
+                    ErrorHandler::logError("Ошибка записи в файл: " + outputFileName);
+                    fail();
+                    return;
+                }
+            }
+            
+            if (!toSend.push(std::move(batch))) {
+                return;
+            }
+        }
+        toSend.close();
+    });
+    
+    SentBatches inFlight;
+    
+    // 2. Отправка
+    std::thread senderThread([&]() {
+        Tracer::nameThread("sender");
+        VectorStore batch;
+        size_t sent = 0;
+        while (toSend.pop(batch)) {
+            inFlight.add(batch);
+            if (!connection.sendVectorBatch(batch, 0, batch.size(), sent)) {
+                fail();
+                return;
+            }
+            sent += batch.size();
+            Metrics::add(Metrics::VECTORS, batch.size());
+        }
+    });
+    
+    // 3. Прием результатов
+    std::thread receiverThread([&]() {
+        Tracer::nameThread("receiver");
+        uint64_t remaining = numVectors;
+        while (remaining > 0) {
+            size_t count = static_cast<size_t>(std::min<uint64_t>(remaining, batchVectors));
+            std::vector<double> results(count);
+            if (!connection.receiveResults(results.data(), count, numVectors - remaining)) {
+                if (failed) {
+                    return;  // Обмен прерван другой стадией
+                }
+                ErrorHandler::logError("Ошибка получения результата для вектора " +
+                                       std::to_string(numVectors - remaining));
+                fail();
+                return;
+            }
+            inFlight.recordReceived(count);
+            remaining -= count;
+            Metrics::add(Metrics::RESULTS, count);
+            if (!toWrite.push(std::move(results))) {
+                return;
+            }
+        }
+        toWrite.close();
+    });
+    
+    // 4. Запись результатов в формате saveResults()
+    const bool text = resultFormat == ResultWriter::TEXT;
+    OutputBuffer output(outFD);
+    bool writeOk = true;
+    char* out = output.reserve(sizeof(header));
+    if (out && text) {
+        output.commit(snprintf(out, 32, "%llu", static_cast<unsigned long long>(numVectors)));
+    } else if (out) {
+        memcpy(out, &header, sizeof(header));
+        output.commit(sizeof(header));
+    }
+    writeOk = out != nullptr;
+    
+    std::vector<double> results;
+    while (writeOk && toWrite.pop(results)) {
+        PhaseTimer timer(Metrics::SAVE);
+        if (!text) {
+            // Пачка приема не больше batchVectors и помещается в буфер
+            out = output.reserve(results.size() * sizeof(double));
+            writeOk = out != nullptr;
+            if (out) {
+                memcpy(out, results.data(), results.size() * sizeof(double));
+                output.commit(results.size() * sizeof(double));
+            }
+            continue;
+        }
+        for (double value : results) {
+            out = output.reserve(ResultWriter::MAX_VALUE_CHARS + 1);
+            if (!out) {
+                writeOk = false;
+                break;
+            }
+            *out = ' ';
+            output.commit(ResultWriter::formatValue(value, out + 1) + 1);
+        }
+    }
+    if (writeOk && !failed && text) {
+        out = output.reserve(1);
+        writeOk = out != nullptr;
+        if (out) {
+            *out = '\n';
+            output.commit(1);
+        }
+    }
+    writeOk = writeOk && (failed || output.flush());
+    if (!writeOk) {
+        ErrorHandler::logError("Ошибка записи в файл: " + outputFileName);
+        fail();
+    }
+    
+    readerThread.join();
+    senderThread.join();
+    receiverThread.join();
+    
+    if (!failed && !text) {
+        header.sourceChecksum = checksum;
+        if (!ResultWriter::writeAt(outFD, &header, sizeof(header), 0)) {
+            ErrorHandler::logError("Ошибка записи в файл: " + outputFileName);
+            failed = true;
+        }
+    }
+    if (failed) {
+        ResultWriter::discard(outFD, tempName);
+        return false;
+    }
+    if (!ResultWriter::publish(outFD, tempName, outputFileName)) {
+        return false;
+    }
+    
+    LOG_INFO("Потоково обработано " << numVectors << " векторов");
+    return true;
+}
@@ -0,0 +1,63 @@
+#ifndef STREAMPROCESSOR_H
+#define STREAMPROCESSOR_H
+
+#include "ResultWriter.h"
+#include <string>
+#include <cstddef>
+
+class ServerConnection;
+
+/**
+ * @brief Класс потоковой обработки входного файла с ограниченным расходом памяти
+ * @details Выполняет задание конвейером из четырех стадий, работающих одновременно:
+ * чтение и разбор файла, отправка векторов, прием результатов и запись
+ * выходного файла. Стадии связаны очередями ограниченной емкости, поэтому
+ * расход памяти не зависит от размера входного файла, а чтение с диска
+ * перекрывается с сетевым обменом.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+class StreamProcessor {
+private:
+    ServerConnection& connection;  ///< Аутентифицированное соединение с сервером
+    size_t batchVectors;           ///< Максимум векторов в одной пачке
+    size_t batchValues;            ///< Максимум значений в одной пачке
+    size_t queueDepth;             ///< Емкость очередей между стадиями (в пачках)
+    bool transferStarted;          ///< Заголовок задания уже отправлен на сервер
+    ResultWriter::Format resultFormat;  ///< Формат файла результатов
+    
+public:
+    /**
+     * @brief Конструктор класса StreamProcessor
+     * @param [in] conn Соединение, на котором уже выполнена аутентификация
+     */
+    explicit StreamProcessor(ServerConnection& conn);
+    
+    /**
+     * @brief Задает формат файла результатов
+     * @param [in] format Формат (по умолчанию ResultWriter::TEXT)
+     */
+    void setResultFormat(ResultWriter::Format format);
+    
+    /**
+     * @brief Обрабатывает входной файл и записывает результаты
+     * @param [in] inputFileName Имя входного файла (текстовый формат)
+     * @param [in] outputFileName Имя выходного файла
+     * @return true если задание выполнено, false в случае ошибки
+     * @details Формат входного и выходного файлов совпадает с форматом
+     * DataProcessor::readVectorsFromFile() и DataProcessor::saveResults().
+     * Результаты пишутся во временный файл, который при ошибке удаляется.
+     */
+    bool run(const std::string& inputFileName, const std::string& outputFileName);
+    
+    /**
+     * @brief Проверяет, начался ли обмен с сервером в последнем вызове run()
+     * @return true если на сервер отправлен заголовок задания
+     * @details Если run() завершился ошибкой до начала обмена,
+     * сессию можно использовать для следующего задания.
+     */
+    bool hasStartedTransfer() const;
+};
+
+#endif // STREAMPROCESSOR_H
@@ -0,0 +1,156 @@
+#ifndef TASK_H
+#define TASK_H
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+
+/**
+ * @brief Ожидающий объект завершения сопрограммы Task
+ * @details При завершении сопрограммы управление передается ожидающей
+ * сопрограмме (симметричная передача), а если ее нет - возвращается
+ * вызывающему resume().
+ */
+struct TaskFinalAwaiter {
+    bool await_ready() const noexcept { return false; }
+    
+    template <typename Promise>
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) const noexcept {
+        std::coroutine_handle<> continuation = handle.promise().continuation;
+        return continuation ? continuation : std::noop_coroutine();
+    }
+    
+    void await_resume() const noexcept {}
+};
+
+/**
+ * @brief Общая часть обещаний сопрограмм Task
+ */
+struct TaskPromiseBase {
+    std::coroutine_handle<> continuation;  ///< Сопрограмма, ожидающая результата
+    
+    std::suspend_always initial_suspend() const noexcept { return {}; }
+    TaskFinalAwaiter final_suspend() const noexcept { return {}; }
+    
+    /**
+     * @brief Исключения в проекте не используются: ошибки возвращаются значением
+     */
+    void unhandled_exception() const noexcept { std::terminate(); }
+};
+
+/**
+ * @brief Ленивая сопрограмма с результатом типа T
+ * @details Начинает выполнение при первом co_await или при запуске через
+ * Scheduler. Владеет кадром сопрограммы и уничтожает его в деструкторе.
+ * Объекты только перемещаются.
+ * @tparam T Тип результата (void - без результата)
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+template <typename T>
+class Task {
+public:
+    /**
+     * @brief Обещание сопрограммы с результатом
+     */
+    struct promise_type : TaskPromiseBase {
+        T value{};  ///< Результат сопрограммы
+        
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        void return_value(T result) { value = std::move(result); }
+    };
+    
+    typedef std::coroutine_handle<promise_type> Handle;
+    
+    explicit Task(Handle coroutine) : handle(coroutine) {}
+    Task(Task&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle) handle.destroy();
+            handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task() {
+        if (handle) handle.destroy();
+    }
+    
+    bool await_ready() const noexcept { return false; }
+    
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle.promise().continuation = awaiting;
+        return handle;
+    }
+    
+    T await_resume() { return std::move(handle.promise().value); }
+    
+    /**
+     * @brief Возвращает описатель сопрограммы
+     * @return Описатель (владение остается у Task)
+     */
+    Handle coroutine() const { return handle; }
+    
+    /**
+     * @brief Возвращает результат завершенной сопрограммы
+     * @return Результат
+     */
+    T result() { return std::move(handle.promise().value); }
+    
+private:
+    Handle handle;  ///< Кадр сопрограммы
+};
+
+/**
+ * @brief Ленивая сопрограмма без результата
+ */
+template <>
+class Task<void> {
+public:
+    /**
+     * @brief Обещание сопрограммы без результата
+     */
+    struct promise_type : TaskPromiseBase {
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        void return_void() const noexcept {}
+    };
+    
+    typedef std::coroutine_handle<promise_type> Handle;
+    
+    explicit Task(Handle coroutine) : handle(coroutine) {}
+    Task(Task&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle) handle.destroy();
+            handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task() {
+        if (handle) handle.destroy();
+    }
+    
+    bool await_ready() const noexcept { return false; }
+    
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle.promise().continuation = awaiting;
+        return handle;
+    }
+    
+    void await_resume() const noexcept {}
+    
+    /**
+     * @brief Возвращает описатель сопрограммы
+     * @return Описатель (владение остается у Task)
+     */
+    Handle coroutine() const { return handle; }
+    
+private:
+    Handle handle;  ///< Кадр сопрограммы
+};
+
+#endif // TASK_H
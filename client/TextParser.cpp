@@ -0,0 +1,298 @@
+/**
+ * @file TextParser.cpp
+ * @brief Реализация класса TextParser
+ * @details Содержит быстрый разбор целых чисел и чисел double из текстового
+ * буфера без выделения памяти и без учета локали.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+
+#include "TextParser.h"
+#include <cstring>
+#include <charconv>
+#include <algorithm>
+
+/**
+ * @brief Точно представимые в double степени десяти (10^0 ... 10^22)
+ */
+static const double POW10[] = {
+    1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+    1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+/**
+ * @brief Проверяет, является ли символ десятичной цифрой
+ * @param [in] c Символ
+ * @return true для символов '0'-'9'
+ */
+static inline bool isDigit(char c) {
+    return static_cast<unsigned char>(c - '0') < 10;
+}
+
+/**
+ * @brief Конструктор класса TextParser
+ * @param [in] data Начало буфера
+ * @param [in] size Размер буфера в байтах
+ */
+TextParser::TextParser(const char* data, size_t size) : begin(data), cur(data), end(data + size) {}
+
+/**
+ * @brief Пропускает пробельные символы
+ */
+void TextParser::skipSpaces() {
+    while (cur < end && isSpace(*cur)) {
+        ++cur;
+    }
+}
+
+/**
+ * @brief Находит конец текущей лексемы
+ * @return Указатель на первый пробельный символ после лексемы или конец буфера
+ */
+const char* TextParser::tokenEnd() const {
+    const char* p = cur;
+    while (p < end && !isSpace(*p)) {
+        ++p;
+    }
+    return p;
+}
+
+/**
+ * @brief Пропускает одну лексему без разбора
+ * @return true если лексема пропущена, false если буфер закончился
+ * @details Используется для быстрого поиска границ векторов: значения
+ * пропускаются без преобразования в double.
+ */
+bool TextParser::skipToken() {
+    skipSpaces();
+    if (cur == end) {
+        return false;
+    }
+    cur = tokenEnd();
+    return true;
+}
+
+/**
+ * @brief Проверяет, остались ли в буфере лексемы
+ * @return true если до конца буфера только пробельные символы
+ */
+bool TextParser::atEnd() {
+    skipSpaces();
+    return cur == end;
+}
+
+/**
+ * @brief Разбирает целое неотрицательное число
+ * @param [out] value Разобранное значение
+ * @return true если число разобрано, false если лексема не является числом
+ * @details Допускается только последовательность цифр, завершенная пробельным
+ * символом или концом буфера. Переполнение uint64_t считается ошибкой.
+ */
+bool TextParser::parseCount(uint64_t& value) {
+    skipSpaces();
+    
+    const char* last = tokenEnd();
+    if (!parseCountToken(cur, last, value)) {
+        return false;
+    }
+    
+    cur = last;
+    return true;
+}
+
+/**
+ * @brief Разбирает одну лексему как целое неотрицательное число
+ * @param [in] token Начало лексемы
+ * @param [in] tokenEnd Конец лексемы
+ * @param [out] value Разобранное значение
+ * @return true если лексема целиком состоит из цифр и число помещается в uint64_t
+ */
+bool TextParser::parseCountToken(const char* token, const char* tokenEnd, uint64_t& value) {
+    if (token == tokenEnd) {
+        return false;
+    }
+    
+    uint64_t result = 0;
+    for (const char* p = token; p < tokenEnd; ++p) {
+        if (!isDigit(*p)) {
+            return false;
+        }
+        uint64_t digit = static_cast<uint64_t>(*p - '0');
+        if (result > (UINT64_MAX - digit) / 10) {
+            return false;
+        }
+        result = result * 10 + digit;
+    }
+    
+    value = result;
+    return true;
+}
+
+/**
+ * @brief Разбирает число с плавающей точкой
+ * @param [out] value Разобранное значение
+ * @return true если число разобрано, false если лексема не является числом
+ */
+bool TextParser::parseDouble(double& value) {
+    skipSpaces();
+    
+    const char* last = tokenEnd();
+    if (!parseDoubleToken(cur, last, value)) {
+        return false;
+    }
+    
+    cur = last;
+    return true;
+}
+
+/**
+ * @brief Разбирает одну лексему как число double
+ * @param [in] token Начало лексемы
+ * @param [in] tokenEnd Конец лексемы
+ * @param [out] value Разобранное значение
+ * @return true если лексема целиком является числом
+ * @details Допускается только десятичная запись: знак, цифры с необязательной
+ * дробной частью и порядок. inf, nan и шестнадцатеричная запись не являются
+ * числами, значение за пределами double - ошибка, а слишком малое
+ * округляется до нуля.
+ *
+ * Быстрый путь: не более 19 значащих цифр, мантисса не больше 2^53 и
+ * порядок в пределах [-22, 22]. В этом случае мантисса и степень десяти
+ * точно представимы в double, и одно умножение или деление дает корректно
+ * округленный результат. Остальные случаи (длинные мантиссы, большие
+ * порядки) разбирает std::from_chars прямо в буфере, тоже без учета локали.
+ */
+bool TextParser::parseDoubleToken(const char* token, const char* tokenEnd, double& value) {
+    if (token == tokenEnd) {
+        return false;
+    }
+    
+    const char* p = token;
+    bool negative = false;
+    if (p < tokenEnd && (*p == '-' || *p == '+')) {
+        negative = *p == '-';
+        ++p;
+    }
+    const char* unsignedStart = p;
+    
+    uint64_t mantissa = 0;
+    int digits = 0;          // Значащие цифры в мантиссе
+    int exponent = 0;        // Десятичный порядок
+    bool anyDigits = false;
+    bool truncated = false;  // Часть ненулевых цифр не вошла в мантиссу
+    
+    for (; p < tokenEnd && isDigit(*p); ++p) {
+        anyDigits = true;
+        if (digits < 19) {
+            mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+            if (mantissa != 0) ++digits;
+        } else {
+            ++exponent;
+            truncated |= *p != '0';
+        }
+    }
+    
+    if (p < tokenEnd && *p == '.') {
+        for (++p; p < tokenEnd && isDigit(*p); ++p) {
+            anyDigits = true;
+            if (digits < 19) {
+                mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+                if (mantissa != 0) ++digits;
+                --exponent;
+            } else {
+                truncated |= *p != '0';
+            }
+        }
+    }
+    
+    if (anyDigits && p < tokenEnd && (*p == 'e' || *p == 'E')) {
+        const char* expStart = p++;
+        bool expNegative = false;
+        if (p < tokenEnd && (*p == '-' || *p == '+')) {
+            expNegative = *p == '-';
+            ++p;
+        }
+        int expValue = 0;
+        const char* expDigits = p;
+        for (; p < tokenEnd && isDigit(*p); ++p) {
+            if (expValue < 100000) {
+                expValue = expValue * 10 + (*p - '0');
+            }
+        }
+        if (p == expDigits) {
+            p = expStart;  // "1e" без цифр - ошибка
+        } else {
+            exponent += expNegative ? -expValue : expValue;
+        }
+    }
+    
+    if (!anyDigits || p != tokenEnd) {
+        return false;
+    }
+    if (mantissa == 0) {
+        value = negative ? -0.0 : 0.0;
+        return true;
+    }
+    if (!truncated && mantissa <= (uint64_t(1) << 53) && exponent >= -22 && exponent <= 22) {
+        double result = static_cast<double>(mantissa);
+        result = exponent < 0 ? result / POW10[-exponent] : result * POW10[exponent];
+        value = negative ? -result : result;
+        return true;
+    }
+    
+    // Медленный путь: запись уже проверена, знак разобран выше
+    double result;
+    const std::from_chars_result parsed = std::from_chars(unsignedStart, tokenEnd, result);
+    if (parsed.ptr != tokenEnd) {
+        return false;
+    }
+    if (parsed.ec == std::errc::result_out_of_range) {
+        // Значение не меньше 10^(digits + exponent - 1): порядок ниже нуля -
+        // исчезновение порядка, иначе переполнение
+        if (digits + exponent > 0) {
+            return false;
+        }
+        result = 0.0;
+    } else if (parsed.ec != std::errc()) {
+        return false;
+    }
+    
+    value = negative ? -result : result;
+    return true;
+}
+
+/**
+ * @brief Описывает текущую позицию для сообщений об ошибках
+ * @return Строка вида "строка N, столбец M: 'лексема'"
+ * @details Номер строки вычисляется подсчетом переводов строк от начала буфера,
+ * поэтому вызывается только при ошибке. Пробелы перед лексемой пропускаются.
+ */
+std::string TextParser::describePosition() const {
+    const char* token = cur;
+    while (token < end && isSpace(*token)) {
+        ++token;
+    }
+    
+    size_t line = 1;
+    const char* lineStart = begin;
+    for (const char* p = begin; p < token; ) {
+        const char* nl = static_cast<const char*>(memchr(p, '\n', static_cast<size_t>(token - p)));
+        if (!nl) break;
+        ++line;
+        lineStart = nl + 1;
+        p = nl + 1;
+    }
+    size_t column = static_cast<size_t>(token - lineStart) + 1;
+    
+    std::string result = "строка " + std::to_string(line) + ", столбец " + std::to_string(column);
+    if (token == end) {
+        return result + ": неожиданный конец файла";
+    }
+    
+    const char* last = token;
+    while (last < end && !isSpace(*last) && last - token < 32) {
+        ++last;
+    }
+    return result + ": '" + std::string(token, last) + "'";
+}
@@ -0,0 +1,119 @@
+#ifndef TEXTPARSER_H
+#define TEXTPARSER_H
+
+#include <string>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Класс для разбора чисел из текстового буфера
+ * @details Разбирает целые неотрицательные числа и числа double, разделенные
+ * пробельными символами, прямо из буфера (например, отображенного в память
+ * файла) без выделения памяти и без учета локали. Числа double округляются
+ * корректно: простые случаи вычисляются точно, остальные передаются
+ * std::from_chars. Допускается только десятичная запись.
+ * Позиция ошибки (строка и столбец) вычисляется только по запросу.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+class TextParser {
+private:
+    const char* begin;  ///< Начало буфера
+    const char* cur;    ///< Текущая позиция разбора
+    const char* end;    ///< Конец буфера
+    
+    /**
+     * @brief Пропускает пробельные символы
+     */
+    void skipSpaces();
+    
+    /**
+     * @brief Находит конец текущей лексемы
+     * @return Указатель на первый пробельный символ после лексемы или конец буфера
+     */
+    const char* tokenEnd() const;
+    
+public:
+    /**
+     * @brief Конструктор класса TextParser
+     * @param [in] data Начало буфера
+     * @param [in] size Размер буфера в байтах
+     */
+    TextParser(const char* data, size_t size);
+    
+    /**
+     * @brief Разбирает целое неотрицательное число
+     * @param [out] value Разобранное значение
+     * @return true если число разобрано, false если лексема не является числом
+     * @details При ошибке позиция остается на начале ошибочной лексемы
+     */
+    bool parseCount(uint64_t& value);
+    
+    /**
+     * @brief Разбирает число с плавающей точкой
+     * @param [out] value Разобранное значение
+     * @return true если число разобрано, false если лексема не является числом
+     * @details При ошибке позиция остается на начале ошибочной лексемы
+     */
+    bool parseDouble(double& value);
+    
+    /**
+     * @brief Пропускает одну лексему без разбора
+     * @return true если лексема пропущена, false если буфер закончился
+     */
+    bool skipToken();
+    
+    /**
+     * @brief Переходит к заданному смещению от начала буфера
+     * @param [in] position Смещение в байтах
+     */
+    void seek(size_t position) { cur = begin + position; }
+    
+    /**
+     * @brief Проверяет, остались ли в буфере лексемы
+     * @return true если до конца буфера только пробельные символы
+     */
+    bool atEnd();
+    
+    /**
+     * @brief Возвращает смещение текущей позиции от начала буфера
+     * @return Смещение в байтах
+     */
+    size_t offset() const { return static_cast<size_t>(cur - begin); }
+    
+    /**
+     * @brief Описывает текущую позицию для сообщений об ошибках
+     * @return Строка вида "строка N, столбец M: 'лексема'"
+     */
+    std::string describePosition() const;
+    
+    /**
+     * @brief Разбирает одну лексему как число double
+     * @param [in] token Начало лексемы
+     * @param [in] tokenEnd Конец лексемы
+     * @param [out] value Разобранное значение
+     * @return true если лексема целиком является десятичным числом в пределах double
+     */
+    static bool parseDoubleToken(const char* token, const char* tokenEnd, double& value);
+    
+    /**
+     * @brief Разбирает одну лексему как целое неотрицательное число
+     * @param [in] token Начало лексемы
+     * @param [in] tokenEnd Конец лексемы
+     * @param [out] value Разобранное значение
+     * @return true если лексема целиком является числом
+     */
+    static bool parseCountToken(const char* token, const char* tokenEnd, uint64_t& value);
+    
+    /**
+     * @brief Проверяет, является ли символ разделителем лексем
+     * @param [in] c Символ
+     * @return true для пробельных символов
+     */
+    static bool isSpace(char c) {
+        return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+    }
+};
+
+#endif // TEXTPARSER_H
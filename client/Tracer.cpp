@@ -0,0 +1,169 @@
+/**
+ * @file Tracer.cpp
+ * @brief Реализация класса Tracer
+ * @details Каждый поток пишет отрезки в собственный буфер, который
+ * регистрируется в общем списке при первой записи.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+
+#include "Tracer.h"
+#include "Metrics.h"
+#include "ErrorHandler.h"
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <cstdio>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+namespace {
+
+/**
+ * @brief Отрезок шкалы
+ */
+struct TraceEvent {
+    const char* name;      ///< Имя
+    const char* category;  ///< Категория
+    uint64_t start;        ///< Начало, нс
+    uint64_t end;          ///< Конец, нс
+    uint64_t firstVector;  ///< Номер первого вектора
+    uint64_t vectorCount;  ///< Количество векторов
+};
+
+/**
+ * @brief Буфер отрезков одного потока
+ */
+struct ThreadTrace {
+    long tid;                        ///< Идентификатор потока в системе
+    const char* name;                ///< Имя потока на шкале
+    std::vector<TraceEvent> events;  ///< Отрезки
+};
+
+/**
+ * @brief Список буферов всех потоков
+ * @details Буферы живут до конца программы: потоки, завершившиеся раньше
+ * записи файла, не теряют своих отрезков.
+ */
+struct TraceRegistry {
+    std::mutex mutex;                                   ///< Защищает threads
+    std::vector<std::unique_ptr<ThreadTrace>> threads;  ///< Буферы потоков
+};
+
+TraceRegistry& registry() {
+    static TraceRegistry instance;
+    return instance;
+}
+
+/**
+ * @brief Возвращает буфер текущего потока, создавая его при первом обращении
+ */
+ThreadTrace& threadTrace() {
+    thread_local ThreadTrace* trace = nullptr;
+    if (trace == nullptr) {
+        std::unique_ptr<ThreadTrace> created(new ThreadTrace());
+        created->tid = static_cast<long>(syscall(SYS_gettid));
+        created->name = nullptr;
+        trace = created.get();
+        std::lock_guard<std::mutex> lock(registry().mutex);
+        registry().threads.push_back(std::move(created));
+    }
+    return *trace;
+}
+
+/**
+ * @brief Переводит наносекунды в микросекунды шкалы
+ */
+double micros(uint64_t ns) {
+    return static_cast<double>(ns) / 1e3;
+}
+
+}  // namespace
+
+/**
+ * @brief Включает запись отрезков
+ */
+void Tracer::enable() {
+    enabled.store(true, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Возвращает текущее время шкалы
+ * @return Наносекунды от запуска программы
+ */
+uint64_t Tracer::now() {
+    return Metrics::now();
+}
+
+/**
+ * @brief Записывает отрезок
+ * @param [in] name Имя
+ * @param [in] category Категория
+ * @param [in] start Начало
+ * @param [in] end Конец
+ * @param [in] firstVector Номер первого вектора или NO_VECTOR
+ * @param [in] vectorCount Количество векторов
+ */
+void Tracer::span(const char* name, const char* category, uint64_t start, uint64_t end, uint64_t firstVector,
+                  uint64_t vectorCount) {
+    if (!isEnabled()) {
+        return;
+    }
+    TraceEvent event = { name, category, start, end, firstVector, vectorCount };
+    threadTrace().events.push_back(event);
+}
+
+/**
+ * @brief Задает имя текущего потока на шкале
+ * @param [in] name Имя
+ */
+void Tracer::nameThread(const char* name) {
+    if (isEnabled()) {
+        threadTrace().name = name;
+    }
+}
+
+/**
+ * @brief Записывает накопленные отрезки в файл
+ * @param [in] filename Имя файла
+ * @return true если файл записан, false в случае ошибки
+ * @details Формат - объект JSON с массивом traceEvents: имена процесса и
+ * потоков (события "M") и отрезки (события "X") с временем в микросекундах.
+ */
+bool Tracer::writeFile(const std::string& filename) {
+    FILE* file = fopen(filename.c_str(), "w");
+    if (file == nullptr) {
+        ErrorHandler::logError("Не удалось открыть файл трассировки: " + filename);
+        return false;
+    }
+
+    const long pid = static_cast<long>(getpid());
+    fprintf(file, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+    fprintf(file, "{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": %ld, \"tid\": %ld, "
+            "\"args\": {\"name\": \"client\"}}", pid, pid);
+
+    std::lock_guard<std::mutex> lock(registry().mutex);
+    for (const auto& thread : registry().threads) {
+        fprintf(file, ",\n{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": %ld, \"tid\": %ld, "
+                "\"args\": {\"name\": \"%s\"}}", pid, thread->tid, thread->name ? thread->name : "thread");
+        for (const TraceEvent& event : thread->events) {
+            fprintf(file, ",\n{\"name\": \"%s\", \"cat\": \"%s\", \"ph\": \"X\", \"pid\": %ld, \"tid\": %ld, "
+                    "\"ts\": %.3f, \"dur\": %.3f", event.name, event.category, pid, thread->tid,
+                    micros(event.start), micros(event.end - event.start));
+            if (event.firstVector != NO_VECTOR) {
+                fprintf(file, ", \"args\": {\"first_vector\": %llu, \"vectors\": %llu}",
+                        static_cast<unsigned long long>(event.firstVector),
+                        static_cast<unsigned long long>(event.vectorCount));
+            }
+            fputc('}', file);
+        }
+    }
+    fprintf(file, "\n]}\n");
+
+    if (fclose(file) != 0) {
+        ErrorHandler::logError("Ошибка записи в файл: " + filename);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,111 @@
+#ifndef TRACER_H
+#define TRACER_H
+
+#include <string>
+#include <atomic>
+#include <cstdint>
+
+/**
+ * @brief Запись временной шкалы работы клиента в формате Chrome trace events
+ * @details Отрезки (события "X") копятся в буферах потоков без общих
+ * блокировок и по окончании работы записываются writeFile() в JSON,
+ * который открывают Perfetto и chrome://tracing. У каждого отрезка есть
+ * имя, категория, номер потока и, если он относится к векторам, номер
+ * первого вектора и их количество.
+ *
+ * Пока запись не включена enable(), TraceSpan и span() сводятся к
+ * проверке одного флага.
+ * @warning Все методы являются статическими, экземпляры класса не создаются.
+ * writeFile() вызывается после завершения всех трассируемых потоков.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+class Tracer {
+private:
+    static inline std::atomic<bool> enabled{false};  ///< Запись включена
+
+public:
+    static const uint64_t NO_VECTOR = UINT64_MAX;  ///< Отрезок не относится к векторам
+
+    /**
+     * @brief Включает запись отрезков
+     */
+    static void enable();
+
+    /**
+     * @brief Проверяет, включена ли запись
+     */
+    static bool isEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Возвращает текущее время шкалы
+     * @return Наносекунды от запуска программы (как Metrics::now())
+     */
+    static uint64_t now();
+
+    /**
+     * @brief Записывает отрезок
+     * @param [in] name Имя (строковая константа)
+     * @param [in] category Категория (строковая константа)
+     * @param [in] start Начало (now())
+     * @param [in] end Конец (now())
+     * @param [in] firstVector Номер первого вектора или NO_VECTOR
+     * @param [in] vectorCount Количество векторов
+     */
+    static void span(const char* name, const char* category, uint64_t start, uint64_t end,
+                     uint64_t firstVector = NO_VECTOR, uint64_t vectorCount = 0);
+
+    /**
+     * @brief Задает имя текущего потока на шкале
+     * @param [in] name Имя (строковая константа)
+     */
+    static void nameThread(const char* name);
+
+    /**
+     * @brief Записывает накопленные отрезки в файл
+     * @param [in] filename Имя файла
+     * @return true если файл записан, false в случае ошибки
+     */
+    static bool writeFile(const std::string& filename);
+};
+
+/**
+ * @brief Отрезок шкалы в пределах области видимости
+ */
+class TraceSpan {
+private:
+    const char* name;      ///< Имя отрезка
+    const char* category;  ///< Категория
+    uint64_t firstVector;  ///< Номер первого вектора
+    uint64_t vectorCount;  ///< Количество векторов
+    bool active;           ///< Запись была включена при создании
+    uint64_t start;        ///< Начало
+
+public:
+    /**
+     * @brief Конструктор класса TraceSpan
+     * @param [in] spanName Имя (строковая константа)
+     * @param [in] spanCategory Категория (строковая константа)
+     * @param [in] first Номер первого вектора или Tracer::NO_VECTOR
+     * @param [in] count Количество векторов
+     */
+    TraceSpan(const char* spanName, const char* spanCategory, uint64_t first = Tracer::NO_VECTOR,
+              uint64_t count = 0)
+        : name(spanName), category(spanCategory), firstVector(first), vectorCount(count),
+          active(Tracer::isEnabled()), start(active ? Tracer::now() : 0) {}
+
+    /**
+     * @brief Деструктор: записывает отрезок
+     */
+    ~TraceSpan() {
+        if (active) {
+            Tracer::span(name, category, start, Tracer::now(), firstVector, vectorCount);
+        }
+    }
+
+    TraceSpan(const TraceSpan&) = delete;
+    TraceSpan& operator=(const TraceSpan&) = delete;
+};
+
+#endif // TRACER_H
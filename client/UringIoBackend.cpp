@@ -0,0 +1,294 @@
+/**
+ * @file UringIoBackend.cpp
+ * @brief Реализация класса UringIoBackend
+ * @details Кольца io_uring отображаются в память процесса; индексы голов
+ * и хвостов читаются и записываются атомарно с семантикой acquire/release,
+ * как требует протокол обмена с ядром.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+
+#include "UringIoBackend.h"
+#include "Metrics.h"
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <cstring>
+#include <errno.h>
+
+/**
+ * @brief Обертка системного вызова io_uring_setup
+ */
+static int uringSetup(unsigned entries, struct io_uring_params* params) {
+    return static_cast<int>(syscall(__NR_io_uring_setup, entries, params));
+}
+
+/**
+ * @brief Обертка системного вызова io_uring_enter
+ */
+static int uringEnter(int fd, unsigned toSubmit, unsigned minComplete, unsigned flags) {
+    return static_cast<int>(syscall(__NR_io_uring_enter, fd, toSubmit, minComplete, flags, nullptr, 0));
+}
+
+/**
+ * @brief Обертка системного вызова io_uring_register
+ */
+static int uringRegister(int fd, unsigned opcode, const void* arg, unsigned count) {
+    return static_cast<int>(syscall(__NR_io_uring_register, fd, opcode, arg, count));
+}
+
+/**
+ * @brief Конструктор класса UringIoBackend
+ */
+UringIoBackend::UringIoBackend()
+    : ringFD(-1), ringMemory(MAP_FAILED), ringMemorySize(0), sqes(nullptr), sqesSize(0),
+      sqHead(nullptr), sqTail(nullptr), sqMask(0), sqEntries(0), sqArray(nullptr),
+      cqHead(nullptr), cqTail(nullptr), cqMask(0), cqes(nullptr),
+      toSubmit(0), inFlight(0), fixedBuffer(nullptr), fixedSize(0) {}
+
+/**
+ * @brief Деструктор класса UringIoBackend
+ */
+UringIoBackend::~UringIoBackend() {
+    release();
+}
+
+/**
+ * @brief Освобождает кольца и закрывает дескриптор
+ */
+void UringIoBackend::release() {
+    if (sqes != nullptr) {
+        munmap(sqes, sqesSize);
+        sqes = nullptr;
+    }
+    if (ringMemory != MAP_FAILED) {
+        munmap(ringMemory, ringMemorySize);
+        ringMemory = MAP_FAILED;
+    }
+    if (ringFD >= 0) {
+        ::close(ringFD);
+        ringFD = -1;
+    }
+}
+
+/**
+ * @brief Создает кольцо io_uring
+ * @param [in] entries Размер очереди отправки
+ * @return true если io_uring доступен и кольцо создано
+ * @details Требуются общее отображение колец (IORING_FEAT_SINGLE_MMAP) и
+ * опрос готовности сокетов внутри ядра (IORING_FEAT_FAST_POLL), то есть
+ * ядро не старше 5.7. Иначе, а также при запрете io_uring в системе
+ * возвращается false.
+ */
+bool UringIoBackend::open(unsigned entries) {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    
+    ringFD = uringSetup(entries, &params);
+    if (ringFD < 0) {
+        return false;
+    }
+    if (!(params.features & IORING_FEAT_SINGLE_MMAP) || !(params.features & IORING_FEAT_FAST_POLL)) {
+        release();
+        return false;
+    }
+    
+    const size_t sqSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    const size_t cqSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    ringMemorySize = sqSize > cqSize ? sqSize : cqSize;
+    ringMemory = mmap(nullptr, ringMemorySize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                      ringFD, IORING_OFF_SQ_RING);
+    if (ringMemory == MAP_FAILED) {
+        release();
+        return false;
+    }
+    
+    sqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    void* sqeMemory = mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                           ringFD, IORING_OFF_SQES);
+    if (sqeMemory == MAP_FAILED) {
+        release();
+        return false;
+    }
+    sqes = static_cast<io_uring_sqe*>(sqeMemory);
+    
+    char* base = static_cast<char*>(ringMemory);
+    sqHead = reinterpret_cast<std::atomic<unsigned>*>(base + params.sq_off.head);
+    sqTail = reinterpret_cast<std::atomic<unsigned>*>(base + params.sq_off.tail);
+    sqMask = *reinterpret_cast<unsigned*>(base + params.sq_off.ring_mask);
+    sqEntries = params.sq_entries;
+    sqArray = reinterpret_cast<unsigned*>(base + params.sq_off.array);
+    cqHead = reinterpret_cast<std::atomic<unsigned>*>(base + params.cq_off.head);
+    cqTail = reinterpret_cast<std::atomic<unsigned>*>(base + params.cq_off.tail);
+    cqMask = *reinterpret_cast<unsigned*>(base + params.cq_off.ring_mask);
+    cqes = reinterpret_cast<io_uring_cqe*>(base + params.cq_off.cqes);
+    
+    return true;
+}
+
+/**
+ * @brief Занимает элемент очереди отправки
+ * @return Элемент или nullptr, если очередь заполнена
+ */
+io_uring_sqe* UringIoBackend::nextSqe() {
+    const unsigned tail = sqTail->load(std::memory_order_relaxed);
+    if (tail - sqHead->load(std::memory_order_acquire) >= sqEntries) {
+        return nullptr;
+    }
+    
+    const unsigned index = tail & sqMask;
+    io_uring_sqe* sqe = &sqes[index];
+    memset(sqe, 0, sizeof(*sqe));
+    sqArray[index] = index;
+    return sqe;
+}
+
+/**
+ * @brief Ставит в очередь отправку sendmsg
+ * @param [in] fd Дескриптор сокета
+ * @param [in] msg Описание отправляемых буферов
+ * @param [in] flags Флаги sendmsg
+ * @param [in] tag Метка операции
+ * @return true если операция поставлена в очередь
+ * @details К флагам добавляется MSG_NOSIGNAL.
+ */
+bool UringIoBackend::queueSendmsg(int fd, const struct msghdr* msg, int flags, uint64_t tag) {
+    io_uring_sqe* sqe = nextSqe();
+    if (sqe == nullptr) {
+        return false;
+    }
+    
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<uint64_t>(msg);
+    sqe->len = 1;
+    sqe->msg_flags = static_cast<uint32_t>(flags | MSG_NOSIGNAL);
+    sqe->user_data = tag;
+    sqTail->store(sqTail->load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    ++toSubmit;
+    ++inFlight;
+    return true;
+}
+
+/**
+ * @brief Ставит в очередь прием recv
+ * @param [in] fd Дескриптор сокета
+ * @param [out] buffer Буфер приема
+ * @param [in] size Размер буфера
+ * @param [in] flags Флаги recv
+ * @param [in] tag Метка операции
+ * @return true если операция поставлена в очередь
+ * @details Если буфер целиком лежит в зарегистрированной области и флаги
+ * не заданы, используется READ_FIXED.
+ */
+bool UringIoBackend::queueRecv(int fd, void* buffer, size_t size, int flags, uint64_t tag) {
+    io_uring_sqe* sqe = nextSqe();
+    if (sqe == nullptr) {
+        return false;
+    }
+    
+    char* start = static_cast<char*>(buffer);
+    if (flags == 0 && fixedBuffer != nullptr && start >= fixedBuffer && start + size <= fixedBuffer + fixedSize) {
+        sqe->opcode = IORING_OP_READ_FIXED;
+        sqe->off = static_cast<uint64_t>(-1);
+        sqe->buf_index = 0;
+    } else {
+        sqe->opcode = IORING_OP_RECV;
+        sqe->msg_flags = static_cast<uint32_t>(flags);
+    }
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<uint64_t>(buffer);
+    sqe->len = static_cast<uint32_t>(size);
+    sqe->user_data = tag;
+    sqTail->store(sqTail->load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    ++toSubmit;
+    ++inFlight;
+    return true;
+}
+
+/**
+ * @brief Отправляет очередь на выполнение и ждет завершения операций
+ * @param [out] completions Массив для завершенных операций
+ * @param [in] max Размер массива
+ * @return Количество завершенных операций (0, если операций в кольце нет),
+ * -1 при ошибке io_uring_enter
+ * @details Если в кольце уже есть завершения и отправлять нечего, системный
+ * вызов не выполняется. Иначе один io_uring_enter и отправляет очередь,
+ * и ждет первого завершения.
+ */
+int UringIoBackend::wait(IoCompletion* completions, size_t max) {
+    for (;;) {
+        unsigned head = cqHead->load(std::memory_order_relaxed);
+        const unsigned tail = cqTail->load(std::memory_order_acquire);
+        if (head == tail && inFlight == 0) {
+            return 0;
+        }
+        
+        if (head != tail && toSubmit == 0) {
+            size_t count = 0;
+            while (head != tail && count < max) {
+                const io_uring_cqe& cqe = cqes[head & cqMask];
+                completions[count].tag = cqe.user_data;
+                completions[count].result = cqe.res;
+                ++count;
+                ++head;
+            }
+            cqHead->store(head, std::memory_order_release);
+            inFlight -= static_cast<unsigned>(count);
+            return static_cast<int>(count);
+        }
+        
+        const unsigned minComplete = head == tail ? 1 : 0;
+        const int submitted = uringEnter(ringFD, toSubmit, minComplete, minComplete ? IORING_ENTER_GETEVENTS : 0);
+        Metrics::add(Metrics::SYSCALLS);
+        if (submitted < 0) {
+            if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+                Metrics::add(Metrics::RETRIES);
+                continue;
+            }
+            return -1;
+        }
+        toSubmit -= static_cast<unsigned>(submitted);
+    }
+}
+
+/**
+ * @brief Регистрирует буфер приема в ядре
+ * @param [in] buffer Начало буфера
+ * @param [in] size Размер буфера
+ * @return true если буфер зарегистрирован
+ * @details Регистрация закрепляет страницы буфера в памяти и может
+ * не пройти из-за ограничения RLIMIT_MEMLOCK; тогда прием идет обычным RECV.
+ */
+bool UringIoBackend::registerBuffer(void* buffer, size_t size) {
+    unregisterBuffer();
+    if (size == 0 || size > UINT32_MAX) {
+        return false;
+    }
+    
+    struct iovec iov;
+    iov.iov_base = buffer;
+    iov.iov_len = size;
+    if (uringRegister(ringFD, IORING_REGISTER_BUFFERS, &iov, 1) < 0) {
+        return false;
+    }
+    
+    fixedBuffer = static_cast<char*>(buffer);
+    fixedSize = size;
+    return true;
+}
+
+/**
+ * @brief Снимает регистрацию буфера приема
+ */
+void UringIoBackend::unregisterBuffer() {
+    if (fixedBuffer != nullptr) {
+        uringRegister(ringFD, IORING_UNREGISTER_BUFFERS, nullptr, 0);
+        fixedBuffer = nullptr;
+        fixedSize = 0;
+    }
+}
@@ -0,0 +1,89 @@
+#ifndef URINGIOBACKEND_H
+#define URINGIOBACKEND_H
+
+#include "IoBackend.h"
+#include <atomic>
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+
+/**
+ * @brief Механизм ввода-вывода на основе io_uring
+ * @details Работает с кольцами io_uring напрямую через системные вызовы
+ * io_uring_setup/io_uring_enter/io_uring_register, без внешних библиотек.
+ * Все поставленные в очередь операции отправляются одним вызовом
+ * io_uring_enter, который одновременно ждет завершений. Готовые завершения
+ * забираются из кольца без системного вызова. Прием в зарегистрированный
+ * буфер выполняется операцией READ_FIXED.
+ * @warning Объект используется одним потоком.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+class UringIoBackend : public IoBackend {
+private:
+    int ringFD;                    ///< Дескриптор io_uring
+    void* ringMemory;              ///< Отображение колец SQ и CQ
+    size_t ringMemorySize;         ///< Размер отображения колец
+    io_uring_sqe* sqes;            ///< Массив элементов очереди отправки
+    size_t sqesSize;               ///< Размер отображения массива элементов
+    
+    std::atomic<unsigned>* sqHead; ///< Голова очереди отправки (двигает ядро)
+    std::atomic<unsigned>* sqTail; ///< Хвост очереди отправки (двигает процесс)
+    unsigned sqMask;               ///< Маска индексов очереди отправки
+    unsigned sqEntries;            ///< Размер очереди отправки
+    unsigned* sqArray;             ///< Индексы элементов очереди отправки
+    
+    std::atomic<unsigned>* cqHead; ///< Голова очереди завершений (двигает процесс)
+    std::atomic<unsigned>* cqTail; ///< Хвост очереди завершений (двигает ядро)
+    unsigned cqMask;               ///< Маска индексов очереди завершений
+    io_uring_cqe* cqes;            ///< Элементы очереди завершений
+    
+    unsigned toSubmit;             ///< Операции, поставленные после последнего io_uring_enter
+    unsigned inFlight;             ///< Операции, завершения которых еще не забраны
+    char* fixedBuffer;             ///< Зарегистрированный буфер приема
+    size_t fixedSize;              ///< Размер зарегистрированного буфера
+    
+    /**
+     * @brief Занимает элемент очереди отправки
+     * @return Элемент или nullptr, если очередь заполнена
+     */
+    io_uring_sqe* nextSqe();
+    
+    /**
+     * @brief Освобождает кольца и закрывает дескриптор
+     */
+    void release();
+    
+public:
+    /**
+     * @brief Конструктор класса UringIoBackend
+     * @details Кольцо создается методом open().
+     */
+    UringIoBackend();
+    
+    /**
+     * @brief Деструктор класса UringIoBackend
+     */
+    ~UringIoBackend();
+    
+    UringIoBackend(const UringIoBackend&) = delete;
+    UringIoBackend& operator=(const UringIoBackend&) = delete;
+    
+    /**
+     * @brief Создает кольцо io_uring
+     * @param [in] entries Размер очереди отправки
+     * @return true если io_uring доступен и кольцо создано
+     */
+    bool open(unsigned entries);
+    
+    const char* name() const override { return "io_uring"; }
+    bool isAsync() const override { return true; }
+    bool queueSendmsg(int fd, const struct msghdr* msg, int flags, uint64_t tag) override;
+    bool queueRecv(int fd, void* buffer, size_t size, int flags, uint64_t tag) override;
+    int wait(IoCompletion* completions, size_t max) override;
+    bool registerBuffer(void* buffer, size_t size) override;
+    void unregisterBuffer() override;
+};
+
+#endif // URINGIOBACKEND_H
@@ -0,0 +1,153 @@
+/**
+ * @file VbinFormat.cpp
+ * @brief Реализация класса VbinFormat
+ * @details Содержит чтение файлов .vbin отображением в память и их запись.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+
+#include "VbinFormat.h"
+#include "VectorStore.h"
+#include "MappedFile.h"
+#include "ErrorHandler.h"
+#include <fstream>
+#include <cstring>
+#include <memory>
+
+/**
+ * @brief Сигнатура файла .vbin
+ */
+static const char VBIN_MAGIC[4] = { 'V', 'B', 'I', 'N' };
+
+/**
+ * @brief Текущая версия формата .vbin
+ */
+static const uint32_t VBIN_VERSION = 1;
+
+/**
+ * @brief Проверяет, является ли файл файлом .vbin
+ * @param [in] filename Имя файла
+ * @return true если файл начинается с сигнатуры "VBIN"
+ */
+bool VbinFormat::isVbinFile(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    char magic[sizeof(VBIN_MAGIC)];
+    if (!file.read(magic, sizeof(magic))) {
+        return false;
+    }
+    return memcmp(magic, VBIN_MAGIC, sizeof(magic)) == 0;
+}
+
+/**
+ * @brief Загружает векторы из файла .vbin отображением в память
+ * @param [in] filename Имя файла
+ * @param [out] vectors Хранилище, которое будет ссылаться на отображение
+ * @return true если файл корректен, false в случае ошибки
+ * @details Проверяет заголовок и границы областей, затем передает полезную
+ * нагрузку и индекс (если есть) в VectorStore::attachMapped(). Значения
+ * векторов не копируются и не разбираются.
+ */
+bool VbinFormat::load(const std::string& filename, VectorStore& vectors) {
+    std::shared_ptr<MappedFile> file(new MappedFile());
+    if (!file->open(filename)) {
+        return false;
+    }
+    
+    VbinHeader header;
+    if (file->size() < sizeof(header)) {
+        ErrorHandler::logError("Файл .vbin слишком мал: " + filename);
+        return false;
+    }
+    memcpy(&header, file->data(), sizeof(header));
+    
+    if (memcmp(header.magic, VBIN_MAGIC, sizeof(VBIN_MAGIC)) != 0 || header.version != VBIN_VERSION) {
+        ErrorHandler::logError("Неподдерживаемый формат или версия .vbin: " + filename);
+        return false;
+    }
+    
+    const uint64_t fileSize = file->size();
+    if (header.payloadOffset % sizeof(uint64_t) != 0 || header.payloadOffset > fileSize ||
+        header.payloadSize > fileSize - header.payloadOffset || header.vectorCount > UINT32_MAX) {
+        ErrorHandler::logError("Некорректный заголовок .vbin: " + filename);
+        return false;
+    }
+    
+    const uint64_t* index = nullptr;
+    if (header.flags & VBIN_FLAG_INDEX) {
+        if (header.indexOffset % sizeof(uint64_t) != 0 || header.indexOffset > fileSize ||
+            (fileSize - header.indexOffset) / sizeof(uint64_t) < header.vectorCount) {
+            ErrorHandler::logError("Некорректный индекс .vbin: " + filename);
+            return false;
+        }
+        index = reinterpret_cast<const uint64_t*>(file->data() + header.indexOffset);
+    }
+    
+    if (!vectors.attachMapped(file, static_cast<size_t>(header.payloadOffset),
+                              static_cast<size_t>(header.payloadSize), header.vectorCount, header.valueCount,
+                              index)) {
+        ErrorHandler::logError("Поврежденный файл .vbin: " + filename);
+        return false;
+    }
+    
+    return true;
+}
+
+/**
+ * @brief Записывает векторы в файл .vbin
+ * @param [in] vectors Векторы для записи
+ * @param [in] filename Имя файла
+ * @param [in] withIndex Записывать ли индекс смещений векторов
+ * @return true если запись успешна, false в случае ошибки
+ * @details Полезная нагрузка записывается в формате протокола сразу после
+ * заголовка, индекс - после нагрузки с выравниванием на 8 байт.
+ */
+bool VbinFormat::write(const VectorStore& vectors, const std::string& filename, bool withIndex) {
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        ErrorHandler::logError("Не удалось открыть файл для записи: " + filename);
+        return false;
+    }
+    
+    const size_t count = vectors.size();
+    const uint64_t payloadSize = vectors.wireOffset(count);
+    
+    VbinHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, VBIN_MAGIC, sizeof(VBIN_MAGIC));
+    header.version = VBIN_VERSION;
+    header.flags = withIndex ? VBIN_FLAG_INDEX : 0;
+    header.vectorCount = count;
+    header.valueCount = vectors.valueCount();
+    header.payloadOffset = sizeof(header);
+    header.payloadSize = payloadSize;
+    header.indexOffset = withIndex ? (sizeof(header) + payloadSize + 7) / 8 * 8 : 0;
+    
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    
+    // Полезная нагрузка в формате протокола
+    uint32_t numVectors = static_cast<uint32_t>(count);
+    file.write(reinterpret_cast<const char*>(&numVectors), sizeof(numVectors));
+    for (size_t i = 0; i < count; ++i) {
+        VectorView vec = vectors[i];
+        file.write(reinterpret_cast<const char*>(vec.sizeField()), sizeof(uint32_t));
+        file.write(reinterpret_cast<const char*>(vec.data()), vec.byteSize());
+    }
+    
+    if (withIndex) {
+        static const char padding[8] = { 0 };
+        file.write(padding, header.indexOffset - sizeof(header) - payloadSize);
+        for (size_t i = 0; i < count; ++i) {
+            uint64_t offset = vectors.wireOffset(i);
+            file.write(reinterpret_cast<const char*>(&offset), sizeof(offset));
+        }
+    }
+    
+    file.close();
+    if (!file) {
+        ErrorHandler::logError("Ошибка записи в файл: " + filename);
+        return false;
+    }
+    
+    return true;
+}
@@ -0,0 +1,80 @@
+#ifndef VBINFORMAT_H
+#define VBINFORMAT_H
+
+#include <string>
+#include <cstdint>
+
+class VectorStore;
+
+/**
+ * @brief Заголовок файла векторов в двоичном формате .vbin
+ * @details Все поля хранятся в порядке байтов little-endian. Размер заголовка
+ * 64 байта, поэтому полезная нагрузка начинается с границы 8 байт.
+ * 
+ * Структура файла:
+ * 1. Заголовок VbinHeader (64 байта)
+ * 2. Полезная нагрузка - байт в байт формат протокола сервера:
+ *    uint32_t количество векторов, затем для каждого вектора
+ *    uint32_t размер и double[размер] значения
+ * 3. Необязательный индекс (флаг VBIN_FLAG_INDEX), выровненный на 8 байт:
+ *    uint64_t[количество векторов] - смещение поля размера каждого вектора
+ *    от начала полезной нагрузки
+ */
+struct VbinHeader {
+    char magic[4];          ///< Сигнатура "VBIN"
+    uint32_t version;       ///< Версия формата (1)
+    uint32_t flags;         ///< Флаги VBIN_FLAG_*
+    uint32_t reserved;      ///< Зарезервировано (0)
+    uint64_t vectorCount;   ///< Количество векторов
+    uint64_t valueCount;    ///< Общее количество значений
+    uint64_t payloadOffset; ///< Смещение полезной нагрузки от начала файла
+    uint64_t payloadSize;   ///< Размер полезной нагрузки в байтах
+    uint64_t indexOffset;   ///< Смещение индекса от начала файла (0 - индекса нет)
+    uint64_t reserved2;     ///< Зарезервировано (0)
+};
+
+static_assert(sizeof(VbinHeader) == 64, "Размер заголовка .vbin должен быть 64 байта");
+
+/**
+ * @brief Флаг наличия индекса смещений векторов
+ */
+const uint32_t VBIN_FLAG_INDEX = 1;
+
+/**
+ * @brief Класс для чтения и записи файлов векторов в формате .vbin
+ * @details Полезная нагрузка файла совпадает с данными, которые клиент
+ * отправляет серверу, поэтому файл загружается отображением в память без
+ * разбора и может передаваться в сокет без преобразования.
+ * @warning Все методы являются статическими, экземпляры класса не создаются.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+class VbinFormat {
+public:
+    /**
+     * @brief Проверяет, является ли файл файлом .vbin
+     * @param [in] filename Имя файла
+     * @return true если файл начинается с сигнатуры "VBIN"
+     */
+    static bool isVbinFile(const std::string& filename);
+    
+    /**
+     * @brief Загружает векторы из файла .vbin отображением в память
+     * @param [in] filename Имя файла
+     * @param [out] vectors Хранилище, которое будет ссылаться на отображение
+     * @return true если файл корректен, false в случае ошибки
+     */
+    static bool load(const std::string& filename, VectorStore& vectors);
+    
+    /**
+     * @brief Записывает векторы в файл .vbin
+     * @param [in] vectors Векторы для записи
+     * @param [in] filename Имя файла
+     * @param [in] withIndex Записывать ли индекс смещений векторов
+     * @return true если запись успешна, false в случае ошибки
+     */
+    static bool write(const VectorStore& vectors, const std::string& filename, bool withIndex);
+};
+
+#endif // VBINFORMAT_H
@@ -0,0 +1,221 @@
+/**
+ * @file VectorStore.cpp
+ * @brief Реализация класса VectorStore
+ * @details Содержит реализацию непрерывного хранилища векторов в формате CSR.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+
+#include "VectorStore.h"
+#include "MappedFile.h"
+#include "ErrorHandler.h"
+#include <utility>
+
+/**
+ * @brief Конструктор класса VectorStore
+ * @details Массив смещений всегда содержит начальный нулевой элемент
+ */
+VectorStore::VectorStore()
+    : offsets(1, 0), payload(nullptr), payloadSize(0), mappedCount(0), mappedValues(0), byteOffsets(nullptr) {}
+
+/**
+ * @brief Конструктор перемещения
+ * @param [in,out] other Хранилище, которое становится пустым
+ */
+VectorStore::VectorStore(VectorStore&& other) noexcept : VectorStore() {
+    *this = std::move(other);
+}
+
+/**
+ * @brief Оператор перемещения
+ * @param [in,out] other Хранилище, которое становится пустым
+ * @return Ссылка на это хранилище
+ * @details Смещения векторов, лежавшие в буфере other, переходят вместе
+ * с буфером, и указатель на них направляется в буфер этого хранилища.
+ */
+VectorStore& VectorStore::operator=(VectorStore&& other) noexcept {
+    if (this == &other) {
+        return *this;
+    }
+    const bool ownIndex = other.byteOffsets != nullptr && other.byteOffsets == other.ownedByteOffsets.data();
+    values = std::move(other.values);
+    offsets = std::move(other.offsets);
+    sizes = std::move(other.sizes);
+    mapping = std::move(other.mapping);
+    payload = other.payload;
+    payloadSize = other.payloadSize;
+    mappedCount = other.mappedCount;
+    mappedValues = other.mappedValues;
+    ownedByteOffsets = std::move(other.ownedByteOffsets);
+    byteOffsets = ownIndex ? ownedByteOffsets.data() : other.byteOffsets;
+    other.clear();
+    return *this;
+}
+
+/**
+ * @brief Удаляет все векторы
+ * @details Освобождает память всех буферов
+ */
+void VectorStore::clear() {
+    std::vector<double>().swap(values);
+    std::vector<size_t>(1, 0).swap(offsets);
+    std::vector<uint32_t>().swap(sizes);
+    
+    mapping.reset();
+    payload = nullptr;
+    payloadSize = 0;
+    mappedCount = 0;
+    mappedValues = 0;
+    byteOffsets = nullptr;
+    std::vector<uint64_t>().swap(ownedByteOffsets);
+}
+
+/**
+ * @brief Подключает полезную нагрузку файла .vbin, отображенного в память
+ * @param [in] file Отображенный файл (хранилище продлевает его жизнь)
+ * @param [in] offset Смещение полезной нагрузки в файле
+ * @param [in] size Размер полезной нагрузки в байтах
+ * @param [in] vectorCount Количество векторов по заголовку файла
+ * @param [in] valueCount Общее количество значений
+ * @param [in] index Индекс смещений векторов в файле (nullptr - вычислить)
+ * @return true если нагрузка согласована с заголовком, индексом и размерами, false иначе
+ * @details Данные не копируются и не разбираются. До прохода по векторам
+ * проверяется, что нагрузка и индекс на vectorCount элементов лежат внутри
+ * отображения, а количество векторов в нагрузке равно vectorCount. Затем
+ * один проход по полям размеров проверяет, что каждый вектор лежит внутри
+ * нагрузки, совпадает с индексом (если он есть) и что сумма размеров равна
+ * valueCount. Без индекса смещения векторов вычисляются этим же проходом.
+ */
+bool VectorStore::attachMapped(const std::shared_ptr<const MappedFile>& file, size_t offset, size_t size,
+                               uint64_t vectorCount, uint64_t valueCount, const uint64_t* index) {
+    clear();
+    
+    const size_t fileSize = file->size();
+    uint32_t count;
+    if (offset > fileSize || size > fileSize - offset || size < sizeof(count)) {
+        ErrorHandler::logError("Полезная нагрузка .vbin выходит за пределы файла или слишком мала");
+        return false;
+    }
+    const char* data = file->data() + offset;
+    memcpy(&count, data, sizeof(count));
+    if (count != vectorCount) {
+        ErrorHandler::logError("Количество векторов в полезной нагрузке .vbin (" + std::to_string(count) +
+                               ") не совпадает с заголовком (" + std::to_string(vectorCount) + ")");
+        return false;
+    }
+    
+    if (index) {
+        const char* indexStart = reinterpret_cast<const char*>(index);
+        if (indexStart < file->data() || indexStart > file->data() + fileSize ||
+            static_cast<size_t>(file->data() + fileSize - indexStart) / sizeof(uint64_t) < count) {
+            ErrorHandler::logError("Индекс .vbin выходит за пределы файла");
+            return false;
+        }
+    } else {
+        ownedByteOffsets.resize(count);
+    }
+    
+    size_t position = sizeof(count);
+    uint64_t values = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (index && index[i] != position) {
+            ErrorHandler::logError("Индекс .vbin не совпадает с данными у вектора " + std::to_string(i + 1));
+            return false;
+        }
+        if (!index) {
+            ownedByteOffsets[i] = position;
+        }
+        
+        uint32_t vectorSize;
+        if (size - position < sizeof(vectorSize)) {
+            ErrorHandler::logError("Полезная нагрузка .vbin обрывается на векторе " + std::to_string(i + 1));
+            return false;
+        }
+        memcpy(&vectorSize, data + position, sizeof(vectorSize));
+        position += sizeof(vectorSize);
+        
+        if ((size - position) / sizeof(double) < vectorSize) {
+            ErrorHandler::logError("Полезная нагрузка .vbin обрывается на векторе " + std::to_string(i + 1));
+            return false;
+        }
+        position += static_cast<size_t>(vectorSize) * sizeof(double);
+        values += vectorSize;
+    }
+    
+    if (position != size || values != valueCount) {
+        ErrorHandler::logError("Размер полезной нагрузки .vbin не совпадает с заголовком");
+        return false;
+    }
+    
+    mapping = file;
+    payload = data;
+    payloadSize = size;
+    mappedCount = count;
+    mappedValues = static_cast<size_t>(valueCount);
+    byteOffsets = index ? index : ownedByteOffsets.data();
+    return true;
+}
+
+/**
+ * @brief Возвращает смещение полезной нагрузки от начала отображенного файла
+ * @return Смещение в байтах (0, если хранилище не отображено)
+ */
+size_t VectorStore::mappedPayloadOffset() const {
+    return payload ? static_cast<size_t>(payload - mapping->data()) : 0;
+}
+
+/**
+ * @brief Резервирует память под векторы и значения
+ * @param [in] vectorCount Ожидаемое количество векторов
+ * @param [in] valueCount Ожидаемое общее количество значений
+ */
+void VectorStore::reserve(size_t vectorCount, size_t valueCount) {
+    sizes.reserve(vectorCount);
+    offsets.reserve(vectorCount + 1);
+    values.reserve(valueCount);
+}
+
+/**
+ * @brief Добавляет вектор заданного размера
+ * @param [in] size Размер вектора
+ * @return Указатель на значения нового вектора для заполнения
+ * @details Значения нового вектора инициализируются нулями
+ * @warning Указатель действителен до следующего добавления
+ */
+double* VectorStore::append(uint32_t size) {
+    size_t start = offsets.back();
+    values.resize(start + size);
+    offsets.push_back(start + size);
+    sizes.push_back(size);
+    return values.data() + start;
+}
+
+/**
+ * @brief Добавляет вектор без выделения памяти под значения
+ * @param [in] size Размер вектора
+ */
+void VectorStore::appendShape(uint32_t size) {
+    offsets.push_back(offsets.back() + size);
+    sizes.push_back(size);
+}
+
+/**
+ * @brief Выделяет память под значения всех добавленных векторов
+ * @details Выделяет ровно столько памяти, сколько требуют добавленные размеры
+ */
+void VectorStore::allocateValues() {
+    values.resize(offsets.back());
+    values.shrink_to_fit();
+}
+
+/**
+ * @brief Оценивает объем памяти, занятой набором
+ * @return Размер выделенных буферов в байтах
+ */
+size_t VectorStore::memoryUsage() const {
+    return values.capacity() * sizeof(double) +
+           offsets.capacity() * sizeof(size_t) +
+           sizes.capacity() * sizeof(uint32_t) +
+           ownedByteOffsets.capacity() * sizeof(uint64_t);
+}
@@ -0,0 +1,289 @@
+#ifndef VECTORSTORE_H
+#define VECTORSTORE_H
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+class MappedFile;
+
+/**
+ * @brief Легковесное представление одного вектора из VectorStore
+ * @details Не владеет данными: хранит указатели на поле размера в формате
+ * протокола (uint32_t) и на значения вектора. Действительно, пока жив
+ * и не изменяется породивший его VectorStore.
+ * @warning Для хранилища, отображенного из файла .vbin, значения могут быть
+ * не выровнены на 8 байт: читайте их через operator[], а не через data().
+ */
+class VectorView {
+private:
+    const uint32_t* sizePtr;  ///< Поле размера вектора в формате протокола
+    const double* values;     ///< Начало значений вектора
+    
+public:
+    /**
+     * @brief Конструктор класса VectorView
+     * @param [in] sizeField Указатель на поле размера
+     * @param [in] data Указатель на значения
+     */
+    VectorView(const uint32_t* sizeField, const double* data) : sizePtr(sizeField), values(data) {}
+    
+    /**
+     * @brief Возвращает размер вектора
+     * @return Количество элементов
+     */
+    uint32_t size() const { return *sizePtr; }
+    
+    /**
+     * @brief Возвращает указатель на поле размера в формате протокола
+     * @return Указатель на uint32_t, который можно отправлять без копирования
+     */
+    const uint32_t* sizeField() const { return sizePtr; }
+    
+    /**
+     * @brief Возвращает указатель на значения вектора
+     * @return Указатель на первый элемент
+     */
+    const double* data() const { return values; }
+    
+    /**
+     * @brief Возвращает размер значений вектора в байтах
+     * @return size() * sizeof(double)
+     */
+    size_t byteSize() const { return static_cast<size_t>(*sizePtr) * sizeof(double); }
+    
+    /**
+     * @brief Возвращает элемент вектора
+     * @param [in] index Индекс элемента
+     * @return Значение элемента
+     */
+    double operator[](size_t index) const {
+        double value;
+        memcpy(&value, values + index, sizeof(value));
+        return value;
+    }
+};
+
+/**
+ * @brief Класс для компактного хранения набора векторов
+ * @details Хранит все значения в одном непрерывном буфере, а границы векторов -
+ * в массиве смещений (формат CSR). Размеры векторов дополнительно хранятся
+ * в виде uint32_t, чтобы отправлять их на сервер без преобразования.
+ * Вместо отдельного выделения памяти на каждый вектор используется
+ * три массива на весь набор.
+ * 
+ * Хранилище также может ссылаться на полезную нагрузку файла .vbin,
+ * отображенного в память (attachMapped()). В этом режиме данные лежат
+ * в формате протокола, а границы векторов задаются байтовыми смещениями.
+ * @warning Объекты класса не копируются, только перемещаются: смещения
+ * векторов могут указывать в собственный буфер хранилища.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+class VectorStore {
+private:
+    std::vector<double> values;    ///< Значения всех векторов подряд
+    std::vector<size_t> offsets;   ///< Начало каждого вектора в values (size() + 1 элементов)
+    std::vector<uint32_t> sizes;   ///< Размеры векторов в формате протокола
+    
+    std::shared_ptr<const MappedFile> mapping;  ///< Отображенный файл (режим .vbin)
+    const char* payload;                        ///< Полезная нагрузка в формате протокола
+    size_t payloadSize;                         ///< Размер полезной нагрузки в байтах
+    size_t mappedCount;                         ///< Количество векторов в отображении
+    size_t mappedValues;                        ///< Количество значений в отображении
+    const uint64_t* byteOffsets;                ///< Смещения полей размеров в payload
+    std::vector<uint64_t> ownedByteOffsets;     ///< Смещения, если в файле нет индекса
+    
+    /**
+     * @brief Возвращает смещение поля размера вектора в полезной нагрузке
+     * @param [in] index Индекс вектора (index == size() - конец нагрузки)
+     * @return Смещение в байтах
+     */
+    size_t mappedOffset(size_t index) const {
+        return index < mappedCount ? static_cast<size_t>(byteOffsets[index]) : payloadSize;
+    }
+    
+public:
+    /**
+     * @brief Конструктор класса VectorStore
+     * @details Создает пустой набор
+     */
+    VectorStore();
+    
+    VectorStore(const VectorStore&) = delete;
+    VectorStore& operator=(const VectorStore&) = delete;
+    
+    /**
+     * @brief Конструктор перемещения
+     * @param [in,out] other Хранилище, которое становится пустым
+     */
+    VectorStore(VectorStore&& other) noexcept;
+    
+    /**
+     * @brief Оператор перемещения
+     * @param [in,out] other Хранилище, которое становится пустым
+     * @return Ссылка на это хранилище
+     */
+    VectorStore& operator=(VectorStore&& other) noexcept;
+    
+    /**
+     * @brief Удаляет все векторы
+     * @details Освобождает память и отображение файла
+     */
+    void clear();
+    
+    /**
+     * @brief Подключает полезную нагрузку файла .vbin, отображенного в память
+     * @param [in] file Отображенный файл (хранилище продлевает его жизнь)
+     * @param [in] offset Смещение полезной нагрузки в файле
+     * @param [in] size Размер полезной нагрузки в байтах
+     * @param [in] vectorCount Количество векторов по заголовку файла
+     * @param [in] valueCount Общее количество значений
+     * @param [in] index Индекс смещений векторов в файле (nullptr - вычислить)
+     * @return true если нагрузка согласована с заголовком, индексом и размерами, false иначе
+     */
+    bool attachMapped(const std::shared_ptr<const MappedFile>& file, size_t offset, size_t size,
+                      uint64_t vectorCount, uint64_t valueCount, const uint64_t* index);
+    
+    /**
+     * @brief Проверяет, ссылается ли хранилище на отображенный файл
+     * @return true в режиме .vbin
+     */
+    bool isMapped() const { return payload != nullptr; }
+    
+    /**
+     * @brief Возвращает полезную нагрузку отображенного файла
+     * @return Указатель на данные в формате протокола или nullptr
+     */
+    const char* mappedPayload() const { return payload; }
+    
+    /**
+     * @brief Возвращает отображенный файл
+     * @return Отображенный файл или пустой указатель
+     */
+    const std::shared_ptr<const MappedFile>& mappedFile() const { return mapping; }
+    
+    /**
+     * @brief Возвращает смещение полезной нагрузки от начала отображенного файла
+     * @return Смещение в байтах
+     */
+    size_t mappedPayloadOffset() const;
+    
+    /**
+     * @brief Резервирует память под векторы и значения
+     * @param [in] vectorCount Ожидаемое количество векторов
+     * @param [in] valueCount Ожидаемое общее количество значений
+     */
+    void reserve(size_t vectorCount, size_t valueCount);
+    
+    /**
+     * @brief Добавляет вектор заданного размера
+     * @param [in] size Размер вектора
+     * @return Указатель на значения нового вектора для заполнения
+     * @warning Указатель действителен до следующего добавления
+     * @warning Не применяется к отображенному хранилищу
+     */
+    double* append(uint32_t size);
+    
+    /**
+     * @brief Добавляет вектор без выделения памяти под значения
+     * @param [in] size Размер вектора
+     * @details Используется при параллельной загрузке: сначала добавляются
+     * размеры всех векторов, затем allocateValues() выделяет память, и
+     * значения заполняются через mutableData() из нескольких потоков.
+     */
+    void appendShape(uint32_t size);
+    
+    /**
+     * @brief Выделяет память под значения всех добавленных векторов
+     */
+    void allocateValues();
+    
+    /**
+     * @brief Возвращает изменяемый указатель на значения вектора
+     * @param [in] index Индекс вектора
+     * @return Указатель на первый элемент
+     * @warning Память должна быть выделена allocateValues() или append()
+     */
+    double* mutableData(size_t index) { return values.data() + offsets[index]; }
+    
+    /**
+     * @brief Возвращает количество векторов
+     * @return Количество векторов в наборе
+     */
+    size_t size() const { return payload ? mappedCount : sizes.size(); }
+    
+    /**
+     * @brief Проверяет, пуст ли набор
+     * @return true если векторов нет
+     */
+    bool empty() const { return size() == 0; }
+    
+    /**
+     * @brief Возвращает общее количество значений во всех векторах
+     * @return Количество значений
+     */
+    size_t valueCount() const { return payload ? mappedValues : offsets.back(); }
+    
+    /**
+     * @brief Возвращает представление вектора
+     * @param [in] index Индекс вектора
+     * @return Представление вектора без копирования данных
+     */
+    VectorView operator[](size_t index) const {
+        if (payload) {
+            const char* field = payload + byteOffsets[index];
+            return VectorView(reinterpret_cast<const uint32_t*>(field),
+                              reinterpret_cast<const double*>(field + sizeof(uint32_t)));
+        }
+        return VectorView(&sizes[index], values.data() + offsets[index]);
+    }
+    
+    /**
+     * @brief Возвращает размер вектора
+     * @param [in] index Индекс вектора
+     * @return Количество элементов вектора
+     */
+    uint32_t dimension(size_t index) const {
+        if (payload) {
+            uint32_t size;
+            memcpy(&size, payload + byteOffsets[index], sizeof(size));
+            return size;
+        }
+        return sizes[index];
+    }
+    
+    /**
+     * @brief Вычисляет размер группы векторов в формате протокола
+     * @param [in] begin Индекс первого вектора
+     * @param [in] end Индекс, следующий за последним вектором
+     * @return Размер в байтах: поля размеров и значения, без заголовка
+     */
+    size_t wireBytes(size_t begin, size_t end) const {
+        if (payload) {
+            return mappedOffset(end) - mappedOffset(begin);
+        }
+        return (end - begin) * sizeof(uint32_t) + (offsets[end] - offsets[begin]) * sizeof(double);
+    }
+    
+    /**
+     * @brief Вычисляет смещение вектора в формате протокола
+     * @param [in] index Индекс вектора (index == size() - конец данных)
+     * @return Смещение поля размера от начала данных, включая заголовок
+     * с количеством векторов
+     */
+    size_t wireOffset(size_t index) const {
+        return sizeof(uint32_t) + wireBytes(0, index);
+    }
+    
+    /**
+     * @brief Оценивает объем памяти, занятой набором
+     * @return Размер выделенных буферов в байтах (без отображенного файла)
+     */
+    size_t memoryUsage() const;
+};
+
+#endif // VECTORSTORE_H
@@ -0,0 +1,69 @@
+/**
+ * @file WireCursor.cpp
+ * @brief Реализация класса WireCursor
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+
+#include "WireCursor.h"
+#include "VectorStore.h"
+#include <cstdint>
+
+/**
+ * @brief Конструктор класса WireCursor
+ * @param [in] store Векторы
+ * @param [in] first Индекс первого отправляемого вектора
+ */
+WireCursor::WireCursor(const VectorStore& store, size_t first) : vectors(&store), index(first), partialBytes(0) {}
+
+/**
+ * @brief Заполняет описатели для отправки с текущей позиции
+ * @param [out] iov Массив описателей
+ * @param [in] maxIov Размер массива
+ * @param [in] limit Индекс, следующий за последним вектором, который можно отправить
+ * @return Количество заполненных описателей (0, если отправлять нечего)
+ * @details Каждый вектор дает описатель поля размера и описатель данных
+ * (пустые части пропускаются). Уже отправленные байты вектора index
+ * пропускаются.
+ */
+size_t WireCursor::fill(struct iovec* iov, size_t maxIov, size_t limit) const {
+    size_t count = 0;
+    size_t skip = partialBytes;
+    
+    for (size_t i = index; i < limit && count + 2 <= maxIov; ++i) {
+        VectorView vec = (*vectors)[i];
+        const char* parts[2] = {reinterpret_cast<const char*>(vec.sizeField()),
+                                reinterpret_cast<const char*>(vec.data())};
+        const size_t lengths[2] = {sizeof(uint32_t), vec.byteSize()};
+        for (int p = 0; p < 2; ++p) {
+            if (skip >= lengths[p]) {
+                skip -= lengths[p];
+                continue;
+            }
+            iov[count].iov_base = const_cast<char*>(parts[p] + skip);
+            iov[count].iov_len = lengths[p] - skip;
+            skip = 0;
+            ++count;
+        }
+    }
+    
+    return count;
+}
+
+/**
+ * @brief Сдвигает позицию на отправленные байты
+ * @param [in] bytes Количество байтов, принятых сокетом
+ */
+void WireCursor::advance(size_t bytes) {
+    while (bytes > 0) {
+        const size_t vectorLeft = sizeof(uint32_t) + (*vectors)[index].byteSize() - partialBytes;
+        if (bytes < vectorLeft) {
+            partialBytes += bytes;
+            return;
+        }
+        bytes -= vectorLeft;
+        partialBytes = 0;
+        ++index;
+    }
+}
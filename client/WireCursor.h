@@ -0,0 +1,55 @@
+#ifndef WIRECURSOR_H
+#define WIRECURSOR_H
+
+#include <cstddef>
+#include <sys/uio.h>
+
+class VectorStore;
+
+/**
+ * @brief Позиция неблокирующей отправки векторов в формате протокола
+ * @details Хранит номер первого не полностью отправленного вектора и число
+ * уже отправленных байтов этого вектора. Строит описатели iovec для
+ * продолжения отправки с этой позиции и сдвигается на число байтов,
+ * принятых сокетом, поэтому частичная запись не требует копирования.
+ * @author Ежов Егор Александрович
+ * @date 01.12.2025
+ * @version 1.0
+ */
+class WireCursor {
+private:
+    const VectorStore* vectors;  ///< Векторы задания
+    size_t index;                ///< Первый не полностью отправленный вектор
+    size_t partialBytes;         ///< Отправленные байты вектора index
+    
+public:
+    /**
+     * @brief Конструктор класса WireCursor
+     * @param [in] store Векторы (должны жить, пока используется курсор)
+     * @param [in] first Индекс первого отправляемого вектора
+     */
+    WireCursor(const VectorStore& store, size_t first);
+    
+    /**
+     * @brief Возвращает индекс первого не полностью отправленного вектора
+     * @return Индекс вектора в хранилище
+     */
+    size_t position() const { return index; }
+    
+    /**
+     * @brief Заполняет описатели для отправки с текущей позиции
+     * @param [out] iov Массив описателей
+     * @param [in] maxIov Размер массива
+     * @param [in] limit Индекс, следующий за последним вектором, который можно отправить
+     * @return Количество заполненных описателей (0, если отправлять нечего)
+     */
+    size_t fill(struct iovec* iov, size_t maxIov, size_t limit) const;
+    
+    /**
+     * @brief Сдвигает позицию на отправленные байты
+     * @param [in] bytes Количество байтов, принятых сокетом
+     */
+    void advance(size_t bytes);
+};
+
+#endif // WIRECURSOR_H
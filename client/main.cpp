@@ -10,6 +10,7 @@
 
 #include "Client.h"
 #include "ErrorHandler.h"
+#include <csignal>
 
 /**
  * @brief Точка входа в программу
@@ -31,6 +32,10 @@ int main(int argc, char* argv[]) {
         return EXIT_SUCCESS;
     }
     
+    // Отправка в библиотеке не порождает SIGPIPE (MSG_NOSIGNAL, маска
+    // вокруг sendfile); игнорирование - страховка для прочих записей в сокет
+    signal(SIGPIPE, SIG_IGN);
+    
     // Создаем и запускаем клиент
     Client client;
     if (!client.run(argc, argv)) {